@@ -0,0 +1,97 @@
+#include "matrix/Matrix.h"
+
+#include <iostream>
+#include <chrono>
+#include <complex>
+#include <string>
+
+NS_USE_NAMESPACE;
+
+/*
+* Benchmark of the dense matrix matrix multiplication.
+* Compares the blocked DenseMatrix::mul against the naive triple loop.
+*/
+
+template<typename T>
+DenseMatrix<T> naive_mul(const DenseMatrix<T>& A, const DenseMatrix<T>& B)
+{
+	DenseMatrix<T> C(A.rows(), B.columns());
+	for (Index i = 0; i < A.rows(); ++i)
+	{
+		for (Index k = 0; k < B.columns(); ++k)
+		{
+			T v = 0;
+			for (Index j = 0; j < A.columns(); ++j)
+				v += A.at(i, j) * B.at(j, k);
+			C.set(i, k, v);
+		}
+	}
+	return C;
+}
+
+template<typename F>
+double measure(const F& func)
+{
+	const auto start = std::chrono::high_resolution_clock::now();
+	func();
+	const auto diff = std::chrono::high_resolution_clock::now() - start;
+	return std::chrono::duration_cast<std::chrono::duration<double> >(diff).count();
+}
+
+template<typename T>
+void benchmark(const std::string& name, Index N, size_t threads)
+{
+	DenseMatrix<T> A(N, N);
+	DenseMatrix<T> B(N, N);
+	for (Index i = 0; i < A.size(); ++i)
+	{
+		A.linear_set(i, (T)((i*7 % 13) / 13.0));
+		B.linear_set(i, (T)((i*5 % 11) / 11.0));
+	}
+
+	// Complex multiplications count as four real ones
+	const double flops = 2.0*N*N*N*(sizeof(T) > sizeof(double) ? 4 : 1);
+
+	DenseMatrix<T> C1;
+	DenseMatrix<T> C2;
+	DenseMatrix<T> C3;
+	const double t1 = measure([&](){ C1 = naive_mul(A, B); });
+	const double t2 = measure([&](){ C2 = A.mul(B, 1); });
+	const double t3 = measure([&](){ C3 = A.mul(B, threads); });
+
+	T maxDiff = 0;
+	for (Index i = 0; i < C1.size(); ++i)
+	{
+		if (std::abs(C1.linear_at(i) - C3.linear_at(i)) > std::abs(maxDiff))
+			maxDiff = C1.linear_at(i) - C3.linear_at(i);
+	}
+
+	std::cout << name << " N = " << N << std::endl;
+	std::cout << "  Naive:    " << t1 << " s (" << flops/t1*1e-9 << " GFlop/s)" << std::endl;
+	std::cout << "  Blocked:  " << t2 << " s (" << flops/t2*1e-9 << " GFlop/s)" << std::endl;
+	std::cout << "  Parallel: " << t3 << " s (" << flops/t3*1e-9 << " GFlop/s)" << std::endl;
+	std::cout << "  Max difference = " << std::abs(maxDiff) << std::endl;
+}
+
+int main(int argc, char** argv)
+{
+	Index N = 512;
+	size_t threads = 0;// All available threads
+	try
+	{
+		if (argc > 1)
+			N = std::stol(argv[1]);
+		if (argc > 2)
+			threads = std::stol(argv[2]);
+	}
+	catch(...)
+	{
+		std::cout << "Invalid arguments given. Use 'example_benchmark_gemm [N] [Threads]'" << std::endl;
+		return -1;
+	}
+
+	benchmark<float>("float", N, threads);
+	benchmark<double>("double", N, threads);
+	benchmark<std::complex<double> >("complex<double>", N, threads);
+	return 0;
+}
\ No newline at end of file
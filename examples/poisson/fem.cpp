@@ -2,12 +2,16 @@
 #include <string>
 #include <fstream>
 #include <chrono>
+#include <algorithm>
 
 #include "matrix/SparseMatrix.h"
 #include "matrix/MatrixOperations.h"
 #include "matrix/MatrixOrder.h"
 #include "Iterative.h"
 #include "CG.h"
+#include "Preconditioner.h"
+#include "SparseFactorization.h"
+#include "Multigrid.h"
 #include "LU.h"
 #include "Vector.h"
 #include "Simplex.h"
@@ -15,6 +19,7 @@
 
 #include "mesh/HyperCube.h"
 #include "mesh/Mesh.h"
+#include "mesh/MeshGeometry.h"
 #include "loader/MeshObjLoader.h"
 #include "loader/MeshTriangleLoader.h"
 
@@ -73,13 +78,19 @@ const auto boundary_function = [](const FixedVector<Number,2>& v) -> Number {
 };
 
 template<int Order>
-void handleMesh(Mesh<Number, 2>& mesh, int M, int Solver)
+DynamicVector<Number> handleMesh(Mesh<Number, 2>& mesh, int M, int Solver, int32 N)
 {
 	typedef PolyShapeFunction<Number,2,Order> SF;
 	typedef GaussLegendreQuadrature<Number,2,Order+1> Q;
 
 	SF::prepareMesh(mesh);
 
+	// Renumber for locality. RCM is used instead of a space filling curve,
+	// as the incomplete factorizations converge slower with the latter.
+	// The geometric multigrid relies on the numbering of the grid generator.
+	if(Solver != 7)
+		mesh.renumber(MR_ReverseCuthillMcKee);
+
 	const size_t VertexSize = mesh.vertices().size();
 	std::cout << "  Order = " << Order << std::endl;
 	std::cout << "  DOFs = " << VertexSize << std::endl;
@@ -101,22 +112,45 @@ void handleMesh(Mesh<Number, 2>& mesh, int M, int Solver)
 	SF sf;
 	Q quadrature;
 
+	const MeshGeometry<Number,2> geometry(mesh);
+
+	// Reused for every element
+	std::vector<Number> quadratureBuffer;
+	std::vector<Number> source(quadrature.pointCount());
+
 	// Cell based assembling
 	/*
 	 * Potential optimization would be to calculate the shape function gradient value once
 	 * for the reference simplex and multiply it only with the element dependent inverse jacobian.
 	 */
-	for(MeshElement<Number,2>* element : mesh.elements())
+	for(Index e = 0; e < mesh.elements().size(); ++e)
 	{
-		const Number det = std::abs(element->Element.determinant());
+		MeshElement<Number,2>* element = mesh.element(e);
+		const Number det = geometry.determinant(e);
 		
 		FixedMatrix<Number,SF::DOF,SF::DOF> elemMat;
 		FixedVector<Number,SF::DOF> elemVec;
 
-		const auto invJacob = element->Element.inverseMatrix();
+#ifdef VERBOSE_LOG
+		std::cout << geometry.inverseJacobian(e) << std::endl;
+#endif
+
+		// All quadrature points of the element are mapped and the source function is evaluated once
+		quadrature.eval_batch(
+			[&](const QuadratureBatch<Number,2>& batch, Number* values)
+			{
+				for(Index p = 0; p < batch.Size; ++p)
+				{
+					const FixedVector<Number,2> global = {batch.Global[0][p], batch.Global[1][p]};
+#ifdef VERBOSE_LOG
+					std::cout << global << "; ";
+#endif
+					source[p % batch.PointsPerElement] = values[p] = source_function(global);
+				}
+			}, element->Element, quadratureBuffer);
 
 #ifdef VERBOSE_LOG
-		std::cout << invJacob << std::endl;
+		std::cout << std::endl;
 #endif
 
 		for(Index i = 0; i < SF::DOF; ++i)
@@ -126,26 +160,20 @@ void handleMesh(Mesh<Number, 2>& mesh, int M, int Solver)
 				const Number val = det * quadrature.eval(
 					[&](const FixedVector<Number,2>& local) -> Number
 					{
-						return (invJacob.mul(sf.gradient(i,local))).
-							dot(invJacob.mul(sf.gradient(j,local)));
+						return geometry.mulInverseJacobian(e, sf.gradient(i,local)).
+							dot(geometry.mulInverseJacobian(e, sf.gradient(j,local)));
 					});
 
 				if(std::abs(val) > EPS)
 					elemMat.set(i,j, val);
 			}
 
-			const Number f = det * quadrature.eval(
-				[&](const FixedVector<Number,2>& local) -> Number
+			const Number f = det * quadrature.eval_index(
+				[&](Index q, const FixedVector<Number,2>& local) -> Number
 				{
-#ifdef VERBOSE_LOG
-					std::cout << local << " " << element->Element.toGlobal(local) << "; ";
-#endif
-					return sf.value(i, local) * source_function(element->Element.toGlobal(local));
+					return sf.value(i, local) * source[q];
 				});
-			
-#ifdef VERBOSE_LOG
-			std::cout << std::endl;
-#endif
+
 			if(std::abs(f) > EPS)
 				elemVec.set(i, f);
 		}
@@ -179,25 +207,19 @@ void handleMesh(Mesh<Number, 2>& mesh, int M, int Solver)
 #endif
 
 	// Setup boundary constraints
+	std::vector<Index> boundaryRows;
+	std::vector<Number> boundaryValues;
 	for(MeshVertex<Number,2>* vertex : mesh.vertices())
 	{
 		if(!(vertex->Flags & MVF_StrongBoundary))
 			continue;
 
-		const Number g = boundary_function(vertex->Vertex);
-
-		for(Index i = 0; i < VertexSize; ++i)
-		{
-			B.set(i, B.at(i) - A.at(i, vertex->GlobalIndex)*g);
-
-			A.set(vertex->GlobalIndex, i, 0);
-			A.set(i, vertex->GlobalIndex, 0);
-		}
-
-		A.set(vertex->GlobalIndex, vertex->GlobalIndex, avgMid);
-		B.set(vertex->GlobalIndex, avgMid*g);
+		boundaryRows.push_back(vertex->GlobalIndex);
+		boundaryValues.push_back(boundary_function(vertex->Vertex));
 	}
 
+	Operations::apply_dirichlet(A, B, boundaryRows, boundaryValues, avgMid);
+
 	std::cout << "  Entries: " << A.filled_count() 
 				<< " (Sparse Efficiency: " << 100*(1-A.filled_count()/(float)A.size()) << "%)" << std::endl;
 
@@ -211,21 +233,14 @@ void handleMesh(Mesh<Number, 2>& mesh, int M, int Solver)
 
 	const auto p2_start = std::chrono::high_resolution_clock::now();
 
-	SparseMatrix<Number> C(A.rows(), A.columns());
-	if(Solver == 2)
-	{
-		std::cout << "  Calculating preconditioner..." << std::endl;
-		std::cout << "    [JACOBI]..." << std::endl;
-		CG::serial::jacobi(A,C);
-	}
-
-	std::cout << "  Solving..." << std::endl;
 	if(std::abs(ShiftFactor) > 0)
 	{
 		for(Index i = 0; i < A.rows(); ++i)
 			A.set(i,i,A.at(i,i)+ShiftFactor);
 	}
 
+	std::cout << "  Solving..." << std::endl;
+
 	std::cout << "  cond(A)=" << Operations::cond(A) << std::endl;
 
 	size_t iterations = 0;
@@ -241,7 +256,54 @@ void handleMesh(Mesh<Number, 2>& mesh, int M, int Solver)
 		break;
 	default:
 	case 2:
+	{
+		std::cout << "  Calculating preconditioner..." << std::endl;
+		std::cout << "    [JACOBI]..." << std::endl;
+		JacobiPreconditioner<Number> C(A);
+		X = CG::serial::pcg(A, B, C, X, 1024, 1e-4, &iterations);
+	}
+		break;
+	case 3:
+	{
+		std::cout << "  Calculating preconditioner..." << std::endl;
+		std::cout << "    [IC0]..." << std::endl;
+		IC0Preconditioner<Number> C(A);
+		X = CG::serial::pcg(A, B, C, X, 1024, 1e-4, &iterations);
+	}
+		break;
+	case 5:
+	{
+		std::cout << "  Calculating preconditioner..." << std::endl;
+		std::cout << "    [AINV]..." << std::endl;
+		AINVPreconditioner<Number> C(A, 0.1, true);
+		X = CG::serial::pcg(A, B, C, X, 1024, 1e-4, &iterations);
+	}
+		break;
+	case 6:
+	{
+		std::cout << "  Calculating preconditioner..." << std::endl;
+		std::cout << "    [AMG]..." << std::endl;
+		AlgebraicMultigrid<Number> C(A);
+		std::cout << "    Levels: " << C.levels() << std::endl;
 		X = CG::serial::pcg(A, B, C, X, 1024, 1e-4, &iterations);
+	}
+		break;
+	case 7:
+	{
+		std::cout << "  Building hierarchy..." << std::endl;
+		std::cout << "    [GMG]..." << std::endl;
+		GeometricMultigrid<Number> C(A, Vector2D<Dimension>{(Dimension)N,(Dimension)N});
+		std::cout << "    Levels: " << C.levels() << std::endl;
+		X = C.solve(B, X, 1024, 1e-8, &iterations);
+	}
+		break;
+	case 4:
+	{
+		std::cout << "  Factorizing..." << std::endl;
+		SparseCholesky<Number> chol(A);
+		std::cout << "    Entries: " << chol.filled_count() << std::endl;
+		X = chol.solve(B);
+	}
 		break;
 	}
 
@@ -270,12 +332,11 @@ void handleMesh(Mesh<Number, 2>& mesh, int M, int Solver)
 	}
 
 	DynamicVector<Number> PostError(mesh.elements().size());
-	Index k = 0;
-	for(MeshElement<Number,2>* elem : mesh.elements())
+	for(Index k = 0; k < mesh.elements().size(); ++k)
 	{
-		const auto invJacob = elem->Element.inverseMatrix();
-		const Number det = std::abs(elem->Element.determinant());
-		const Number H = elem->Element.diameter();
+		MeshElement<Number,2>* elem = mesh.element(k);
+		const Number det = geometry.determinant(k);
+		const Number H = geometry.diameter(k);
 
 		Number cellError = 0;
 		if(Order == 2)
@@ -287,7 +348,7 @@ void handleMesh(Mesh<Number, 2>& mesh, int M, int Solver)
 			cellError = det * quadrature.eval_index(
 			[&](Index i, const FixedVector<Number,2>& local) -> Number
 			{
-				return (invJacob.mul(sf.gradient2(i,local,nodeValues))).sum() + source_function(elem->Element.toGlobal(local));
+				return geometry.mulInverseJacobian(k, sf.gradient2(i,local,nodeValues)).sum() + source_function(elem->Element.toGlobal(local));
 			});
 		}
 		
@@ -308,7 +369,6 @@ void handleMesh(Mesh<Number, 2>& mesh, int M, int Solver)
 		const Number nk = H*H*cellError + 0.5*faceError;
 
 		PostError.set(k, PostErrorFactor * nk);
-		k++;
 	}
 
 	if(M == 0)
@@ -386,6 +446,32 @@ void handleMesh(Mesh<Number, 2>& mesh, int M, int Solver)
 		VOO_VertexBoundaryLabel |
 		VOO_VertexImplicitLabel |
 		(Order == 2 ? VOO_IsQuadratic : 0));
+
+	return PostError;
+}
+
+/**
+ * Mark the elements with the largest estimated error, until they make up
+ * the given fraction of the total error (Doerfler marking)
+ */
+std::vector<bool> markElements(const DynamicVector<Number>& error, Number fraction)
+{
+	std::vector<Index> order(error.size());
+	for(Index i = 0; i < order.size(); ++i)
+		order[i] = i;
+
+	std::sort(order.begin(), order.end(), [&](Index a, Index b) { return error.at(a) > error.at(b); });
+
+	std::vector<bool> marked(error.size(), false);
+	const Number total = error.sum();
+	Number sum = 0;
+	for(Index i = 0; i < order.size() && sum < fraction*total; ++i)
+	{
+		marked[order[i]] = true;
+		sum += error.at(order[i]);
+	}
+
+	return marked;
 }
 
 /**
@@ -395,13 +481,14 @@ int main(int argc, char** argv)
 {
 	if(argc < 4)
 	{
-		std::cout << "Not enough arguments given! Use 'example_poisson_fem S O M <DEPENDS ON M>'" << std::endl;
+		std::cout << "Not enough arguments given! Use 'example_poisson_fem S O M <DEPENDS ON M> [R]'" << std::endl;
 		return -1;
 	}
 
 	int Solver = 2;
 	int Order = 1;// Order (1 or 2)
 	int32 M = 0;// M == 0 -> Generic mesh; Everything else are precomputed meshes
+	int32 R = 0;// Adaptive refinement steps
 	try
 	{
 		Solver = std::stol(argv[1]);
@@ -414,9 +501,9 @@ int main(int argc, char** argv)
 		return -2;
 	}
 
-	if(Solver < 0 || Solver > 2)
+	if(Solver < 0 || Solver > 7)
 	{
-		std::cout << "Invalid S given. Should be zero for SOR solver, one for CG solver and two for PCG solver with ILU0 preconditioner." << std::endl;
+		std::cout << "Invalid S given. Should be zero for SOR solver, one for CG solver, two for PCG solver with Jacobi preconditioner, three for PCG solver with IC0 preconditioner, four for sparse cholesky solver, five for PCG solver with AINV preconditioner, six for PCG solver with AMG preconditioner and seven for geometric multigrid solver." << std::endl;
 		return -4;
 	}
 
@@ -432,20 +519,52 @@ int main(int argc, char** argv)
 		return -4;
 	}
 
+	const int MeshArgs = M == 2 ? 6 : 5;
+	if(argc == MeshArgs + 1)
+	{
+		try
+		{
+			R = std::stol(argv[MeshArgs]);
+		}
+		catch(...)
+		{
+			R = -1;
+		}
+
+		if(R < 0)
+		{
+			std::cout << "Invalid R given. Should be the number of adaptive refinement steps." << std::endl;
+			return -4;
+		}
+	}
+
+	if(R > 0 && (Order != 1 || Solver == 7))
+	{
+		std::cout << "Adaptive refinement is only available with first order shape functions and not with the geometric multigrid solver." << std::endl;
+		return -4;
+	}
+
+	if(Solver == 7 && (M != 0 || Order != 1))
+	{
+		std::cout << "Geometric multigrid solver is only available for the generic grid mesh with first order shape functions." << std::endl;
+		return -4;
+	}
+
 	// --------------------------------
 	// Calculating basic constants
 	Mesh<Number,2> mesh;
+	int32 N = 0;// Elements per direction of the generic mesh
 	
 	const auto p0_start = std::chrono::high_resolution_clock::now();
 	if(M == 0)
 	{
-		if(argc != 5)
+		if(argc < 5)
 		{
 			std::cout << "Need additional N!" << std::endl;
 			return -3;
 		}
 
-		int32 N = std::stol(argv[4]);
+		N = std::stol(argv[4]);
 		if(N < 1)
 		{
 			std::cout << "Invalid N given. Should be greater than 1" << std::endl;
@@ -461,7 +580,7 @@ int main(int argc, char** argv)
 	}
 	else if(M == 1)
 	{
-		if(argc != 5)
+		if(argc < 5)
 		{
 			std::cout << "Need additional filename!" << std::endl;
 			return -3;
@@ -472,7 +591,7 @@ int main(int argc, char** argv)
 	}
 	else if(M == 2)
 	{
-		if(argc != 6)
+		if(argc < 6)
 		{
 			std::cout << "Need additional paths to .node and .ele files! (First .node, than .ele)" << std::endl;
 			return -3;
@@ -502,9 +621,30 @@ int main(int argc, char** argv)
 	}
 
 	if(Order == 2)
-		handleMesh<2>(mesh, M, Solver);
+	{
+		handleMesh<2>(mesh, M, Solver, N);
+	}
 	else
-		handleMesh<1>(mesh, M, Solver);
+	{
+		for(int32 step = 0; ; ++step)
+		{
+			const DynamicVector<Number> PostError = handleMesh<1>(mesh, M, Solver, N);
+			if(step == R)
+				break;
+
+			std::cout << "Refining mesh (Step " << (step+1) << "/" << R << ")..." << std::endl;
+			const std::vector<bool> marked = markElements(PostError, 0.5);
+
+			// Refinement works only on the plain mesh
+			for(auto e : mesh.elements())
+				e->DOFVertices.clear();
+			for(auto e : mesh.edges())
+				e->DOFVertices.clear();
+
+			mesh.refine(marked);
+			mesh.prepare();
+		}
+	}
 
 	std::cout << "Finished!" << std::endl;
 	return 0;
@@ -2,6 +2,7 @@
 
 #include "Types.h"
 #include "Exceptions.h"
+#include "Preconditioner.h"
 
 #include "matrix/MatrixCheck.h"
 
@@ -15,12 +16,39 @@ namespace CG
 		V1 cg(const M& a, const V2& b, const V1& x0,
 				size_t maxIter = 1024, double eps = 10e-6, size_t* it_stat = nullptr);
 
+		/**
+		 * @brief Preconditioned conjugate gradient method.
+		 * The preconditioner c has to provide apply(r, z) with z = C^-1 r,
+		 * see Preconditioner.h
+		 */
+		template<class M, class V1, class V2, class P>
+		V1 pcg(const M& a, const V2& b, const P& c, const V1& x0,
+				size_t maxIter = 1024, double eps = 10e-6, size_t* it_stat = nullptr);
+
+		/**
+		 * @brief Preconditioned conjugate gradient method with an explicit preconditioner matrix c ~ a^-1.
+		 */
 		template<class M, class V1, class V2>
 		V1 pcg(const M& a, const V2& b, const M& c, const V1& x0,
 				size_t maxIter = 1024, double eps = 10e-6, size_t* it_stat = nullptr);
 
 		/**
-		 * @brief Jacobi preconditioner
+		 * @brief Mixed precision iterative refinement with pcg as inner solver.
+		 * The residual r = b - a x is calculated in the precision of V1 and V2 with a.
+		 * The correction is solved with pcg in the lower precision of aLow and the preconditioner c,
+		 * which only have to approximate a, e.g. a float copy from Convert::toPrecision.
+		 * Every inner solve reduces the residual by innerEps, eps is the absolute tolerance of the final residual.
+		 * it_stat returns the amount of refinement steps.
+		 * @throw MatrixSizeMismatchException
+		 */
+		template<class M, class ML, class V1, class V2, class P>
+		V1 pcg_refinement(const M& a, const ML& aLow, const V2& b, const P& c, const V1& x0,
+				size_t maxIter = 32, double eps = 10e-6, double innerEps = 10e-4, size_t innerMaxIter = 1024,
+				size_t* it_stat = nullptr);
+
+		/**
+		 * @brief Jacobi preconditioner as explicit matrix.
+		 * JacobiPreconditioner only stores the diagonal and should be preferred.
 		 */
 		template<class M>
 		void jacobi(const M& A, M& C);
@@ -32,7 +32,7 @@ namespace CG {
 			for (; k < maxIter; ++k)
 			{
 				const auto t = a.mul(p);
-				const typename M::value_type ak = rs / (t.dot(p));
+				const typename V2::value_type ak = rs / (t.dot(p));
 				x += ak*p;
 				l = r - ak*t;
 
@@ -53,19 +53,13 @@ namespace CG {
 			return x;
 		}
 
-		template<class M, class V1, class V2>
-		V1 pcg(const M& a, const V2& b, const M& c, const V1& x0,
+		template<class M, class V1, class V2, class P>
+		V1 pcg(const M& a, const V2& b, const P& c, const V1& x0,
 				size_t maxIter, double eps, size_t* it_stat)
 		{
 			if (a.rows() != a.columns())
 				throw NotSquareException();
 
-			if (c.rows() != c.columns())
-				throw NotSquareException();
-
-			if (a.rows() != c.rows())
-				throw MatrixSizeMismatchException();
-
 #ifdef NS_ALLOW_CHECKS
 			if (!Check::matrixIsHermitian(a))
 				throw NotHermitianException();
@@ -75,7 +69,8 @@ namespace CG {
 
 			V1 x = x0;
 			V2 r = b - a.mul(x0);
-			V2 z = c.mul(r);
+			V2 z;
+			c.apply(r, z);
 			V2 p = z;
 
 			auto l1 = r.dot(z);
@@ -84,14 +79,14 @@ namespace CG {
 			for (; k < maxIter; ++k)
 			{
 				const auto t = a.mul(p);
-				const typename M::value_type ak = l1 / (t.dot(p));
+				const typename V2::value_type ak = l1 / (t.dot(p));
 				x += ak*p;
 				r -= ak*t;
 
 				if (r.magSqr() < eps2 || k == maxIter-1)
 					break;
 
-				z = c.mul(r);
+				c.apply(r, z);
 				l2 = r.dot(z);
 				p = z + (l2/l1)*p;
 				l1 = l2;
@@ -103,6 +98,61 @@ namespace CG {
 			return x;
 		}
 
+		template<class M, class V1, class V2>
+		V1 pcg(const M& a, const V2& b, const M& c, const V1& x0,
+				size_t maxIter, double eps, size_t* it_stat)
+		{
+			if (a.rows() != c.rows())
+				throw MatrixSizeMismatchException();
+
+			return pcg(a, b, MatrixPreconditioner<M>(c), x0, maxIter, eps, it_stat);
+		}
+
+		template<class M, class ML, class V1, class V2, class P>
+		V1 pcg_refinement(const M& a, const ML& aLow, const V2& b, const P& c, const V1& x0,
+				size_t maxIter, double eps, double innerEps, size_t innerMaxIter,
+				size_t* it_stat)
+		{
+			typedef typename ML::value_type L;
+			typedef typename V1::value_type T;
+
+			if (a.rows() != a.columns())
+				throw NotSquareException();
+
+			if (a.rows() != aLow.rows() || a.columns() != aLow.columns())
+				throw MatrixSizeMismatchException();
+
+			const Index n = a.rows();
+
+			V1 x = x0;
+			DynamicVector<L> rl;
+			DynamicVector<L> zero;
+			rl.resize(n);
+			zero.resize(n);
+
+			size_t k = 0;
+			for (; k < maxIter; ++k)
+			{
+				const V2 r = b - a.mul(x);
+				const double norm = std::sqrt(std::abs(r.magSqr()));
+				if (norm < eps)
+					break;
+
+				// Solving for the normalized residual keeps the values in range of the lower precision
+				for (Index i = 0; i < n; ++i)
+					rl[i] = (L)(r[i] / norm);
+
+				const auto dl = pcg(aLow, rl, c, zero, innerMaxIter, innerEps);
+				for (Index i = 0; i < n; ++i)
+					x[i] += (T)norm * (T)dl[i];
+			}
+
+			if (it_stat)
+				*it_stat = k;
+
+			return x;
+		}
+
 		template<class M>
 		void jacobi(const M& A, M& C)
 		{
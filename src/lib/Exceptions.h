@@ -53,6 +53,8 @@ NS_DECLARE_EXCEPTION(VectorSizeMismatch, Dimension, "Size of vectors do not matc
 NS_DECLARE_EXCEPTION(MatrixSizeMismatch, Dimension, "Size of matrix do not match.");
 NS_DECLARE_EXCEPTION(MatrixVectorMismatch, Math, "Matrix and vectors do not match in dimensions.");
 NS_DECLARE_EXCEPTION(MatrixMulMismatch, Dimension, "Dimensional requirement for multiplication not fulfilled.");
+NS_DECLARE_EXCEPTION(IndexOverflow, Dimension, "Index type of the matrix is too small for its dimension or entries.");
+NS_DECLARE_EXCEPTION(PatternMismatch, Dimension, "Sparsity pattern of the matrix does not match the analyzed pattern.");
 
 NS_DECLARE_EXCEPTION_GROUP(Mesh, NS);
 NS_DECLARE_EXCEPTION(InvalidVertexIndex, Mesh, "Vertex has an invalid global index.");
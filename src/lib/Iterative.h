@@ -4,6 +4,8 @@
 #include "Utils.h"
 #include "Exceptions.h"
 
+#include "matrix/SparseMatrix.h"
+
 NS_BEGIN_NAMESPACE
 
 namespace Iterative
@@ -18,6 +20,23 @@ namespace Iterative
 		template<class M, class V>
 		V sor(const M& a, const V& b, const V& x0,
 				double weight = 1, size_t maxIter = 1024, double eps = 10e-6, size_t* it_stat = nullptr);
+
+		/**
+		 * @brief Applies a fixed amount of weighted jacobi sweeps to x in-place.
+		 * Convergence is not checked, which makes it useful as smoother.
+		 * @throw MatrixHasZeroInDiagException
+		 */
+		template<typename T, class V>
+		void jacobi_sweep(const SparseMatrix<T>& a, const V& b, V& x, double weight = 1, size_t sweeps = 1);
+
+		/**
+		 * @brief Applies a fixed amount of SOR sweeps to x in-place.
+		 * If backward is true, the rows are processed in reverse order.
+		 * A forward sweep followed by a backward sweep is a symmetric SOR step.
+		 * @throw MatrixHasZeroInDiagException
+		 */
+		template<typename T, class V>
+		void sor_sweep(const SparseMatrix<T>& a, const V& b, V& x, double weight = 1, size_t sweeps = 1, bool backward = false);
 	}
 }
 
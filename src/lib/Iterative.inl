@@ -127,6 +127,83 @@ namespace Iterative
 
 			return x;
 		}
+
+		template<typename T, class V>
+		void jacobi_sweep(const SparseMatrix<T>& a, const V& b, V& x, double weight, size_t sweeps)
+		{
+			if (a.rows() != a.columns())
+				throw NotSquareException();
+			if (a.rows() != b.size() || a.rows() != x.size())
+				throw MatrixVectorMismatchException();
+
+			const auto* rowPtr = a.row_ptr();
+			const auto* colPtr = a.column_ptr();
+			const T* values = a.value_ptr();
+			const T w = (T)weight;
+
+			V xo = x;
+			for (size_t it = 0; it < sweeps; ++it)
+			{
+				for (Index i = 0; i < a.rows(); ++i)
+				{
+					T mid = (T)0;
+					T t = b[i];
+					for (Index k = rowPtr[i]; k < rowPtr[i+1]; ++k)
+					{
+						if (colPtr[k] != i)
+							t -= values[k] * xo[colPtr[k]];
+						else
+							mid = values[k];
+					}
+
+					if (mid == (T)0)
+						throw MatrixHasZeroInDiagException();
+
+					x[i] = xo[i] + w * (t / mid - xo[i]);
+				}
+
+				if (it + 1 < sweeps)
+					xo = x;
+			}
+		}
+
+		template<typename T, class V>
+		void sor_sweep(const SparseMatrix<T>& a, const V& b, V& x, double weight, size_t sweeps, bool backward)
+		{
+			if (a.rows() != a.columns())
+				throw NotSquareException();
+			if (a.rows() != b.size() || a.rows() != x.size())
+				throw MatrixVectorMismatchException();
+
+			const Index n = a.rows();
+			const auto* rowPtr = a.row_ptr();
+			const auto* colPtr = a.column_ptr();
+			const T* values = a.value_ptr();
+			const T w = (T)weight;
+
+			for (size_t it = 0; it < sweeps; ++it)
+			{
+				for (Index r = 0; r < n; ++r)
+				{
+					const Index i = backward ? n - 1 - r : r;
+
+					T mid = (T)0;
+					T t = b[i];
+					for (Index k = rowPtr[i]; k < rowPtr[i+1]; ++k)
+					{
+						if (colPtr[k] != i)
+							t -= values[k] * x[colPtr[k]];
+						else
+							mid = values[k];
+					}
+
+					if (mid == (T)0)
+						throw MatrixHasZeroInDiagException();
+
+					x[i] += w * (t / mid - x[i]);
+				}
+			}
+		}
 	}
 }
 
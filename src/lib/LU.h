@@ -2,8 +2,16 @@
 
 #include "Types.h"
 #include "Exceptions.h"
+#include "SparseFactorization.h"
+#include "Parallel.h"
 
 #include "matrix/MatrixCheck.h"
+#include "matrix/MatrixKernel.h"
+
+#include <algorithm>
+#include <atomic>
+#include <queue>
+#include <vector>
 
 NS_BEGIN_NAMESPACE
 
@@ -11,30 +19,180 @@ namespace LU
 {
 	namespace serial
 	{
-		// Cholesky
+		// Cholesky with A = L L^*, L has to be zero initially
 		template<class M>
 		void cholesky(const M& m, M& L);
 
+		/**
+		 * @brief Blocked variant for dense matrices with A = L L^*.
+		 * The panels of the lower triangle are factorized column wise and the trailing matrix
+		 * is updated with Kernel::gemm().
+		 * @throw NotPositiveDefiniteException
+		 */
+		template<typename T>
+		void cholesky(const DenseMatrix<T>& m, DenseMatrix<T>& L);
+
 		// Doolittle
 		template<typename T, class DC>
 		void doolittle(const BaseMatrix<T,DC>& m, BaseMatrix<T,DC>& L, BaseMatrix<T,DC>& U, BaseMatrix<T,DC>& P, size_t* pivotCount=nullptr);
+		/**
+		 * @brief Blocked variant for dense matrices with the same partial pivoting.
+		 * The panels are factorized column wise and the trailing matrix is updated with Kernel::gemm().
+		 * @throw SingularException
+		 */
+		template<typename T>
+		void doolittle(const DenseMatrix<T>& m, DenseMatrix<T>& L, DenseMatrix<T>& U, DenseMatrix<T>& P, size_t* pivotCount=nullptr);
+		/**
+		 * @brief Sparse variant based on SparseLU with natural ordering.
+		 * Use SparseLU or SparseCholesky directly to solve multiple systems with the same matrix.
+		 */
 		template<typename T>
 		void doolittle(const SparseMatrix<T>& m, SparseMatrix<T>& L, SparseMatrix<T>& U, SparseMatrix<T>& P, size_t* pivotCount=nullptr);
 
 		template<typename T>
 		void ilu0(const SparseMatrix<T>& A, SparseMatrix<T>& L, SparseMatrix<T>& U);
 
+		/**
+		 * @brief Incomplete LU factorization with level of fill.
+		 * An entry created by eliminating with an entry of level l1 and one of level l2 has the level l1+l2+1,
+		 * entries of A have level 0. Only entries up to the given level are kept, so level 0 is the same as ilu0().
+		 * The result is stored combined in LU. The strict lower triangle contains L with an implicit unit diagonal,
+		 * the upper triangle including the diagonal contains U.
+		 * @throw SingularException
+		 */
+		template<typename T>
+		void iluk(const SparseMatrix<T>& A, SparseMatrix<T>& LU, Index level);
+
+		/**
+		 * @brief Threshold incomplete LU factorization ILUT.
+		 * Entries smaller than tolerance times the norm of the corresponding row of A are dropped.
+		 * Afterwards only the maxFill largest entries of L and of U are kept in every row, besides the diagonal.
+		 * The result is stored combined in LU like in iluk().
+		 * @throw SingularException
+		 */
+		template<typename T>
+		void ilut(const SparseMatrix<T>& A, SparseMatrix<T>& LU, double tolerance, size_t maxFill);
+
 		template<class M, class V>
 		V solve_lu(const M& L, const M& U, const V& b);
 
+		/**
+		 * @brief Incomplete Cholesky factorization IC(0) with A ~ L L^*.
+		 * Works directly on the CRS arrays of A. Only the lower triangle of A is used
+		 * and L gets exactly its sparsity pattern.
+		 * @throw NotPositiveDefiniteException
+		 */
+		template<typename T>
+		void ic0(const SparseMatrix<T>& A, SparseMatrix<T>& L);
+
+		/**
+		 * @brief In-place triangular solves on the CRS arrays.
+		 * solve_lower() solves L x = b and solve_upper() solves U x = b, with x containing b at input.
+		 * Entries of the other triangle are ignored, which allows L and U to be stored in the same matrix.
+		 * If unitDiagonal is true, the diagonal of L is assumed to be 1 and not accessed.
+		 */
+		template<typename T, class V>
+		void solve_lower(const SparseMatrix<T>& L, V& x, bool unitDiagonal = false);
+		template<typename T, class V>
+		void solve_upper(const SparseMatrix<T>& U, V& x);
+
+		/**
+		 * @brief In-place solve of L^* x = b with the rows of the lower triangular matrix L.
+		 */
+		template<typename T, class V>
+		void solve_lower_adjugate(const SparseMatrix<T>& L, V& x);
+
+		/**
+		 * @brief In-place solve of L L^* x = b with L from ic0().
+		 */
+		template<typename T, class V>
+		void solve_ic(const SparseMatrix<T>& L, V& x);
+
 		/**
 		 * @brief Approximated inverse of L and U.
 		 * This algorithm is based on the L x_i = e_i and U y_i = e_i approach with
 		 * M = L^-1 U^-1
 		 * It is useful to be used as a preconditioner.
+		 * The inverses are calculated completely, use ainv() for large matrices.
 		 */
 		template<class M>
 		void ainv_lu(const M& L, const M& U, M& invL, M& invU);
+
+		/**
+		 * @brief Factorized sparse approximate inverse A^-1 ~ Z D^-1 W^T by biconjugation (AINV).
+		 * Z and W are unit upper triangular with W^T A Z ~ D.
+		 * Entries of Z and W with an absolute value below tolerance are dropped.
+		 * @throw NotSquareException
+		 * @throw SingularException on breakdown
+		 */
+		template<typename T>
+		void ainv(const SparseMatrix<T>& A, SparseMatrix<T>& Z, SparseMatrix<T>& W, DynamicVector<T>& D, double tolerance);
+
+		/**
+		 * @brief Variant of ainv() for hermitian matrices with A^-1 ~ Z D^-1 Z^*.
+		 * Only half of the work of ainv() is needed.
+		 */
+		template<typename T>
+		void ainv_hermitian(const SparseMatrix<T>& A, SparseMatrix<T>& Z, DynamicVector<T>& D, double tolerance);
+	}
+
+	/**
+	 * @brief Level schedule of a triangular matrix.
+	 * Rows of the same level only depend on rows of previous levels and can be solved concurrently.
+	 * The rows of level l are Rows[LevelPtr[l], LevelPtr[l+1]).
+	 */
+	struct LevelSchedule
+	{
+		std::vector<Index> LevelPtr;
+		std::vector<Index> Rows;
+
+		Index levels() const;
+	};
+
+	namespace parallel
+	{
+		/**
+		 * @brief Same as serial::cholesky() and serial::doolittle() for dense matrices,
+		 * but the trailing matrix updates are distributed over multiple threads.
+		 * @param threads Amount of threads to use. 0 uses Parallel::thread_count().
+		 */
+		template<typename T>
+		void cholesky(const DenseMatrix<T>& m, DenseMatrix<T>& L, size_t threads = 0);
+		template<typename T>
+		void doolittle(const DenseMatrix<T>& m, DenseMatrix<T>& L, DenseMatrix<T>& U, DenseMatrix<T>& P,
+			size_t* pivotCount=nullptr, size_t threads = 0);
+
+		/**
+		 * @brief Level schedule of the strict lower or strict upper triangle of a CRS matrix.
+		 * Only depends on the pattern, so it has to be calculated once per factorization.
+		 */
+		template<typename T>
+		LevelSchedule level_schedule_lower(const SparseMatrix<T>& L);
+		template<typename T>
+		LevelSchedule level_schedule_upper(const SparseMatrix<T>& U);
+
+		/**
+		 * @brief Same as serial::solve_lower() and serial::solve_upper(), but the rows of every level are solved in parallel.
+		 * Falls back to the serial variant if the matrix has less than Parallel::SerialThreshold filled entries
+		 * or if the levels contain on average less rows than threads.
+		 * The threads are started and joined in every call.
+		 * @param threads Amount of threads to use. 0 uses Parallel::thread_count().
+		 */
+		template<typename T, class V>
+		void solve_lower(const SparseMatrix<T>& L, const LevelSchedule& levels, V& x,
+			bool unitDiagonal = false, size_t threads = 0);
+		template<typename T, class V>
+		void solve_upper(const SparseMatrix<T>& U, const LevelSchedule& levels, V& x, size_t threads = 0);
+
+		/**
+		 * @brief solve_lower() followed by solve_upper() with the same threads.
+		 * @details The threads are started and joined once for both substitutions instead of once for each.
+		 * Falls back to the serial variants under the same conditions as solve_lower() and solve_upper().
+		 */
+		template<typename T, class V>
+		void solve_lower_upper(const SparseMatrix<T>& L, const LevelSchedule& lowerLevels,
+			const SparseMatrix<T>& U, const LevelSchedule& upperLevels, V& x,
+			bool unitDiagonal = false, size_t threads = 0);
 	}
 }
 
@@ -4,6 +4,226 @@
 
 NS_BEGIN_NAMESPACE
 namespace LU {
+	// Panel width of the blocked dense factorizations
+	constexpr Index DenseBlockSize = 64;
+
+	// Right looking LU with partial pivoting on the row major n x n array W.
+	// Pivot rows are chosen like in the unblocked serial::doolittle().
+	template<typename T>
+	void doolittle_blocked(T* W, Index n, Index* rowTable, size_t& pivotCount, size_t threads)
+	{
+		for(Index k0 = 0; k0 < n; k0 += DenseBlockSize)
+		{
+			const Index end = std::min(k0 + DenseBlockSize, n);
+
+			// Factorize the panel, but swap the full rows
+			for(Index k = k0; k < end && k < n-1; ++k)
+			{
+				Index i = k;
+				auto m = std::abs(W[k*n + k]);
+				for(Index j = k+1; j < n; ++j)
+				{
+					const auto v = std::abs(W[j*n + k]);
+					if(v >= m)
+					{
+						m = v;
+						i = j;
+					}
+				}
+
+				if(i != k)
+				{
+					pivotCount++;
+					std::swap_ranges(W + k*n, W + (k+1)*n, W + i*n);
+					std::swap(rowTable[i], rowTable[k]);
+				}
+
+				if(std::abs(W[k*n + k]) <=
+					std::numeric_limits<typename get_complex_internal<T>::type>::epsilon())
+					throw SingularException();
+
+				const T invMid = (T)1/W[k*n + k];
+				const T* pivotRow = W + k*n;
+				for(Index j = k+1; j < n; ++j)
+				{
+					T* row = W + j*n;
+					row[k] *= invMid;
+					for(Index t = k+1; t < end; ++t)
+						row[t] -= row[k]*pivotRow[t];
+				}
+			}
+
+			if(end == n)
+				break;
+
+			// U12 = L11^-1 A12
+			for(Index i = k0+1; i < end; ++i)
+			{
+				T* row = W + i*n;
+				for(Index k = k0; k < i; ++k)
+				{
+					const T* pivotRow = W + k*n;
+					for(Index t = end; t < n; ++t)
+						row[t] -= row[k]*pivotRow[t];
+				}
+			}
+
+			// A22 -= L21 U12
+			Kernel::gemm(n - end, n - end, end - k0, (T)-1,
+				W + end*n + k0, n, W + k0*n + end, n,
+				(T)1, W + end*n + end, n, threads);
+		}
+	}
+
+	// Right looking cholesky on the lower triangle of the row major n x n array W.
+	template<typename T>
+	void cholesky_blocked(T* W, Index n, size_t threads)
+	{
+		std::vector<T> panel;
+		for(Index k0 = 0; k0 < n; k0 += DenseBlockSize)
+		{
+			const Index end = std::min(k0 + DenseBlockSize, n);
+
+			// L11
+			for(Index j = k0; j < end; ++j)
+			{
+				T* rowJ = W + j*n;
+				T s = rowJ[j];
+				for(Index k = k0; k < j; ++k)
+					s -= rowJ[k]*complex_conj(rowJ[k]);
+
+				// The diagonal of a hermitian matrix is real
+				if (!(std::real(s) > 0))
+					throw NotPositiveDefiniteException();
+
+				rowJ[j] = std::sqrt(std::real(s));
+				for(Index i = j+1; i < end; ++i)
+				{
+					T* rowI = W + i*n;
+					s = rowI[j];
+					for(Index k = k0; k < j; ++k)
+						s -= rowI[k]*complex_conj(rowJ[k]);
+					rowI[j] = s/rowJ[j];
+				}
+			}
+
+			if(end == n)
+				break;
+
+			// L21 = A21 L11^-*, every row on its own
+			Parallel::for_range(end, n, [&](Index begin, Index last, Index)
+			{
+				for(Index i = begin; i < last; ++i)
+				{
+					T* rowI = W + i*n;
+					for(Index j = k0; j < end; ++j)
+					{
+						const T* rowJ = W + j*n;
+						T s = rowI[j];
+						for(Index k = k0; k < j; ++k)
+							s -= rowI[k]*complex_conj(rowJ[k]);
+						rowI[j] = s/rowJ[j];
+					}
+				}
+			}, (n - end)*(end - k0) < (1 << 14) ? 1 : threads);
+
+			// A22 -= L21 L21^* on the lower triangle, by blocks of rows
+			const Index m = n - end;
+			panel.resize((end - k0)*m);
+			for(Index i = 0; i < m; ++i)
+			{
+				for(Index k = k0; k < end; ++k)
+					panel[(k - k0)*m + i] = complex_conj(W[(end + i)*n + k]);
+			}
+
+			const Index blocks = (m + DenseBlockSize - 1)/DenseBlockSize;
+			Parallel::for_range(0, blocks, [&](Index begin, Index last, Index)
+			{
+				for(Index b = begin; b < last; ++b)
+				{
+					const Index i = b*DenseBlockSize;
+					const Index rows = std::min(DenseBlockSize, m - i);
+					Kernel::gemm(rows, i + rows, end - k0, (T)-1,
+						W + (end + i)*n + k0, n, panel.data(), m,
+						(T)1, W + (end + i)*n + end, n, 1);
+				}
+			}, m*m*(end - k0) < (1 << 18) ? 1 : threads);
+		}
+	}
+
+	template<typename T>
+	void doolittle_dense(const DenseMatrix<T>& A, DenseMatrix<T>& L, DenseMatrix<T>& U, DenseMatrix<T>& P,
+		size_t* pivotCount, size_t threads)
+	{
+		if (A.rows() != A.columns())
+			throw NotSquareException();
+
+		if (A.rows() != L.rows() || A.columns() != L.columns() ||
+			A.rows() != P.rows() || A.columns() != P.columns())
+			throw InvalidOutputMatrixException();
+
+		const Index n = A.rows();
+
+		U = A;
+		size_t pivots = 0;
+		std::vector<Index> rowTable(n);
+		for (Index i = 0; i < n; ++i)
+			rowTable[i] = i;
+
+		doolittle_blocked(U.data(), n, rowTable.data(), pivots, threads);
+
+		if(pivotCount)
+			*pivotCount = pivots;
+
+		// Split into L and U
+		T* l = L.data();
+		T* u = U.data();
+		for (Index i = 0; i < n; ++i)
+		{
+			for (Index j = 0; j < i; ++j)
+			{
+				l[i*n + j] = u[i*n + j];
+				u[i*n + j] = (T)0;
+			}
+
+			l[i*n + i] = (T)1;
+			for (Index j = i+1; j < n; ++j)
+				l[i*n + j] = (T)0;
+		}
+
+		// Build pivot matrix
+		std::fill(P.data(), P.data() + P.size(), (T)0);
+		for (Index i = 0; i < n; ++i)
+			P.set(i,rowTable[i], (T)1);
+	}
+
+	template<typename T>
+	void cholesky_dense(const DenseMatrix<T>& m, DenseMatrix<T>& L, size_t threads)
+	{
+		if (m.rows() != m.columns())
+			throw NotSquareException();
+
+		if (m.rows() != L.rows() || m.columns() != L.columns())
+			throw InvalidOutputMatrixException();
+
+#ifdef NS_ALLOW_CHECKS
+		if (!Check::matrixIsHermitian(m))
+			throw NotHermitianException();
+#endif
+
+		const Index n = m.rows();
+
+		L = m;
+		cholesky_blocked(L.data(), n, threads);
+
+		T* l = L.data();
+		for (Index i = 0; i < n; ++i)
+		{
+			for (Index j = i+1; j < n; ++j)
+				l[i*n + j] = (T)0;
+		}
+	}
+
 	namespace serial {
 		template<class M>
 		void cholesky(const M& m, M& L)
@@ -27,7 +247,7 @@ namespace LU {
 				for (Index k = 0; k < j; ++k)
 				{
 					T v = L.at(j, k);
-					s += v*v;
+					s += v*complex_conj(v);
 				}
 
 				s = m.at(j, j) - s;
@@ -39,13 +259,25 @@ namespace LU {
 				{
 					s = (T)0;
 					for (Index k = 0; k < i; ++k)
-						s += L.at(i, k)*L.at(j, k);
+						s += L.at(i, k)*complex_conj(L.at(j, k));
 					L.set(i, j, (m.at(i, j) - s) / L.at(j, j));
 				}
 			}
 		}
 
+		template<typename T>
+		void cholesky(const DenseMatrix<T>& m, DenseMatrix<T>& L)
+		{
+			cholesky_dense(m, L, 1);
+		}
+
 		//---------------------------------------------------------------------
+		template<typename T>
+		void doolittle(const DenseMatrix<T>& A, DenseMatrix<T>& L, DenseMatrix<T>& U, DenseMatrix<T>& P, size_t* pivotCount)
+		{
+			doolittle_dense(A, L, U, P, pivotCount, 1);
+		}
+
 		template<typename T, class DC>
 		void doolittle(const BaseMatrix<T,DC>& A, BaseMatrix<T,DC>& L, BaseMatrix<T,DC>& U, BaseMatrix<T,DC>& P, size_t* pivotCount)
 		{
@@ -131,7 +363,6 @@ namespace LU {
 			delete[] rowTable;
 		}
 
-		/* TODO: Optimize*/
 		template<typename T>
 		void doolittle(const SparseMatrix<T>& A, SparseMatrix<T>& L, SparseMatrix<T>& U, SparseMatrix<T>& P, size_t* pivotCount)
 		{
@@ -140,126 +371,506 @@ namespace LU {
 
 			const size_t n = A.rows();
 
-			// Setup matrices
-			U = A;
-			L = SparseMatrix<T>(n,n);
+			SparseLU<T> lu(A, SO_Natural);
+
+			SparseMatrix<T> tmpL = lu.lower();
+			SparseMatrix<T> tmpU = lu.upper();
+			L.swap(tmpL);
+			U.swap(tmpU);
+
+			// Build pivot matrix
+			const auto& rowTable = lu.row_permutation();
+			std::vector<typename SparseMatrix<T>::index_type> rowPtr(n+1);
+			for (Index i = 0; i <= n; ++i)
+				rowPtr[i] = i;
+			std::vector<typename SparseMatrix<T>::index_type> cols(rowTable.begin(), rowTable.end());
+			std::vector<T> values(n, (T)1);
+			SparseMatrix<T> tmpP(n, n, std::move(rowPtr), std::move(cols), std::move(values));
+			P.swap(tmpP);
+
+			// Every cycle of length l in the permutation needs l-1 row exchanges
 			if(pivotCount)
-				*pivotCount = 0;
+			{
+				*pivotCount = n;
+				std::vector<bool> visited(n, false);
+				for (Index i = 0; i < n; ++i)
+				{
+					if(visited[i])
+						continue;
 
-			Index* rowTable = new Index[n];
-			for (Index i = 0; i < n; ++i)
+					--(*pivotCount);
+					for(Index j = i; !visited[j]; j = rowTable[j])
+						visited[j] = true;
+				}
+			}
+		}
+
+		template<typename T>
+		void ilu0(const SparseMatrix<T>& A, SparseMatrix<T>& L, SparseMatrix<T>& U)
+		{
+			SparseMatrix<T> M;
+			iluk(A, M, 0);
+
+			// Seperate M into L and U; zeros by cancellation are not kept
+			const Index n = M.rows();
+			const auto* mRow = M.row_ptr();
+			const auto* mCol = M.column_ptr();
+			const T* mVal = M.value_ptr();
+
+			std::vector<typename SparseMatrix<T>::index_type> lRow(n+1, 0), uRow(n+1, 0);
+			std::vector<typename SparseMatrix<T>::index_type> lCol, uCol;
+			std::vector<T> lVal, uVal;
+			lCol.reserve(mRow[n] + n);
+			lVal.reserve(mRow[n] + n);
+			uCol.reserve(mRow[n]);
+			uVal.reserve(mRow[n]);
+			for(Index i = 0; i < n; ++i)
 			{
-				L.set(i, i, (T)1);
-				rowTable[i] = i;
+				Index p = mRow[i];
+				for(; p < mRow[i+1] && mCol[p] < i; ++p)
+				{
+					if(mVal[p] == (T)0)
+						continue;
+					lCol.push_back(mCol[p]);
+					lVal.push_back(mVal[p]);
+				}
+				lCol.push_back(i);
+				lVal.push_back((T)1);
+
+				for(; p < mRow[i+1]; ++p)
+				{
+					if(mVal[p] == (T)0)
+						continue;
+					uCol.push_back(mCol[p]);
+					uVal.push_back(mVal[p]);
+				}
+
+				lRow[i+1] = SparseMatrix<T>::to_index(lCol.size());
+				uRow[i+1] = SparseMatrix<T>::to_index(uCol.size());
 			}
-			
-			// Start
-			for(Index k = 0; k < n-1; ++k)
+
+			SparseMatrix<T> tmpL(n, n, std::move(lRow), std::move(lCol), std::move(lVal));
+			SparseMatrix<T> tmpU(n, n, std::move(uRow), std::move(uCol), std::move(uVal));
+			L.swap(tmpL);
+			U.swap(tmpU);
+		}
+
+		template<typename T>
+		void iluk(const SparseMatrix<T>& A, SparseMatrix<T>& LU, Index level)
+		{
+			if (A.rows() != A.columns())
+				throw NotSquareException();
+
+			const Index n = A.rows();
+			const auto* aRow = A.row_ptr();
+			const auto* aCol = A.column_ptr();
+			const T* aVal = A.value_ptr();
+			const Index none = std::numeric_limits<Index>::max();
+
+			std::vector<typename SparseMatrix<T>::index_type> rowPtr(n+1, 0);
+			std::vector<typename SparseMatrix<T>::index_type> cols;
+			std::vector<T> vals;
+			std::vector<Index> levels;
+			cols.reserve(aRow[n]);
+			vals.reserve(aRow[n]);
+			levels.reserve(aRow[n]);
+			std::vector<Index> diag(n);
+
+			// Dense work row and its pattern
+			std::vector<T> w(n, (T)0);
+			std::vector<Index> lev(n, none);
+			std::vector<Index> pattern;
+			std::priority_queue<Index, std::vector<Index>, std::greater<Index> > lower;
+
+			for(Index i = 0; i < n; ++i)
 			{
-				// Find max i for pivoting
-				Index i = k;
-				auto m = std::abs(U.at(i,k));
-				for(Index j = k+1; j < n; ++j)
+				for(Index p = aRow[i]; p < aRow[i+1]; ++p)
 				{
-					const auto v = std::abs(U.at(j,k));
-					if(v >= m)
+					const Index j = aCol[p];
+					w[j] = aVal[p];
+					lev[j] = 0;
+					pattern.push_back(j);
+					if(j < i)
+						lower.push(j);
+				}
+
+				// Eliminate with the already calculated rows in increasing column order
+				while(!lower.empty())
+				{
+					const Index j = lower.top();
+					lower.pop();
+
+					const T d = w[j] / vals[diag[j]];
+					w[j] = d;
+
+					for(Index q = diag[j] + 1; q < rowPtr[j+1]; ++q)
 					{
-						m = v;
-						i = j;
+						const Index c = cols[q];
+						const Index l = lev[j] + levels[q] + 1;
+						if(lev[c] == none)
+						{
+							if(l > level)
+								continue;
+
+							lev[c] = l;
+							pattern.push_back(c);
+							if(c < i)
+								lower.push(c);
+						}
+						else if(l < lev[c])
+						{
+							lev[c] = l;
+						}
+
+						w[c] -= d * vals[q];
 					}
 				}
-				
-				// Reorder if necessary
-				if(i != k)
+
+				std::sort(pattern.begin(), pattern.end());
+				diag[i] = none;
+				for(Index c : pattern)
 				{
-					if(pivotCount)
-						(*pivotCount)++;
-					
-					for(Index j = k; j < n; ++j)// Swap upper part
+					if(c == i)
+						diag[i] = cols.size();
+
+					cols.push_back(c);
+					vals.push_back(w[c]);
+					levels.push_back(lev[c]);
+					w[c] = (T)0;
+					lev[c] = none;
+				}
+				pattern.clear();
+				rowPtr[i+1] = SparseMatrix<T>::to_index(cols.size());
+
+				if(diag[i] == none ||
+					std::abs(vals[diag[i]]) <= std::numeric_limits<typename get_complex_internal<T>::type>::epsilon())
+					throw SingularException();
+			}
+
+			SparseMatrix<T> tmp(n, n, std::move(rowPtr), std::move(cols), std::move(vals));
+			LU.swap(tmp);
+		}
+
+		template<typename T>
+		void ilut(const SparseMatrix<T>& A, SparseMatrix<T>& LU, double tolerance, size_t maxFill)
+		{
+			typedef typename get_complex_internal<T>::type real_type;
+
+			if (A.rows() != A.columns())
+				throw NotSquareException();
+
+			const Index n = A.rows();
+			const auto* aRow = A.row_ptr();
+			const auto* aCol = A.column_ptr();
+			const T* aVal = A.value_ptr();
+
+			std::vector<typename SparseMatrix<T>::index_type> rowPtr(n+1, 0);
+			std::vector<typename SparseMatrix<T>::index_type> cols;
+			std::vector<T> vals;
+			cols.reserve(aRow[n]);
+			vals.reserve(aRow[n]);
+			std::vector<Index> diag(n);
+
+			std::vector<T> w(n, (T)0);
+			std::vector<bool> used(n, false);
+			std::vector<Index> pattern;
+			std::vector<Index> lowerPart, upperPart;
+			std::priority_queue<Index, std::vector<Index>, std::greater<Index> > lower;
+
+			const auto larger = [&w](Index a, Index b) { return std::abs(w[a]) > std::abs(w[b]); };
+
+			for(Index i = 0; i < n; ++i)
+			{
+				real_type norm = 0;
+				for(Index p = aRow[i]; p < aRow[i+1]; ++p)
+				{
+					const Index j = aCol[p];
+					w[j] = aVal[p];
+					used[j] = true;
+					pattern.push_back(j);
+					if(j < i)
+						lower.push(j);
+
+					norm += std::abs(aVal[p]) * std::abs(aVal[p]);
+				}
+				const real_type tau = static_cast<real_type>(tolerance) * std::sqrt(norm);
+
+				while(!lower.empty())
+				{
+					const Index j = lower.top();
+					lower.pop();
+
+					const T d = w[j] / vals[diag[j]];
+					if(std::abs(d) <= tau)
 					{
-						const T tmp = U.at(k,j);
-						U.set(k,j,U.at(i,j));
-						U.set(i,j,tmp);
+						w[j] = (T)0;
+						continue;
 					}
-					
-					for(Index j = 0; j < k; ++j)// Swap lower part
+					w[j] = d;
+
+					for(Index q = diag[j] + 1; q < rowPtr[j+1]; ++q)
 					{
-						const T tmp = L.at(k,j);
-						L.set(k,j,L.at(i,j));
-						L.set(i,j,tmp);
+						const Index c = cols[q];
+						if(!used[c])
+						{
+							used[c] = true;
+							pattern.push_back(c);
+							if(c < i)
+								lower.push(c);
+						}
+
+						w[c] -= d * vals[q];
 					}
+				}
 
-					std::swap(rowTable[i], rowTable[k]);
+				// Dropping
+				for(Index c : pattern)
+				{
+					if(c == i || std::abs(w[c]) <= tau)
+						continue;
+
+					if(c < i)
+						lowerPart.push_back(c);
+					else
+						upperPart.push_back(c);
 				}
 
-				// Actual calculating
-				if(std::abs(U.at(k,k)) <=
-					std::numeric_limits<typename get_complex_internal<T>::type>::epsilon())
+				if(lowerPart.size() > maxFill)
+				{
+					std::nth_element(lowerPart.begin(), lowerPart.begin() + maxFill, lowerPart.end(), larger);
+					lowerPart.resize(maxFill);
+				}
+
+				if(upperPart.size() > maxFill)
+				{
+					std::nth_element(upperPart.begin(), upperPart.begin() + maxFill, upperPart.end(), larger);
+					upperPart.resize(maxFill);
+				}
+
+				std::sort(lowerPart.begin(), lowerPart.end());
+				std::sort(upperPart.begin(), upperPart.end());
+
+				if(!used[i] || std::abs(w[i]) <= std::numeric_limits<real_type>::epsilon())
 					throw SingularException();
 
-				const T invMid = (T)1/U.at(k,k);
-				for(Index j = k+1; j < n; ++j)
+				for(Index c : lowerPart)
 				{
-					L.set(j,k, U.at(j,k)*invMid);
+					cols.push_back(c);
+					vals.push_back(w[c]);
+				}
 
-					for(Index t = k; t < n; ++t)
-						U.set(j,t, U.at(j,t) - L.at(j,k)*U.at(k,t));
+				diag[i] = cols.size();
+				cols.push_back(i);
+				vals.push_back(w[i]);
+
+				for(Index c : upperPart)
+				{
+					cols.push_back(c);
+					vals.push_back(w[c]);
+				}
+
+				rowPtr[i+1] = SparseMatrix<T>::to_index(cols.size());
+
+				for(Index c : pattern)
+				{
+					w[c] = (T)0;
+					used[c] = false;
 				}
+				pattern.clear();
+				lowerPart.clear();
+				upperPart.clear();
 			}
 
-			// Build pivot matrix
-			P = SparseMatrix<T>(n,n);
-			for (Index i = 0; i < n; ++i)
-				P.set(i,rowTable[i], (T)1);
-			
-			delete[] rowTable;
+			SparseMatrix<T> tmp(n, n, std::move(rowPtr), std::move(cols), std::move(vals));
+			LU.swap(tmp);
 		}
 
 		template<typename T>
-		void ilu0(const SparseMatrix<T>& A, SparseMatrix<T>& L, SparseMatrix<T>& U)
+		void ic0(const SparseMatrix<T>& A, SparseMatrix<T>& L)
 		{
 			if (A.rows() != A.columns())
 				throw NotSquareException();
 
-			SparseMatrix<T> M = A;
-			// Calculate
-			for(Index i = 1; i < M.rows(); ++i)
-			{
-				for(auto it = M.row_begin(i); it != M.row_end(i) && it.column() < i; ++it)//a_ik
-				{
-					const auto mid = M.at(it.column(), it.column());
-					if(std::abs(mid) <= std::numeric_limits<typename get_complex_internal<T>::type>::epsilon())
-						throw SingularException();
+			const Index n = A.rows();
+			const auto* aRow = A.row_ptr();
+			const auto* aCol = A.column_ptr();
+			const T* aVal = A.value_ptr();
 
-					const auto d = *it/mid;
-					*it = d;
-					
-					auto it2 = it;
-					it2++;
-					for(; it2 != M.row_end(i); ++it2)//a_ij				
-						*it2 -= d * M.at(it.column(), it2.column());
-				}
+			// Pattern of the lower triangle
+			std::vector<typename SparseMatrix<T>::index_type> rowPtr(n+1, 0);
+			for(Index i = 0; i < n; ++i)
+			{
+				Index k = aRow[i];
+				while(k < aRow[i+1] && aCol[k] <= i)
+					++k;
+				rowPtr[i+1] = SparseMatrix<T>::to_index(rowPtr[i] + (k - aRow[i]));
 			}
 
-			// Seperate M into L and U
-			for(auto it = M.begin(); it != M.end(); ++it)
+			std::vector<typename SparseMatrix<T>::index_type> cols(rowPtr[n]);
+			std::vector<T> vals(rowPtr[n]);
+			for(Index i = 0; i < n; ++i)
 			{
-				if(it.column() == it.row())
+				for(Index k = 0; k < rowPtr[i+1] - rowPtr[i]; ++k)
 				{
-					L.set(it.row(), it.column(), 1);
-					U.set(it.row(), it.column(), *it);
+					cols[rowPtr[i] + k] = aCol[aRow[i] + k];
+					vals[rowPtr[i] + k] = aVal[aRow[i] + k];
 				}
-				else if(it.column() < it.row())
+			}
+
+			// Row by row: l_ij = (a_ij - sum_k<j l_ik conj(l_jk)) / l_jj
+			for(Index i = 0; i < n; ++i)
+			{
+				const Index start = rowPtr[i];
+				const Index diag = rowPtr[i+1] - 1;
+
+				if(rowPtr[i+1] == start || cols[diag] != i)
+					throw NotPositiveDefiniteException();
+
+				for(Index p = start; p < diag; ++p)
 				{
-					L.set(it.row(), it.column(), *it);
+					const Index j = cols[p];
+					const Index jDiag = rowPtr[j+1] - 1;
+
+					// Sparse dot product of both rows left of column j
+					T s = (T)0;
+					Index a = start;
+					Index b = rowPtr[j];
+					while(a < p && b < jDiag)
+					{
+						if(cols[a] == cols[b])
+						{
+							s += vals[a] * complex_conj(vals[b]);
+							++a;
+							++b;
+						}
+						else if(cols[a] < cols[b])
+						{
+							++a;
+						}
+						else
+						{
+							++b;
+						}
+					}
+
+					vals[p] = (vals[p] - s) / vals[jDiag];
 				}
-				else
+
+				T d = vals[diag];
+				for(Index p = start; p < diag; ++p)
+					d -= vals[p] * complex_conj(vals[p]);
+
+				if(!(std::real(d) > 0))
+					throw NotPositiveDefiniteException();
+
+				vals[diag] = std::sqrt(d);
+			}
+
+			SparseMatrix<T> tmp(n, n, std::move(rowPtr), std::move(cols), std::move(vals));
+			L.swap(tmp);
+		}
+
+		template<typename T, class V>
+		void solve_lower(const SparseMatrix<T>& L, V& x, bool unitDiagonal)
+		{
+			if (L.rows() != L.columns())
+				throw NotSquareException();
+
+			if (L.rows() != x.size())
+				throw MatrixVectorMismatchException();
+
+			const auto* rowPtr = L.row_ptr();
+			const auto* colPtr = L.column_ptr();
+			const T* values = L.value_ptr();
+
+			for(Index i = 0; i < L.rows(); ++i)
+			{
+				auto s = x[i];
+				Index k = rowPtr[i];
+				for(; k < rowPtr[i+1] && colPtr[k] < i; ++k)
+					s -= values[k] * x[colPtr[k]];
+
+				if(!unitDiagonal)
 				{
-					U.set(it.row(), it.column(), *it);
+					if(k == rowPtr[i+1] || colPtr[k] != i)
+						throw SingularException();
+					s /= values[k];
 				}
+
+				x[i] = s;
+			}
+		}
+
+		template<typename T, class V>
+		void solve_upper(const SparseMatrix<T>& U, V& x)
+		{
+			if (U.rows() != U.columns())
+				throw NotSquareException();
+
+			if (U.rows() != x.size())
+				throw MatrixVectorMismatchException();
+
+			const auto* rowPtr = U.row_ptr();
+			const auto* colPtr = U.column_ptr();
+			const T* values = U.value_ptr();
+
+			for(Index i = U.rows(); i-- > 0; )
+			{
+				Index k = rowPtr[i];
+				while(k < rowPtr[i+1] && colPtr[k] < i)
+					++k;
+
+				if(k == rowPtr[i+1] || colPtr[k] != i)
+					throw SingularException();
+
+				const T mid = values[k];
+				auto s = x[i];
+				for(++k; k < rowPtr[i+1]; ++k)
+					s -= values[k] * x[colPtr[k]];
+
+				x[i] = s / mid;
+			}
+		}
+
+		template<typename T, class V>
+		void solve_lower_adjugate(const SparseMatrix<T>& L, V& x)
+		{
+			if (L.rows() != L.columns())
+				throw NotSquareException();
+
+			if (L.rows() != x.size())
+				throw MatrixVectorMismatchException();
+
+			const auto* rowPtr = L.row_ptr();
+			const auto* colPtr = L.column_ptr();
+			const T* values = L.value_ptr();
+
+			// Column oriented backward substitution, as row i of L is column i of L^*
+			for(Index i = L.rows(); i-- > 0; )
+			{
+				Index diag = rowPtr[i+1];
+				while(diag > rowPtr[i] && colPtr[diag-1] > i)
+					--diag;
+
+				if(diag == rowPtr[i] || colPtr[diag-1] != i)
+					throw SingularException();
+				--diag;
+
+				const auto xi = x[i] / complex_conj(values[diag]);
+				x[i] = xi;
+
+				for(Index k = rowPtr[i]; k < diag; ++k)
+					x[colPtr[k]] -= complex_conj(values[k]) * xi;
 			}
 		}
 
+		template<typename T, class V>
+		void solve_ic(const SparseMatrix<T>& L, V& x)
+		{
+			solve_lower(L, x);
+			solve_lower_adjugate(L, x);
+		}
+
 		template<class M, class V>
 		V solve_lu(const M& L, const M& U, const V& b)
 		{
@@ -384,6 +995,456 @@ namespace LU {
 				}
 			}
 		}
+
+		/*
+		 * Right-looking biconjugation for one side. Returns Z^T, as the rows of Z^T are the columns of Z.
+		 * p_j = a_i^T z_j with a_i the i-th row of A. The pivots p_i are only stored if P is given.
+		 */
+		template<typename T>
+		SparseMatrix<T> ainv_columns(const SparseMatrix<T>& A, DynamicVector<T>* P, double tolerance)
+		{
+			typedef typename get_complex_internal<T>::type real_type;
+
+			if (A.rows() != A.columns())
+				throw NotSquareException();
+
+			const Index n = A.rows();
+			const auto* aRow = A.row_ptr();
+			const auto* aCol = A.column_ptr();
+			const T* aVal = A.value_ptr();
+			const real_type tol = static_cast<real_type>(tolerance);
+			const Index none = std::numeric_limits<Index>::max();
+
+			// Sparse columns of Z, sorted by row
+			std::vector<std::vector<Index> > zIdx(n);
+			std::vector<std::vector<T> > zVal(n);
+			// Columns which may have an entry in the given row
+			std::vector<std::vector<Index> > rowList(n);
+			for(Index j = 0; j < n; ++j)
+			{
+				zIdx[j].push_back(j);
+				zVal[j].push_back((T)1);
+				rowList[j].push_back(j);
+			}
+
+			std::vector<T> dense(n, (T)0);
+			std::vector<Index> mark(n, none);
+			std::vector<Index> candidates;
+			std::vector<Index> newIdx;
+			std::vector<T> newVal;
+
+			const auto dot = [&dense, &zIdx, &zVal](Index j)
+			{
+				T s = (T)0;
+				for(Index q = 0; q < zIdx[j].size(); ++q)
+					s += dense[zIdx[j][q]] * zVal[j][q];
+				return s;
+			};
+
+			if(P)
+				P->resize(n);
+			for(Index i = 0; i < n; ++i)
+			{
+				candidates.clear();
+				for(Index p = aRow[i]; p < aRow[i+1]; ++p)
+				{
+					dense[aCol[p]] = aVal[p];
+
+					// Finished columns are removed on the way
+					auto& list = rowList[aCol[p]];
+					Index m = 0;
+					for(Index j : list)
+					{
+						if(j <= i)
+							continue;
+
+						list[m++] = j;
+						if(mark[j] != i)
+						{
+							mark[j] = i;
+							candidates.push_back(j);
+						}
+					}
+					list.resize(m);
+				}
+
+				const T pi = dot(i);
+				if(std::abs(pi) <= std::numeric_limits<real_type>::epsilon())
+					throw SingularException();
+				if(P)
+					(*P)[i] = pi;
+
+				for(Index j : candidates)
+				{
+					const T pj = dot(j);
+					if(pj == (T)0)
+						continue;
+
+					// z_j -= pj/pi z_i with dropping
+					const T f = pj / pi;
+					newIdx.clear();
+					newVal.clear();
+					Index a = 0;
+					Index b = 0;
+					while(a < zIdx[j].size() || b < zIdx[i].size())
+					{
+						Index r;
+						T v;
+						bool fill = false;
+						if(b == zIdx[i].size() || (a < zIdx[j].size() && zIdx[j][a] < zIdx[i][b]))
+						{
+							r = zIdx[j][a];
+							v = zVal[j][a++];
+						}
+						else if(a == zIdx[j].size() || zIdx[i][b] < zIdx[j][a])
+						{
+							r = zIdx[i][b];
+							v = -f * zVal[i][b++];
+							fill = true;
+						}
+						else
+						{
+							r = zIdx[j][a];
+							v = zVal[j][a++] - f * zVal[i][b++];
+						}
+
+						if(r != j && std::abs(v) < tol)
+							continue;
+
+						newIdx.push_back(r);
+						newVal.push_back(v);
+						if(fill)
+							rowList[r].push_back(j);
+					}
+
+					zIdx[j].swap(newIdx);
+					zVal[j].swap(newVal);
+				}
+
+				for(Index p = aRow[i]; p < aRow[i+1]; ++p)
+					dense[aCol[p]] = (T)0;
+			}
+
+			std::vector<typename SparseMatrix<T>::index_type> rowPtr(n+1, 0);
+			for(Index j = 0; j < n; ++j)
+				rowPtr[j+1] = SparseMatrix<T>::to_index(rowPtr[j] + zIdx[j].size());
+
+			std::vector<typename SparseMatrix<T>::index_type> cols;
+			std::vector<T> vals;
+			cols.reserve(rowPtr[n]);
+			vals.reserve(rowPtr[n]);
+			for(Index j = 0; j < n; ++j)
+			{
+				cols.insert(cols.end(), zIdx[j].begin(), zIdx[j].end());
+				vals.insert(vals.end(), zVal[j].begin(), zVal[j].end());
+			}
+
+			return SparseMatrix<T>(n, n, std::move(rowPtr), std::move(cols), std::move(vals));
+		}
+
+		template<typename T>
+		void ainv(const SparseMatrix<T>& A, SparseMatrix<T>& Z, SparseMatrix<T>& W, DynamicVector<T>& D, double tolerance)
+		{
+			// In exact arithmetic both sides produce the same pivots, so only the ones of Z are kept
+			SparseMatrix<T> tmpZ = ainv_columns(A, &D, tolerance).transpose();
+			SparseMatrix<T> tmpW = ainv_columns<T>(A.transpose(), nullptr, tolerance).transpose();
+			Z.swap(tmpZ);
+			W.swap(tmpW);
+		}
+
+		template<typename T>
+		void ainv_hermitian(const SparseMatrix<T>& A, SparseMatrix<T>& Z, DynamicVector<T>& D, double tolerance)
+		{
+			SparseMatrix<T> tmp = ainv_columns(A, &D, tolerance).transpose();
+			Z.swap(tmp);
+		}
+	}
+
+	inline Index LevelSchedule::levels() const
+	{
+		return LevelPtr.empty() ? 0 : LevelPtr.size() - 1;
+	}
+
+	namespace parallel {
+		template<typename T>
+		void cholesky(const DenseMatrix<T>& m, DenseMatrix<T>& L, size_t threads)
+		{
+			cholesky_dense(m, L, threads);
+		}
+
+		template<typename T>
+		void doolittle(const DenseMatrix<T>& A, DenseMatrix<T>& L, DenseMatrix<T>& U, DenseMatrix<T>& P,
+			size_t* pivotCount, size_t threads)
+		{
+			doolittle_dense(A, L, U, P, pivotCount, threads);
+		}
+
+		template<typename T>
+		LevelSchedule level_schedule_lower(const SparseMatrix<T>& L)
+		{
+			if (L.rows() != L.columns())
+				throw NotSquareException();
+
+			const Index n = L.rows();
+			const auto* rowPtr = L.row_ptr();
+			const auto* colPtr = L.column_ptr();
+
+			// Level of a row is one more than the highest level of its dependencies
+			std::vector<Index> level(n, 0);
+			Index count = 0;
+			for(Index i = 0; i < n; ++i)
+			{
+				Index l = 0;
+				for(Index k = rowPtr[i]; k < rowPtr[i+1] && colPtr[k] < i; ++k)
+					l = std::max(l, level[colPtr[k]] + 1);
+				level[i] = l;
+				count = std::max(count, l + 1);
+			}
+
+			LevelSchedule schedule;
+			schedule.LevelPtr.assign(count + 1, 0);
+			for(Index i = 0; i < n; ++i)
+				++schedule.LevelPtr[level[i] + 1];
+			for(Index l = 0; l < count; ++l)
+				schedule.LevelPtr[l+1] += schedule.LevelPtr[l];
+
+			schedule.Rows.resize(n);
+			std::vector<Index> next(schedule.LevelPtr.begin(), schedule.LevelPtr.end()-1);
+			for(Index i = 0; i < n; ++i)
+				schedule.Rows[next[level[i]]++] = i;
+
+			return schedule;
+		}
+
+		template<typename T>
+		LevelSchedule level_schedule_upper(const SparseMatrix<T>& U)
+		{
+			if (U.rows() != U.columns())
+				throw NotSquareException();
+
+			const Index n = U.rows();
+			const auto* rowPtr = U.row_ptr();
+			const auto* colPtr = U.column_ptr();
+
+			std::vector<Index> level(n, 0);
+			Index count = 0;
+			for(Index i = n; i-- > 0; )
+			{
+				Index l = 0;
+				for(Index k = rowPtr[i+1]; k > rowPtr[i] && colPtr[k-1] > i; --k)
+					l = std::max(l, level[colPtr[k-1]] + 1);
+				level[i] = l;
+				count = std::max(count, l + 1);
+			}
+
+			LevelSchedule schedule;
+			schedule.LevelPtr.assign(count + 1, 0);
+			for(Index i = 0; i < n; ++i)
+				++schedule.LevelPtr[level[i] + 1];
+			for(Index l = 0; l < count; ++l)
+				schedule.LevelPtr[l+1] += schedule.LevelPtr[l];
+
+			schedule.Rows.resize(n);
+			std::vector<Index> next(schedule.LevelPtr.begin(), schedule.LevelPtr.end()-1);
+			for(Index i = 0; i < n; ++i)
+				schedule.Rows[next[level[i]]++] = i;
+
+			return schedule;
+		}
+
+		/*
+		 Only for internal use.
+		 Substitution of row i, returns false if the diagonal entry is missing.
+		 */
+		template<typename T, class V>
+		inline bool solve_lower_row(const SparseMatrix<T>& L, Index i, V& x, bool unitDiagonal)
+		{
+			const auto* rowPtr = L.row_ptr();
+			const auto* colPtr = L.column_ptr();
+			const T* values = L.value_ptr();
+
+			auto s = x[i];
+			Index k = rowPtr[i];
+			for(; k < rowPtr[i+1] && colPtr[k] < i; ++k)
+				s -= values[k] * x[colPtr[k]];
+
+			bool regular = true;
+			if(!unitDiagonal)
+			{
+				if(k == rowPtr[i+1] || colPtr[k] != i)
+					regular = false;
+				else
+					s /= values[k];
+			}
+
+			x[i] = s;
+			return regular;
+		}
+
+		template<typename T, class V>
+		inline bool solve_upper_row(const SparseMatrix<T>& U, Index i, V& x)
+		{
+			const auto* rowPtr = U.row_ptr();
+			const auto* colPtr = U.column_ptr();
+			const T* values = U.value_ptr();
+
+			Index k = rowPtr[i];
+			while(k < rowPtr[i+1] && colPtr[k] < i)
+				++k;
+
+			if(k == rowPtr[i+1] || colPtr[k] != i)
+				return false;
+
+			const T mid = values[k];
+			auto s = x[i];
+			for(++k; k < rowPtr[i+1]; ++k)
+				s -= values[k] * x[colPtr[k]];
+
+			x[i] = s / mid;
+			return true;
+		}
+
+		/*
+		 Only for internal use.
+		 The part of the given thread of every level, the levels are separated by the barrier.
+		 */
+		template<class F>
+		inline void solve_levels(const LevelSchedule& levels, Index thread, size_t threads,
+			Parallel::Barrier& barrier, const F& row)
+		{
+			for(Index l = 0; l < levels.levels(); ++l)
+			{
+				const Index start = levels.LevelPtr[l];
+				const Index size = levels.LevelPtr[l+1] - start;
+				const Index begin = start + thread*size/threads;
+				const Index end = start + (thread+1)*size/threads;
+
+				for(Index r = begin; r < end; ++r)
+					row(levels.Rows[r]);
+
+				barrier.wait();
+			}
+		}
+
+		template<typename T>
+		bool use_levels(const SparseMatrix<T>& A, const LevelSchedule& levels, size_t& threads)
+		{
+			if(threads == 0)
+				threads = Parallel::thread_count();
+#ifdef NS_NO_THREADS
+			threads = 1;
+#endif
+
+			return threads > 1 && A.filled_count() >= Parallel::SerialThreshold
+				&& A.rows() >= threads * levels.levels();
+		}
+
+		template<typename T, class V>
+		void solve_lower(const SparseMatrix<T>& L, const LevelSchedule& levels, V& x,
+			bool unitDiagonal, size_t threads)
+		{
+			if (L.rows() != L.columns())
+				throw NotSquareException();
+
+			if (L.rows() != x.size())
+				throw MatrixVectorMismatchException();
+
+			NS_ASSERT(levels.Rows.size() == L.rows());
+
+			if(!use_levels(L, levels, threads))
+			{
+				serial::solve_lower(L, x, unitDiagonal);
+				return;
+			}
+
+			Parallel::Barrier barrier(threads);
+			std::atomic<bool> singular(false);
+			Parallel::for_range(0, threads, [&](Index, Index, Index thread)
+			{
+				solve_levels(levels, thread, threads, barrier, [&](Index i)
+				{
+					if(!solve_lower_row(L, i, x, unitDiagonal))
+						singular = true;
+				});
+			}, threads);
+
+			if(singular)
+				throw SingularException();
+		}
+
+		template<typename T, class V>
+		void solve_upper(const SparseMatrix<T>& U, const LevelSchedule& levels, V& x, size_t threads)
+		{
+			if (U.rows() != U.columns())
+				throw NotSquareException();
+
+			if (U.rows() != x.size())
+				throw MatrixVectorMismatchException();
+
+			NS_ASSERT(levels.Rows.size() == U.rows());
+
+			if(!use_levels(U, levels, threads))
+			{
+				serial::solve_upper(U, x);
+				return;
+			}
+
+			Parallel::Barrier barrier(threads);
+			std::atomic<bool> singular(false);
+			Parallel::for_range(0, threads, [&](Index, Index, Index thread)
+			{
+				solve_levels(levels, thread, threads, barrier, [&](Index i)
+				{
+					if(!solve_upper_row(U, i, x))
+						singular = true;
+				});
+			}, threads);
+
+			if(singular)
+				throw SingularException();
+		}
+
+		template<typename T, class V>
+		void solve_lower_upper(const SparseMatrix<T>& L, const LevelSchedule& lowerLevels,
+			const SparseMatrix<T>& U, const LevelSchedule& upperLevels, V& x,
+			bool unitDiagonal, size_t threads)
+		{
+			if (L.rows() != L.columns() || U.rows() != U.columns())
+				throw NotSquareException();
+
+			if (L.rows() != x.size() || U.rows() != x.size())
+				throw MatrixVectorMismatchException();
+
+			NS_ASSERT(lowerLevels.Rows.size() == L.rows());
+			NS_ASSERT(upperLevels.Rows.size() == U.rows());
+
+			if(!use_levels(L, lowerLevels, threads) || !use_levels(U, upperLevels, threads))
+			{
+				solve_lower(L, lowerLevels, x, unitDiagonal, threads);
+				solve_upper(U, upperLevels, x, threads);
+				return;
+			}
+
+			// The barrier after the last lower level separates both substitutions
+			Parallel::Barrier barrier(threads);
+			std::atomic<bool> singular(false);
+			Parallel::for_range(0, threads, [&](Index, Index, Index thread)
+			{
+				solve_levels(lowerLevels, thread, threads, barrier, [&](Index i)
+				{
+					if(!solve_lower_row(L, i, x, unitDiagonal))
+						singular = true;
+				});
+				solve_levels(upperLevels, thread, threads, barrier, [&](Index i)
+				{
+					if(!solve_upper_row(U, i, x))
+						singular = true;
+				});
+			}, threads);
+
+			if(singular)
+				throw SingularException();
+		}
 	}
 }
 NS_END_NAMESPACE
\ No newline at end of file
@@ -0,0 +1,138 @@
+#pragma once
+
+#include "Types.h"
+#include "Exceptions.h"
+#include "Iterative.h"
+#include "SparseFactorization.h"
+#include "Vector.h"
+
+#include "matrix/SparseMatrix.h"
+#include "mesh/HyperCube.h"
+
+#include <vector>
+
+NS_BEGIN_NAMESPACE
+
+/**
+ * @brief Smoothers used on the finer levels of a multigrid hierarchy.
+ */
+enum MultigridSmoother
+{
+	MS_Jacobi = 0,	// Weighted jacobi, see Iterative::serial::jacobi_sweep
+	MS_SOR			// Forward SOR before and backward SOR after the coarse correction
+};
+
+/**
+ * @brief Multigrid V-cycle on a given hierarchy of matrices and prolongators.
+ * Level 0 is the finest level. The coarsest level is solved directly by SparseLU.
+ * The restriction is the adjugate of the prolongation.
+ * Can be used as preconditioner with CG::serial::pcg.
+ * For hermitian matrices and MS_SOR the cycle is symmetric.
+ */
+template<typename T>
+class Multigrid
+{
+public:
+	Multigrid();
+
+	/**
+	 * @brief Sets up the hierarchy.
+	 * prolongators[l] maps level l+1 to level l, therefore
+	 * matrices.size() == prolongators.size() + 1 has to hold.
+	 * @throw NotSquareException
+	 * @throw MatrixMulMismatchException
+	 */
+	void setup(std::vector<SparseMatrix<T> >&& matrices, std::vector<SparseMatrix<T> >&& prolongators);
+
+	/**
+	 * @brief Galerkin coarse operator P^* A P.
+	 * @throw MatrixMulMismatchException
+	 */
+	static SparseMatrix<T> galerkin(const SparseMatrix<T>& A, const SparseMatrix<T>& P);
+
+	void set_smoother(MultigridSmoother smoother, double weight = 1, size_t sweeps = 1);
+
+	/**
+	 * @brief Applies one V-cycle with zero initial guess: z = M^-1 r.
+	 */
+	template<class V>
+	void apply(const V& r, V& z) const;
+
+	/**
+	 * @brief Repeats V-cycles until the residual is below eps.
+	 */
+	DynamicVector<T> solve(const DynamicVector<T>& b, const DynamicVector<T>& x0,
+		size_t maxIter = 1024, double eps = 10e-6, size_t* it_stat = nullptr) const;
+
+	inline size_t levels() const { return mMatrices.size(); }
+	inline const SparseMatrix<T>& matrix(size_t level) const { return mMatrices[level]; }
+	inline const SparseMatrix<T>& prolongator(size_t level) const { return mProlongators[level]; }
+
+private:
+	void cycle(size_t level, const DynamicVector<T>& b, DynamicVector<T>& x) const;
+	void smooth(size_t level, const DynamicVector<T>& b, DynamicVector<T>& x, bool post) const;
+
+	std::vector<SparseMatrix<T> > mMatrices;
+	std::vector<SparseMatrix<T> > mProlongators;
+	std::vector<SparseMatrix<T> > mRestrictors;
+	SparseLU<T> mCoarseSolver;
+
+	MultigridSmoother mSmoother;
+	double mWeight;
+	size_t mSweeps;
+};
+
+/**
+ * @brief Smoothed aggregation algebraic multigrid.
+ * @details Node j is strongly connected to i if |a_ij| >= strength * sqrt(|a_ii a_jj|).
+ * Strongly connected nodes are grouped into aggregates, which build the
+ * tentative prolongator. It is smoothed by one damped jacobi step P = (I - w D^-1 A) T.
+ * Coarse operators are calculated by the galerkin product.
+ * Coarsening stops if a level has at most coarseSize rows or maxLevels is reached.
+ * Intended for hermitian positive definite matrices, e.g. from FEM discretizations.
+ * @throw NotSquareException
+ * @throw MatrixHasZeroInDiagException
+ */
+template<typename T>
+class AlgebraicMultigrid : public Multigrid<T>
+{
+public:
+	explicit AlgebraicMultigrid(const SparseMatrix<T>& A, double strength = 0.08,
+		Index coarseSize = 64, size_t maxLevels = 16);
+
+	/**
+	 * @brief Returns the aggregate of every node or std::numeric_limits<Index>::max() if
+	 * a node has no strong connections and is therefore not part of the coarse level.
+	 */
+	static std::vector<Index> aggregate(const SparseMatrix<T>& A, double strength, Index& count);
+
+	/**
+	 * @brief Smoothed prolongator P = (I - w D^-1 A) T with w = 4/(3 rho(D^-1 A)).
+	 * rho is bounded by the gershgorin circles.
+	 */
+	static SparseMatrix<T> smoothed_prolongator(const SparseMatrix<T>& A,
+		const std::vector<Index>& aggregates, Index count);
+};
+
+/**
+ * @brief Geometric multigrid for matrices assembled with linear shape functions
+ * on a grid from HyperCube<T,2>::generate.
+ * @details The grid is coarsened by halving the elements in every direction as
+ * long as they are even. Prolongation is the linear interpolation from
+ * HyperCube<T,2>::prolongator and coarse operators are the galerkin products,
+ * therefore no coarse assembly is needed.
+ * @throw MatrixSizeMismatchException if A does not match the vertex count of the grid.
+ */
+template<typename T>
+class GeometricMultigrid : public Multigrid<T>
+{
+public:
+	GeometricMultigrid(const SparseMatrix<T>& A, const FixedVector<Dimension,2>& elements,
+		Index coarseSize = 64, size_t maxLevels = 16);
+};
+
+NS_END_NAMESPACE
+
+#define _NS_MULTIGRID_INL
+# include "Multigrid.inl"
+#undef _NS_MULTIGRID_INL
\ No newline at end of file
@@ -0,0 +1,400 @@
+#ifndef _NS_MULTIGRID_INL
+# error Multigrid.inl should only be included by Multigrid.h
+#endif
+
+#include <cmath>
+#include <limits>
+
+NS_BEGIN_NAMESPACE
+
+template<typename T>
+Multigrid<T>::Multigrid() :
+	mCoarseSolver(SO_ReverseCuthillMcKee), mSmoother(MS_SOR), mWeight(1), mSweeps(1)
+{
+}
+
+template<typename T>
+void Multigrid<T>::setup(std::vector<SparseMatrix<T> >&& matrices, std::vector<SparseMatrix<T> >&& prolongators)
+{
+	NS_ASSERT(!matrices.empty());
+	NS_ASSERT(matrices.size() == prolongators.size() + 1);
+
+	for(size_t l = 0; l < matrices.size(); ++l)
+	{
+		if(matrices[l].rows() != matrices[l].columns())
+			throw NotSquareException();
+
+		if(l < prolongators.size() &&
+			(prolongators[l].rows() != matrices[l].rows() || prolongators[l].columns() != matrices[l+1].rows()))
+			throw MatrixMulMismatchException();
+	}
+
+	mMatrices = std::move(matrices);
+	mProlongators = std::move(prolongators);
+
+	mRestrictors.clear();
+	mRestrictors.reserve(mProlongators.size());
+	for(const SparseMatrix<T>& P : mProlongators)
+		mRestrictors.push_back(P.adjugate());
+
+	mCoarseSolver.compute(mMatrices.back());
+}
+
+template<typename T>
+SparseMatrix<T> Multigrid<T>::galerkin(const SparseMatrix<T>& A, const SparseMatrix<T>& P)
+{
+	return P.adjugate().mul(A.mul(P));
+}
+
+template<typename T>
+void Multigrid<T>::set_smoother(MultigridSmoother smoother, double weight, size_t sweeps)
+{
+	mSmoother = smoother;
+	mWeight = weight;
+	mSweeps = sweeps;
+}
+
+template<typename T>
+template<class V>
+void Multigrid<T>::apply(const V& r, V& z) const
+{
+	NS_ASSERT(!mMatrices.empty());
+	NS_ASSERT(r.size() == mMatrices.front().rows());
+
+	DynamicVector<T> b(r.size());
+	for(Index i = 0; i < r.size(); ++i)
+		b[i] = r[i];
+
+	DynamicVector<T> x(r.size());
+	cycle(0, b, x);
+
+	z = r;
+	for(Index i = 0; i < r.size(); ++i)
+		z[i] = x[i];
+}
+
+template<typename T>
+DynamicVector<T> Multigrid<T>::solve(const DynamicVector<T>& b, const DynamicVector<T>& x0,
+	size_t maxIter, double eps, size_t* it_stat) const
+{
+	NS_ASSERT(!mMatrices.empty());
+
+	if(b.size() != mMatrices.front().rows() || x0.size() != b.size())
+		throw MatrixVectorMismatchException();
+
+	DynamicVector<T> x = x0;
+	for(size_t it = 0; it < maxIter; ++it)
+	{
+		DynamicVector<T> r = b - mMatrices.front().mul(x);
+		if(r.mag() <= eps)
+		{
+			if(it_stat)
+				*it_stat = it;
+			return x;
+		}
+
+		cycle(0, b, x);
+	}
+
+	if(it_stat)
+		*it_stat = maxIter;
+
+	return x;
+}
+
+template<typename T>
+void Multigrid<T>::cycle(size_t level, const DynamicVector<T>& b, DynamicVector<T>& x) const
+{
+	if(level + 1 == mMatrices.size())
+	{
+		x = mCoarseSolver.solve(b);
+		return;
+	}
+
+	smooth(level, b, x, false);
+
+	const DynamicVector<T> r = b - mMatrices[level].mul(x);
+	const DynamicVector<T> rc = mRestrictors[level].mul(r);
+
+	DynamicVector<T> xc(rc.size());
+	cycle(level + 1, rc, xc);
+	x += mProlongators[level].mul(xc);
+
+	smooth(level, b, x, true);
+}
+
+template<typename T>
+void Multigrid<T>::smooth(size_t level, const DynamicVector<T>& b, DynamicVector<T>& x, bool post) const
+{
+	switch(mSmoother)
+	{
+	case MS_Jacobi:
+		Iterative::serial::jacobi_sweep(mMatrices[level], b, x, mWeight, mSweeps);
+		break;
+	case MS_SOR:
+		Iterative::serial::sor_sweep(mMatrices[level], b, x, mWeight, mSweeps, post);
+		break;
+	}
+}
+
+template<typename T>
+AlgebraicMultigrid<T>::AlgebraicMultigrid(const SparseMatrix<T>& A, double strength,
+	Index coarseSize, size_t maxLevels) :
+	Multigrid<T>()
+{
+	if(A.rows() != A.columns())
+		throw NotSquareException();
+
+	std::vector<SparseMatrix<T> > matrices;
+	std::vector<SparseMatrix<T> > prolongators;
+	matrices.push_back(A);
+
+	while(matrices.size() < maxLevels && matrices.back().rows() > coarseSize)
+	{
+		const SparseMatrix<T>& current = matrices.back();
+
+		Index count;
+		const std::vector<Index> aggregates = aggregate(current, strength, count);
+		if(count == 0 || count >= current.rows())
+			break;
+
+		SparseMatrix<T> P = smoothed_prolongator(current, aggregates, count);
+		SparseMatrix<T> coarse = Multigrid<T>::galerkin(current, P);
+
+		prolongators.push_back(P);
+		matrices.push_back(coarse);
+	}
+
+	this->setup(std::move(matrices), std::move(prolongators));
+}
+
+template<typename T>
+GeometricMultigrid<T>::GeometricMultigrid(const SparseMatrix<T>& A, const FixedVector<Dimension,2>& elements,
+	Index coarseSize, size_t maxLevels) :
+	Multigrid<T>()
+{
+	if(A.rows() != A.columns())
+		throw NotSquareException();
+	if(A.rows() != (elements[0] + 1)*(elements[1] + 1))
+		throw MatrixSizeMismatchException();
+
+	std::vector<SparseMatrix<T> > matrices;
+	std::vector<SparseMatrix<T> > prolongators;
+	matrices.push_back(A);
+
+	FixedVector<Dimension,2> current = elements;
+	while(matrices.size() < maxLevels && matrices.back().rows() > coarseSize &&
+		current[0] % 2 == 0 && current[1] % 2 == 0)
+	{
+		current[0] /= 2;
+		current[1] /= 2;
+
+		SparseMatrix<T> P = HyperCube<T,2>::prolongator(current);
+		SparseMatrix<T> coarse = Multigrid<T>::galerkin(matrices.back(), P);
+
+		prolongators.push_back(P);
+		matrices.push_back(coarse);
+	}
+
+	this->setup(std::move(matrices), std::move(prolongators));
+}
+
+template<typename T>
+std::vector<Index> AlgebraicMultigrid<T>::aggregate(const SparseMatrix<T>& A, double strength, Index& count)
+{
+	typedef typename get_complex_internal<T>::type real_type;
+	const Index None = std::numeric_limits<Index>::max();
+
+	if(A.rows() != A.columns())
+		throw NotSquareException();
+
+	const Index n = A.rows();
+	const auto* rowPtr = A.row_ptr();
+	const auto* colPtr = A.column_ptr();
+	const T* values = A.value_ptr();
+
+	std::vector<real_type> diag(n, 0);
+	for(Index i = 0; i < n; ++i)
+	{
+		for(Index k = rowPtr[i]; k < rowPtr[i+1]; ++k)
+		{
+			if(colPtr[k] == i)
+				diag[i] = std::abs(values[k]);
+		}
+	}
+
+	// Strength of connection: only the strong off diagonal entries are kept
+	std::vector<Index> strongPtr(n + 1, 0);
+	std::vector<Index> strong;
+	strong.reserve(A.filled_count());
+	for(Index i = 0; i < n; ++i)
+	{
+		for(Index k = rowPtr[i]; k < rowPtr[i+1]; ++k)
+		{
+			const Index j = colPtr[k];
+			if(j != i &&
+				std::abs(values[k]) >= strength * std::sqrt(diag[i] * diag[j]))
+				strong.push_back(j);
+		}
+		strongPtr[i+1] = strong.size();
+	}
+
+	std::vector<Index> aggregates(n, None);
+	count = 0;
+
+	// Phase 1: Nodes with a completely free strong neighbourhood become roots
+	for(Index i = 0; i < n; ++i)
+	{
+		if(aggregates[i] != None || strongPtr[i] == strongPtr[i+1])
+			continue;
+
+		bool free = true;
+		for(Index k = strongPtr[i]; k < strongPtr[i+1] && free; ++k)
+			free = aggregates[strong[k]] == None;
+
+		if(!free)
+			continue;
+
+		aggregates[i] = count;
+		for(Index k = strongPtr[i]; k < strongPtr[i+1]; ++k)
+			aggregates[strong[k]] = count;
+		++count;
+	}
+
+	// Phase 2: Remaining nodes join a strongly connected aggregate from phase 1
+	const std::vector<Index> phase1 = aggregates;
+	for(Index i = 0; i < n; ++i)
+	{
+		if(aggregates[i] != None)
+			continue;
+
+		for(Index k = strongPtr[i]; k < strongPtr[i+1]; ++k)
+		{
+			if(phase1[strong[k]] != None)
+			{
+				aggregates[i] = phase1[strong[k]];
+				break;
+			}
+		}
+	}
+
+	// Phase 3: Left over nodes build aggregates with their free strong neighbours
+	for(Index i = 0; i < n; ++i)
+	{
+		if(aggregates[i] != None || strongPtr[i] == strongPtr[i+1])
+			continue;
+
+		aggregates[i] = count;
+		for(Index k = strongPtr[i]; k < strongPtr[i+1]; ++k)
+		{
+			if(aggregates[strong[k]] == None)
+				aggregates[strong[k]] = count;
+		}
+		++count;
+	}
+
+	return aggregates;
+}
+
+template<typename T>
+SparseMatrix<T> AlgebraicMultigrid<T>::smoothed_prolongator(const SparseMatrix<T>& A,
+	const std::vector<Index>& aggregates, Index count)
+{
+	typedef typename get_complex_internal<T>::type real_type;
+	const Index None = std::numeric_limits<Index>::max();
+
+	NS_ASSERT(aggregates.size() == A.rows());
+
+	const Index n = A.rows();
+	const auto* rowPtr = A.row_ptr();
+	const auto* colPtr = A.column_ptr();
+	const T* values = A.value_ptr();
+
+	// Tentative prolongator
+	std::vector<Index> tRowPtr(n + 1, 0);
+	std::vector<Index> tColPtr;
+	std::vector<T> tValues;
+	tColPtr.reserve(n);
+	tValues.reserve(n);
+	for(Index i = 0; i < n; ++i)
+	{
+		if(aggregates[i] != None)
+		{
+			tColPtr.push_back(aggregates[i]);
+			tValues.push_back((T)1);
+		}
+		tRowPtr[i+1] = tColPtr.size();
+	}
+	const SparseMatrix<T> tentative(n, count, std::move(tRowPtr), std::move(tColPtr), std::move(tValues));
+
+	// Inverse diagonal and gershgorin bound of the spectral radius of D^-1 A
+	std::vector<T> inverseDiagonal(n, (T)0);
+	real_type rho = 0;
+	for(Index i = 0; i < n; ++i)
+	{
+		real_type sum = 0;
+		for(Index k = rowPtr[i]; k < rowPtr[i+1]; ++k)
+		{
+			sum += std::abs(values[k]);
+			if(colPtr[k] == i)
+				inverseDiagonal[i] = values[k];
+		}
+
+		if(inverseDiagonal[i] == (T)0)
+			throw MatrixHasZeroInDiagException();
+
+		rho = std::max(rho, sum / std::abs(inverseDiagonal[i]));
+		inverseDiagonal[i] = (T)1 / inverseDiagonal[i];
+	}
+
+	const T omega = (T)((real_type)4 / ((real_type)3 * rho));
+
+	// P = T - w D^-1 A T. Entries of A T may cancel out, therefore T is merged explicitly
+	const SparseMatrix<T> AT = A.mul(tentative);
+	const auto* aRowPtr = AT.row_ptr();
+	const auto* aColPtr = AT.column_ptr();
+	const T* aValues = AT.value_ptr();
+
+	std::vector<typename SparseMatrix<T>::index_type> pRowPtr(n + 1, 0);
+	std::vector<typename SparseMatrix<T>::index_type> pColPtr;
+	std::vector<T> pValues;
+	pColPtr.reserve(AT.filled_count() + n);
+	pValues.reserve(AT.filled_count() + n);
+	for(Index i = 0; i < n; ++i)
+	{
+		bool merged = aggregates[i] == None;
+		for(Index k = aRowPtr[i]; k < aRowPtr[i+1]; ++k)
+		{
+			if(!merged && aggregates[i] < aColPtr[k])
+			{
+				pColPtr.push_back(aggregates[i]);
+				pValues.push_back((T)1);
+				merged = true;
+			}
+
+			T v = -omega * inverseDiagonal[i] * aValues[k];
+			if(aColPtr[k] == aggregates[i])
+			{
+				v += (T)1;
+				merged = true;
+			}
+
+			if(v != (T)0)
+			{
+				pColPtr.push_back(aColPtr[k]);
+				pValues.push_back(v);
+			}
+		}
+
+		if(!merged)
+		{
+			pColPtr.push_back(aggregates[i]);
+			pValues.push_back((T)1);
+		}
+		pRowPtr[i+1] = SparseMatrix<T>::to_index(pColPtr.size());
+	}
+
+	return SparseMatrix<T>(n, count, std::move(pRowPtr), std::move(pColPtr), std::move(pValues));
+}
+
+NS_END_NAMESPACE
\ No newline at end of file
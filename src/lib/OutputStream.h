@@ -46,4 +46,17 @@ std::ostream& operator<<(std::ostream& out, const NS::SparseMatrix<T>& f)
 	return out;
 }
 
+template<typename T, NS::Dimension B>
+std::ostream& operator<<(std::ostream& out, const NS::BlockSparseMatrix<T,B>& f)
+{
+	out << "[ ";
+	for (Index i = 0; i < f.block_rows(); ++i)
+	{
+		for (Index p = f.row_ptr()[i]; p < f.row_ptr()[i + 1]; ++p)
+			out << "(" << i << ", " << f.column_ptr()[p] << "; " << f.block(i, f.column_ptr()[p]) << ") ";
+	}
+	out << "]";
+	return out;
+}
+
 NS_END_NAMESPACE
\ No newline at end of file
@@ -0,0 +1,67 @@
+#pragma once
+
+#include "nsConfig.h"
+
+#ifndef NS_NO_THREADS
+# include <atomic>
+# include <thread>
+#endif
+#include <vector>
+
+NS_BEGIN_NAMESPACE
+
+/**
+ * @brief Minimal helpers to distribute work over multiple threads.
+ * @details Define NS_NO_THREADS to execute everything in the calling thread.
+ */
+namespace Parallel
+{
+	/**
+	 * @brief Returns the amount of threads used by default.
+	 * @details Always at least 1.
+	 */
+	inline size_t thread_count();
+
+	/**
+	 * @brief Amount of filled entries below which the parallel sparse kernels stay in the calling thread.
+	 */
+	constexpr Index SerialThreshold = 1 << 15;
+
+	/**
+	 * @brief Splits [start, end) into contiguous chunks and processes each in its own thread.
+	 * @details The functor has the signature `void(Index begin, Index end, Index thread)`
+	 * and is called at most once per thread. The calling thread processes the last chunk.
+	 * The threads are started in every call and joined before it returns.
+	 * The functor should not throw.
+	 * @param threads Amount of threads to use. 0 uses thread_count().
+	 */
+	template<class F>
+	void for_range(Index start, Index end, const F& func, size_t threads = 0);
+
+	/**
+	 * @brief Reusable spinning barrier for a fixed amount of threads.
+	 * @details Meant for many short phases, like the levels of a triangular solve.
+	 * With NS_NO_THREADS only a count of 1 is supported.
+	 */
+	class Barrier
+	{
+	public:
+		explicit Barrier(size_t count);
+
+		// Blocks until all threads called wait()
+		void wait();
+
+	private:
+		size_t mCount;
+#ifndef NS_NO_THREADS
+		std::atomic<size_t> mWaiting;
+		std::atomic<size_t> mGeneration;
+#endif
+	};
+}
+
+NS_END_NAMESPACE
+
+#define _NS_PARALLEL_INL
+# include "Parallel.inl"
+#undef _NS_PARALLEL_INL
\ No newline at end of file
@@ -0,0 +1,93 @@
+#ifndef _NS_PARALLEL_INL
+# error Parallel.inl should only be included by Parallel.h
+#endif
+
+NS_BEGIN_NAMESPACE
+
+namespace Parallel
+{
+	inline size_t thread_count()
+	{
+#ifdef NS_NO_THREADS
+		return 1;
+#else
+		const size_t count = std::thread::hardware_concurrency();
+		return count > 0 ? count : 1;
+#endif
+	}
+
+	template<class F>
+	void for_range(Index start, Index end, const F& func, size_t threads)
+	{
+		if(end <= start)
+			return;
+
+		if(threads == 0)
+			threads = thread_count();
+
+		const Index size = end - start;
+		if(threads > size)
+			threads = size;
+
+#ifdef NS_NO_THREADS
+		threads = 1;
+#endif
+
+		if(threads <= 1)
+		{
+			func(start, end, 0);
+			return;
+		}
+
+#ifndef NS_NO_THREADS
+		const Index chunk = size / threads;
+		const Index rest = size % threads;
+
+		std::vector<std::thread> workers;
+		workers.reserve(threads - 1);
+
+		Index begin = start;
+		for(Index t = 0; t < threads - 1; ++t)
+		{
+			const Index next = begin + chunk + (t < rest ? 1 : 0);
+			workers.push_back(std::thread([&func, begin, next, t]() { func(begin, next, t); }));
+			begin = next;
+		}
+
+		func(begin, end, threads - 1);
+
+		for(std::thread& worker : workers)
+			worker.join();
+#endif
+	}
+
+	inline Barrier::Barrier(size_t count) :
+		mCount(count)
+#ifndef NS_NO_THREADS
+		, mWaiting(0), mGeneration(0)
+#endif
+	{
+		NS_ASSERT(count > 0);
+	}
+
+	inline void Barrier::wait()
+	{
+#ifndef NS_NO_THREADS
+		const size_t generation = mGeneration.load(std::memory_order_acquire);
+		if(mWaiting.fetch_add(1, std::memory_order_acq_rel) + 1 == mCount)
+		{
+			mWaiting.store(0, std::memory_order_relaxed);
+			mGeneration.fetch_add(1, std::memory_order_release);
+		}
+		else
+		{
+			while(mGeneration.load(std::memory_order_acquire) == generation)
+				std::this_thread::yield();
+		}
+#else
+		NS_ASSERT(mCount == 1);
+#endif
+	}
+}
+
+NS_END_NAMESPACE
\ No newline at end of file
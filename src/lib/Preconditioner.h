@@ -0,0 +1,180 @@
+#pragma once
+
+#include "Types.h"
+#include "Exceptions.h"
+#include "LU.h"
+
+#include "matrix/SparseMatrix.h"
+#include "matrix/BlockSparseMatrix.h"
+#include "matrix/MatrixOperations.h"
+
+#include <vector>
+
+NS_BEGIN_NAMESPACE
+
+/*
+ * Preconditioners approximate M^-1 for a system matrix M.
+ * Every preconditioner provides
+ *   template<class V> void apply(const V& r, V& z) const;
+ * which calculates z = M^-1 r. z is overwritten and has the same size as r afterwards.
+ * Any class with such a member can be used with CG::serial::pcg.
+ */
+
+/**
+ * @brief Uses an explicit (approximated) inverse matrix C with z = C r.
+ */
+template<class M>
+class MatrixPreconditioner
+{
+public:
+	explicit MatrixPreconditioner(const M& c);
+
+	template<class V>
+	void apply(const V& r, V& z) const;
+
+private:
+	const M& mMatrix;
+};
+
+/**
+ * @brief Jacobi preconditioner z_i = r_i / a_ii.
+ * Only the inverse diagonal is stored.
+ * @throw NotSquareException
+ * @throw SingularException
+ */
+template<typename T>
+class JacobiPreconditioner
+{
+public:
+	template<class M>
+	explicit JacobiPreconditioner(const M& A);
+
+	template<class V>
+	void apply(const V& r, V& z) const;
+
+private:
+	std::vector<T> mInverseDiagonal;
+};
+
+/**
+ * @brief Block Jacobi preconditioner z_i = A_ii^-1 r_i for the BxB diagonal blocks of a block sparse matrix.
+ * Couplings between the degrees of freedom of one block are kept, unlike in JacobiPreconditioner.
+ * @throw NotSquareException
+ * @throw SingularException
+ */
+template<typename T, Dimension B>
+class BlockJacobiPreconditioner
+{
+public:
+	explicit BlockJacobiPreconditioner(const BlockSparseMatrix<T,B>& A);
+
+	template<class V>
+	void apply(const V& r, V& z) const;
+
+private:
+	std::vector<FixedMatrix<T,B,B> > mInverseDiagonal;
+};
+
+/**
+ * @brief Incomplete LU preconditioner with L and U from LU::serial::ilu0.
+ * Applied by a level scheduled forward and backward substitution.
+ * @param threads Amount of threads used in apply(). 0 uses Parallel::thread_count().
+ * @throw NotSquareException
+ * @throw SingularException
+ */
+template<typename T>
+class ILU0Preconditioner
+{
+public:
+	explicit ILU0Preconditioner(const SparseMatrix<T>& A, size_t threads = 0);
+
+	template<class V>
+	void apply(const V& r, V& z) const;
+
+private:
+	SparseMatrix<T> mL;
+	SparseMatrix<T> mU;
+	LU::LevelSchedule mLowerLevels;
+	LU::LevelSchedule mUpperLevels;
+	size_t mThreads;
+};
+
+/**
+ * @brief Incomplete LU preconditioner for a factorization in combined storage,
+ * like from LU::serial::iluk or LU::serial::ilut.
+ * @param threads Amount of threads used in apply(). 0 uses Parallel::thread_count().
+ * @throw NotSquareException
+ */
+template<typename T>
+class ILUPreconditioner
+{
+public:
+	explicit ILUPreconditioner(const SparseMatrix<T>& factor, size_t threads = 0);
+
+	template<class V>
+	void apply(const V& r, V& z) const;
+
+private:
+	SparseMatrix<T> mLU;
+	LU::LevelSchedule mLowerLevels;
+	LU::LevelSchedule mUpperLevels;
+	size_t mThreads;
+};
+
+/**
+ * @brief Incomplete Cholesky preconditioner with L from LU::serial::ic0.
+ * L^* is stored explicitly to allow a level scheduled backward substitution.
+ * @param threads Amount of threads used in apply(). 0 uses Parallel::thread_count().
+ * @throw NotSquareException
+ * @throw NotPositiveDefiniteException
+ */
+template<typename T>
+class IC0Preconditioner
+{
+public:
+	explicit IC0Preconditioner(const SparseMatrix<T>& A, size_t threads = 0);
+
+	template<class V>
+	void apply(const V& r, V& z) const;
+
+private:
+	SparseMatrix<T> mL;
+	SparseMatrix<T> mLAdjugate;
+	LU::LevelSchedule mLowerLevels;
+	LU::LevelSchedule mUpperLevels;
+	size_t mThreads;
+};
+
+/**
+ * @brief Factorized approximate inverse preconditioner z = Z D^-1 W^T r with the factors from LU::serial::ainv.
+ * Applying it only needs sparse matrix vector products, which are distributed over multiple threads.
+ * The intermediate vector of apply() is allocated once, so one preconditioner must not be applied concurrently.
+ * @param tolerance Drop tolerance of the factors.
+ * @param hermitian Uses LU::serial::ainv_hermitian, which is only valid for hermitian matrices.
+ * @param threads Amount of threads used in apply(). 0 uses Parallel::thread_count().
+ * @throw NotSquareException
+ * @throw SingularException
+ */
+template<typename T>
+class AINVPreconditioner
+{
+public:
+	explicit AINVPreconditioner(const SparseMatrix<T>& A, double tolerance, bool hermitian = false, size_t threads = 0);
+
+	template<class V>
+	void apply(const V& r, V& z) const;
+
+private:
+	SparseMatrix<T> mZ;
+	SparseMatrix<T> mWt;// W^T
+	std::vector<T> mInverseDiagonal;
+	mutable DynamicVector<T> mTemp;// D^-1 W^T r
+	size_t mThreads;
+};
+
+NS_END_NAMESPACE
+
+
+#define _NS_PRECONDITIONER_INL
+# include "Preconditioner.inl"
+#undef _NS_PRECONDITIONER_INL
\ No newline at end of file
@@ -0,0 +1,179 @@
+#ifndef _NS_PRECONDITIONER_INL
+# error Preconditioner.inl should only be included by Preconditioner.h
+#endif
+
+NS_BEGIN_NAMESPACE
+
+template<class M>
+MatrixPreconditioner<M>::MatrixPreconditioner(const M& c) :
+	mMatrix(c)
+{
+	if (c.rows() != c.columns())
+		throw NotSquareException();
+}
+
+template<class M>
+template<class V>
+void MatrixPreconditioner<M>::apply(const V& r, V& z) const
+{
+	z = mMatrix.mul(r);
+}
+
+// ----------------------------------------------
+template<typename T>
+template<class M>
+JacobiPreconditioner<T>::JacobiPreconditioner(const M& A) :
+	mInverseDiagonal(A.rows())
+{
+	if (A.rows() != A.columns())
+		throw NotSquareException();
+
+	for(Index i = 0; i < A.rows(); ++i)
+	{
+		const T mid = A.at(i,i);
+		if(std::abs(mid) <= std::numeric_limits<typename get_complex_internal<T>::type>::epsilon())
+			throw SingularException();
+		mInverseDiagonal[i] = (T)1/mid;
+	}
+}
+
+template<typename T>
+template<class V>
+void JacobiPreconditioner<T>::apply(const V& r, V& z) const
+{
+	NS_ASSERT(r.size() == mInverseDiagonal.size());
+
+	z = r;
+	for(Index i = 0; i < mInverseDiagonal.size(); ++i)
+		z[i] *= mInverseDiagonal[i];
+}
+
+// ----------------------------------------------
+template<typename T, Dimension B>
+BlockJacobiPreconditioner<T,B>::BlockJacobiPreconditioner(const BlockSparseMatrix<T,B>& A)
+{
+	if (A.rows() != A.columns())
+		throw NotSquareException();
+
+	mInverseDiagonal.reserve(A.block_rows());
+	for(Index i = 0; i < A.block_rows(); ++i)
+		mInverseDiagonal.push_back(Operations::inverse(A.block(i,i)));
+}
+
+template<typename T, Dimension B>
+template<class V>
+void BlockJacobiPreconditioner<T,B>::apply(const V& r, V& z) const
+{
+	NS_ASSERT(r.size() == mInverseDiagonal.size()*B);
+
+	z = r;
+	for(Index i = 0; i < mInverseDiagonal.size(); ++i)
+	{
+		const T* a = mInverseDiagonal[i].data();
+		for(Index k = 0; k < B; ++k)
+		{
+			T s = (T)0;
+			for(Index l = 0; l < B; ++l)
+				s += a[k*B + l] * r[i*B + l];
+			z[i*B + k] = s;
+		}
+	}
+}
+
+template<typename T>
+ILU0Preconditioner<T>::ILU0Preconditioner(const SparseMatrix<T>& A, size_t threads) :
+	mL(A.rows(), A.columns()), mU(A.rows(), A.columns()), mThreads(threads)
+{
+	LU::serial::ilu0(A, mL, mU);
+	mLowerLevels = LU::parallel::level_schedule_lower(mL);
+	mUpperLevels = LU::parallel::level_schedule_upper(mU);
+}
+
+template<typename T>
+template<class V>
+void ILU0Preconditioner<T>::apply(const V& r, V& z) const
+{
+	NS_ASSERT(r.size() == mL.rows());
+
+	z = r;
+	LU::parallel::solve_lower_upper(mL, mLowerLevels, mU, mUpperLevels, z, true, mThreads);
+}
+
+// ----------------------------------------------
+template<typename T>
+ILUPreconditioner<T>::ILUPreconditioner(const SparseMatrix<T>& factor, size_t threads) :
+	mLU(factor), mThreads(threads)
+{
+	mLowerLevels = LU::parallel::level_schedule_lower(mLU);
+	mUpperLevels = LU::parallel::level_schedule_upper(mLU);
+}
+
+template<typename T>
+template<class V>
+void ILUPreconditioner<T>::apply(const V& r, V& z) const
+{
+	NS_ASSERT(r.size() == mLU.rows());
+
+	z = r;
+	LU::parallel::solve_lower_upper(mLU, mLowerLevels, mLU, mUpperLevels, z, true, mThreads);
+}
+
+// ----------------------------------------------
+template<typename T>
+IC0Preconditioner<T>::IC0Preconditioner(const SparseMatrix<T>& A, size_t threads) :
+	mL(A.rows(), A.columns()), mThreads(threads)
+{
+	LU::serial::ic0(A, mL);
+	mLAdjugate = mL.adjugate();
+	mLowerLevels = LU::parallel::level_schedule_lower(mL);
+	mUpperLevels = LU::parallel::level_schedule_upper(mLAdjugate);
+}
+
+template<typename T>
+template<class V>
+void IC0Preconditioner<T>::apply(const V& r, V& z) const
+{
+	NS_ASSERT(r.size() == mL.rows());
+
+	z = r;
+	LU::parallel::solve_lower_upper(mL, mLowerLevels, mLAdjugate, mUpperLevels, z, false, mThreads);
+}
+
+// ----------------------------------------------
+template<typename T>
+AINVPreconditioner<T>::AINVPreconditioner(const SparseMatrix<T>& A, double tolerance, bool hermitian, size_t threads) :
+	mThreads(threads)
+{
+	DynamicVector<T> D;
+	if(hermitian)
+	{
+		LU::serial::ainv_hermitian(A, mZ, D, tolerance);
+		mWt = mZ.adjugate();
+	}
+	else
+	{
+		SparseMatrix<T> W;
+		LU::serial::ainv(A, mZ, W, D, tolerance);
+		mWt = W.transpose();
+	}
+
+	mInverseDiagonal.resize(D.size());
+	for(Index i = 0; i < D.size(); ++i)
+		mInverseDiagonal[i] = (T)1 / D[i];
+
+	mTemp.resize(D.size());
+}
+
+template<typename T>
+template<class V>
+void AINVPreconditioner<T>::apply(const V& r, V& z) const
+{
+	NS_ASSERT(r.size() == mInverseDiagonal.size());
+
+	Operations::parallel::mul(mWt, r, mTemp, mThreads);
+	for(Index i = 0; i < mInverseDiagonal.size(); ++i)
+		mTemp[i] *= mInverseDiagonal[i];
+	Operations::parallel::mul(mZ, mTemp, z, mThreads);
+}
+
+NS_END_NAMESPACE
\ No newline at end of file
@@ -9,7 +9,6 @@ Simplex<T,K>::Simplex() :
 	mVertices(), mPrepared(false), mDeterminant(0)
 {
 	static_assert(K > 0, "Simplex of k-order should be bigger than 0");
-	static_assert(K==2, "Simplex currently only implemented for 2D!");
 }
 
 template<typename T, Dimension K>
@@ -37,13 +36,7 @@ void Simplex<T,K>::prepare()
 			mMatrix.set(j,i-1, dist[j]);
 	}
 
-	mDeterminant = Operations::determinant(mMatrix);
-
-	mInverseMatrix.set(0,0, mMatrix.at(1,1));
-	mInverseMatrix.set(0,1, -mMatrix.at(0,1));
-	mInverseMatrix.set(1,1, mMatrix.at(0,0));
-	mInverseMatrix.set(1,0, -mMatrix.at(1,0));
-	mInverseMatrix *= (T)1/mDeterminant;
+	mDeterminant = Operations::determinant_inverse(mMatrix, mInverseMatrix);
 
 	mPrepared = true;
 }
@@ -0,0 +1,221 @@
+#pragma once
+
+#include "Types.h"
+#include "Exceptions.h"
+
+#include "matrix/SparseMatrix.h"
+#include "matrix/MatrixOrder.h"
+
+#include <vector>
+
+NS_BEGIN_NAMESPACE
+
+/**
+ * @brief Fill-reducing orderings applied before a sparse factorization.
+ */
+enum SparseOrdering
+{
+	SO_Natural = 0,
+	SO_ReverseCuthillMcKee,
+	SO_ApproximateMinimumDegree,
+	SO_NestedDissection
+};
+
+/**
+ * @brief Symbolic analysis of sparse matrices.
+ * All functions work on the pattern of the lower triangle of a matrix with symmetric pattern.
+ */
+namespace Symbolic
+{
+	/**
+	 * @brief Returns a permutation with perm[new] = old for the given ordering.
+	 * @throw NotSquareException
+	 */
+	template<typename T>
+	std::vector<Index> ordering(const SparseMatrix<T>& A, SparseOrdering order);
+
+	/**
+	 * @brief Pattern of A + A^T with all entries set to 1.
+	 * @throw NotSquareException
+	 */
+	template<typename T>
+	SparseMatrix<T> symmetric_pattern(const SparseMatrix<T>& A);
+
+	/**
+	 * @brief Elimination tree of A. Roots have the parent A.rows().
+	 * @par Complexity
+	 * \f$ O(nnz(A) \log n) \f$
+	 * @throw NotSquareException
+	 */
+	template<typename T>
+	std::vector<Index> elimination_tree(const SparseMatrix<T>& A);
+
+	/**
+	 * @brief Pattern of row k of the cholesky factor L without the diagonal.
+	 * The pattern is written in topological order to [top, n) of stack.
+	 * mark has to be of size n and contain no k.
+	 * @return top
+	 */
+	template<typename T>
+	Index row_pattern(const SparseMatrix<T>& A, Index k, const std::vector<Index>& parent,
+		std::vector<Index>& stack, std::vector<Index>& mark);
+
+	/**
+	 * @brief Amount of entries in every column of the cholesky factor L, including the diagonal.
+	 * @par Complexity
+	 * \f$ O(nnz(L)) \f$
+	 */
+	template<typename T>
+	std::vector<Index> column_counts(const SparseMatrix<T>& A, const std::vector<Index>& parent);
+}
+
+/**
+ * @brief Sparse cholesky factorization P A P^T = L L^* for hermitian positive definite matrices.
+ * @details The factorization is split into a symbolic analysis (ordering, elimination tree and column counts)
+ * and a numeric up-looking factorization into the preallocated pattern of L.
+ * The numeric part can be repeated for matrices with the same pattern, and
+ * solve() can be called for as many right hand sides as needed.
+ */
+template<typename T>
+class SparseCholesky
+{
+public:
+	explicit SparseCholesky(SparseOrdering order = SO_ReverseCuthillMcKee);
+	explicit SparseCholesky(const SparseMatrix<T>& A, SparseOrdering order = SO_ReverseCuthillMcKee);
+
+	/**
+	 * @brief Symbolic analysis of the pattern of A.
+	 * The pattern of A has to be symmetric. Values are only taken from the lower triangle.
+	 * @throw NotSquareException
+	 */
+	void analyze(const SparseMatrix<T>& A);
+
+	/**
+	 * @brief Numeric factorization of A.
+	 * A has to have the same pattern as in analyze().
+	 * If A has another size, analyze() is called first.
+	 * @throw PatternMismatchException
+	 * @throw NotPositiveDefiniteException
+	 */
+	void factorize(const SparseMatrix<T>& A);
+
+	/**
+	 * @brief analyze() and factorize() in one step.
+	 */
+	void compute(const SparseMatrix<T>& A);
+
+	/**
+	 * @brief Solves A x = b with the calculated factorization.
+	 * @throw MatrixVectorMismatchException
+	 */
+	DynamicVector<T> solve(const DynamicVector<T>& b) const;
+
+	/**
+	 * @brief The lower triangular factor L of the permuted matrix.
+	 */
+	SparseMatrix<T> factor() const;
+
+	const std::vector<Index>& permutation() const;
+	const std::vector<Index>& elimination_tree() const;
+
+	Dimension size() const;
+	size_t filled_count() const;
+
+private:
+	SparseMatrix<T> permute(const SparseMatrix<T>& A) const;
+	void numeric();
+
+	SparseOrdering mOrdering;
+	Dimension mSize;
+
+	std::vector<Index> mPermutation;// perm[new] = old
+	std::vector<Index> mInversePermutation;
+	std::vector<Index> mParent;
+
+	SparseMatrix<T> mPermuted;// Permuted lower triangle of A
+
+	// L in CCS
+	std::vector<Index> mColumnPtr;
+	std::vector<Index> mRowIndex;
+	std::vector<T> mValues;
+	bool mFactorized;
+};
+
+/**
+ * @brief Sparse LU factorization P A Q = L U with partial pivoting.
+ * @details Left-looking Gilbert-Peierls algorithm: Every column of L and U is calculated by a
+ * sparse triangular solve with the already calculated columns of L, which only
+ * touches the reachable entries. The column ordering Q is calculated on the pattern of A + A^T.
+ * A row is only exchanged when the diagonal entry is smaller than threshold times the largest candidate.
+ */
+template<typename T>
+class SparseLU
+{
+public:
+	typedef typename get_complex_internal<T>::type real_type;
+
+	explicit SparseLU(SparseOrdering order = SO_ReverseCuthillMcKee, real_type threshold = 1);
+	explicit SparseLU(const SparseMatrix<T>& A, SparseOrdering order = SO_ReverseCuthillMcKee, real_type threshold = 1);
+
+	/**
+	 * @throw NotSquareException
+	 * @throw SingularException
+	 */
+	void compute(const SparseMatrix<T>& A);
+
+	/**
+	 * @brief Solves A x = b with the calculated factorization.
+	 * @throw MatrixVectorMismatchException
+	 */
+	DynamicVector<T> solve(const DynamicVector<T>& b) const;
+
+	/**
+	 * @brief The unit lower triangular factor L.
+	 * @note Exact zeros produced by cancellation are not part of the returned matrix.
+	 */
+	SparseMatrix<T> lower() const;
+
+	/**
+	 * @brief The upper triangular factor U.
+	 * @note Exact zeros produced by cancellation are not part of the returned matrix.
+	 */
+	SparseMatrix<T> upper() const;
+
+	// Row k of L U is row row_permutation()[k] of A
+	const std::vector<Index>& row_permutation() const;
+	// Column k of L U is column column_permutation()[k] of A
+	const std::vector<Index>& column_permutation() const;
+
+	Dimension size() const;
+	size_t filled_count() const;
+
+private:
+	Index reach(const std::vector<Index>& aColPtr, const std::vector<Index>& aRowIndex, Index column,
+		std::vector<Index>& stack, std::vector<Index>& work, std::vector<bool>& mark) const;
+
+	static SparseMatrix<T> to_crs(Dimension n, const std::vector<Index>& colPtr,
+		const std::vector<Index>& rowIndex, const std::vector<T>& values);
+
+	SparseOrdering mOrdering;
+	real_type mThreshold;
+	Dimension mSize;
+
+	std::vector<Index> mRowPermutation;
+	std::vector<Index> mInverseRowPermutation;
+	std::vector<Index> mColumnPermutation;
+
+	// L (unit diagonal first) and U (diagonal last) in CCS
+	std::vector<Index> mLColumnPtr;
+	std::vector<Index> mLRowIndex;
+	std::vector<T> mLValues;
+	std::vector<Index> mUColumnPtr;
+	std::vector<Index> mURowIndex;
+	std::vector<T> mUValues;
+};
+
+NS_END_NAMESPACE
+
+
+#define _NS_SPARSEFACTORIZATION_INL
+# include "SparseFactorization.inl"
+#undef _NS_SPARSEFACTORIZATION_INL
\ No newline at end of file
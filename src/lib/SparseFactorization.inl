@@ -0,0 +1,764 @@
+#ifndef _NS_SPARSEFACTORIZATION_INL
+# error SparseFactorization.inl should only be included by SparseFactorization.h
+#endif
+
+NS_BEGIN_NAMESPACE
+
+namespace Symbolic
+{
+	template<typename T>
+	std::vector<Index> ordering(const SparseMatrix<T>& A, SparseOrdering order)
+	{
+		if (A.rows() != A.columns())
+			throw NotSquareException();
+
+		const Index n = A.rows();
+		std::vector<Index> perm(n);
+
+		switch(order)
+		{
+		default:
+		case SO_Natural:
+			for(Index i = 0; i < n; ++i)
+				perm[i] = i;
+			break;
+		case SO_ReverseCuthillMcKee:
+		{
+			const auto r = r_cuthill_mckee(symmetric_pattern(A));
+			for(Index i = 0; i < n; ++i)
+				perm[i] = r[i];
+		}
+			break;
+		case SO_ApproximateMinimumDegree:
+		{
+			const auto r = approximate_minimum_degree(A);
+			for(Index i = 0; i < n; ++i)
+				perm[i] = r[i];
+		}
+			break;
+		case SO_NestedDissection:
+		{
+			const auto r = nested_dissection(A);
+			for(Index i = 0; i < n; ++i)
+				perm[i] = r[i];
+		}
+			break;
+		}
+
+		return perm;
+	}
+
+	template<typename T>
+	SparseMatrix<T> symmetric_pattern(const SparseMatrix<T>& A)
+	{
+		if (A.rows() != A.columns())
+			throw NotSquareException();
+
+		const Index n = A.rows();
+		const auto* aRow = A.row_ptr();
+		const auto* aCol = A.column_ptr();
+
+		// Transposed pattern; rows are scattered in order, so every column is sorted
+		std::vector<Index> tRow(n+1, 0);
+		for(Index p = 0; p < aRow[n]; ++p)
+			++tRow[aCol[p]+1];
+		for(Index i = 0; i < n; ++i)
+			tRow[i+1] += tRow[i];
+
+		std::vector<Index> tCol(aRow[n]);
+		std::vector<Index> next(tRow.begin(), tRow.end()-1);
+		for(Index i = 0; i < n; ++i)
+		{
+			for(Index p = aRow[i]; p < aRow[i+1]; ++p)
+				tCol[next[aCol[p]]++] = i;
+		}
+
+		// Merge both sorted rows
+		std::vector<typename SparseMatrix<T>::index_type> rowPtr(n+1, 0);
+		std::vector<typename SparseMatrix<T>::index_type> cols;
+		cols.reserve(2*aRow[n]);
+		for(Index i = 0; i < n; ++i)
+		{
+			Index a = aRow[i];
+			Index b = tRow[i];
+			while(a < aRow[i+1] || b < tRow[i+1])
+			{
+				if(b == tRow[i+1] || (a < aRow[i+1] && aCol[a] < tCol[b]))
+				{
+					cols.push_back(aCol[a++]);
+				}
+				else if(a == aRow[i+1] || tCol[b] < aCol[a])
+				{
+					cols.push_back(tCol[b++]);
+				}
+				else
+				{
+					cols.push_back(aCol[a++]);
+					++b;
+				}
+			}
+			rowPtr[i+1] = SparseMatrix<T>::to_index(cols.size());
+		}
+
+		std::vector<T> values(cols.size(), (T)1);
+		return SparseMatrix<T>(n, n, std::move(rowPtr), std::move(cols), std::move(values));
+	}
+
+	template<typename T>
+	std::vector<Index> elimination_tree(const SparseMatrix<T>& A)
+	{
+		if (A.rows() != A.columns())
+			throw NotSquareException();
+
+		const Index n = A.rows();
+		const auto* aRow = A.row_ptr();
+		const auto* aCol = A.column_ptr();
+
+		std::vector<Index> parent(n, n);
+		std::vector<Index> ancestor(n, n);// Path compressed ancestors
+		for(Index k = 0; k < n; ++k)
+		{
+			for(Index p = aRow[k]; p < aRow[k+1] && aCol[p] < k; ++p)
+			{
+				Index i = aCol[p];
+				while(i != n && i < k)
+				{
+					const Index next = ancestor[i];
+					ancestor[i] = k;
+					if(next == n)
+						parent[i] = k;
+					i = next;
+				}
+			}
+		}
+
+		return parent;
+	}
+
+	template<typename T>
+	Index row_pattern(const SparseMatrix<T>& A, Index k, const std::vector<Index>& parent,
+		std::vector<Index>& stack, std::vector<Index>& mark)
+	{
+		const auto* aRow = A.row_ptr();
+		const auto* aCol = A.column_ptr();
+
+		// Every entry a_ki marks the path from i to k in the elimination tree
+		Index top = A.rows();
+		mark[k] = k;
+		for(Index p = aRow[k]; p < aRow[k+1] && aCol[p] < k; ++p)
+		{
+			Index len = 0;
+			for(Index i = aCol[p]; mark[i] != k; i = parent[i])
+			{
+				stack[len++] = i;
+				mark[i] = k;
+			}
+
+			while(len > 0)
+				stack[--top] = stack[--len];
+		}
+
+		return top;
+	}
+
+	template<typename T>
+	std::vector<Index> column_counts(const SparseMatrix<T>& A, const std::vector<Index>& parent)
+	{
+		const Index n = A.rows();
+
+		std::vector<Index> counts(n, 1);
+		std::vector<Index> stack(n);
+		std::vector<Index> mark(n, n);
+		for(Index k = 0; k < n; ++k)
+		{
+			for(Index p = row_pattern(A, k, parent, stack, mark); p < n; ++p)
+				++counts[stack[p]];
+		}
+
+		return counts;
+	}
+}
+
+// ----------------------------------------------
+template<typename T>
+SparseCholesky<T>::SparseCholesky(SparseOrdering order) :
+	mOrdering(order), mSize(0), mFactorized(false)
+{
+}
+
+template<typename T>
+SparseCholesky<T>::SparseCholesky(const SparseMatrix<T>& A, SparseOrdering order) :
+	mOrdering(order), mSize(0), mFactorized(false)
+{
+	compute(A);
+}
+
+template<typename T>
+SparseMatrix<T> SparseCholesky<T>::permute(const SparseMatrix<T>& A) const
+{
+	const Index n = mSize;
+	const auto* aRow = A.row_ptr();
+	const auto* aCol = A.column_ptr();
+	const T* aVal = A.value_ptr();
+
+	// Lower triangle of P A P^T, first scattered by column and then by row to get sorted rows
+	std::vector<Index> cPtr(n+1, 0);
+	for(Index i = 0; i < n; ++i)
+	{
+		for(Index p = aRow[i]; p < aRow[i+1] && aCol[p] <= i; ++p)
+			++cPtr[std::min(mInversePermutation[i], mInversePermutation[aCol[p]])+1];
+	}
+	for(Index i = 0; i < n; ++i)
+		cPtr[i+1] += cPtr[i];
+
+	std::vector<Index> cRow(cPtr[n]);
+	std::vector<T> cVal(cPtr[n]);
+	std::vector<Index> next(cPtr.begin(), cPtr.end()-1);
+	for(Index i = 0; i < n; ++i)
+	{
+		for(Index p = aRow[i]; p < aRow[i+1] && aCol[p] <= i; ++p)
+		{
+			const Index r = mInversePermutation[i];
+			const Index c = mInversePermutation[aCol[p]];
+			const Index q = next[std::min(r,c)]++;
+			cRow[q] = std::max(r,c);
+			cVal[q] = r >= c ? aVal[p] : complex_conj(aVal[p]);
+		}
+	}
+
+	// The row offsets are bounded by the amount of entries
+	const Index count = SparseMatrix<T>::to_index(cPtr[n]);
+	std::vector<typename SparseMatrix<T>::index_type> rowPtr(n+1, 0);
+	for(Index p = 0; p < count; ++p)
+		++rowPtr[cRow[p]+1];
+	for(Index i = 0; i < n; ++i)
+		rowPtr[i+1] += rowPtr[i];
+
+	std::vector<typename SparseMatrix<T>::index_type> cols(count);
+	std::vector<T> vals(count);
+	next.assign(rowPtr.begin(), rowPtr.end()-1);
+	for(Index j = 0; j < n; ++j)
+	{
+		for(Index p = cPtr[j]; p < cPtr[j+1]; ++p)
+		{
+			const Index q = next[cRow[p]]++;
+			cols[q] = j;
+			vals[q] = cVal[p];
+		}
+	}
+
+	return SparseMatrix<T>(n, n, std::move(rowPtr), std::move(cols), std::move(vals));
+}
+
+template<typename T>
+void SparseCholesky<T>::analyze(const SparseMatrix<T>& A)
+{
+	if (A.rows() != A.columns())
+		throw NotSquareException();
+
+	mSize = A.rows();
+	mFactorized = false;
+
+	mPermutation = Symbolic::ordering(A, mOrdering);
+	mInversePermutation.resize(mSize);
+	for(Index i = 0; i < mSize; ++i)
+		mInversePermutation[mPermutation[i]] = i;
+
+	permute(A).swap(mPermuted);
+
+	mParent = Symbolic::elimination_tree(mPermuted);
+	const auto counts = Symbolic::column_counts(mPermuted, mParent);
+
+	mColumnPtr.assign(mSize+1, 0);
+	for(Index i = 0; i < mSize; ++i)
+		mColumnPtr[i+1] = mColumnPtr[i] + counts[i];
+
+	mRowIndex.resize(mColumnPtr[mSize]);
+	mValues.resize(mColumnPtr[mSize]);
+}
+
+template<typename T>
+void SparseCholesky<T>::factorize(const SparseMatrix<T>& A)
+{
+	if (mColumnPtr.empty() || A.rows() != mSize)
+	{
+		analyze(A);
+	}
+	else
+	{
+		// The symbolic factorization is only valid for the analyzed pattern
+		SparseMatrix<T> permuted = permute(A);
+		if (permuted.filled_count() != mPermuted.filled_count() ||
+			!std::equal(permuted.row_ptr(), permuted.row_ptr() + mSize + 1, mPermuted.row_ptr()) ||
+			!std::equal(permuted.column_ptr(), permuted.column_ptr() + permuted.filled_count(), mPermuted.column_ptr()))
+			throw PatternMismatchException();
+
+		permuted.swap(mPermuted);
+	}
+
+	numeric();
+}
+
+template<typename T>
+void SparseCholesky<T>::numeric()
+{
+	mFactorized = false;
+
+	const Index n = mSize;
+	const auto* cRow = mPermuted.row_ptr();
+	const auto* cCol = mPermuted.column_ptr();
+	const T* cVal = mPermuted.value_ptr();
+
+	std::vector<Index> next(mColumnPtr.begin(), mColumnPtr.end()-1);
+	std::vector<Index> stack(n);
+	std::vector<Index> mark(n, n);
+	std::vector<T> x(n, (T)0);
+
+	// Up-looking: Row k of L is the solution of L_(k-1) y = a_k
+	for(Index k = 0; k < n; ++k)
+	{
+		Index top = Symbolic::row_pattern(mPermuted, k, mParent, stack, mark);
+
+		x[k] = (T)0;
+		for(Index p = cRow[k]; p < cRow[k+1]; ++p)
+			x[cCol[p]] = complex_conj(cVal[p]);
+
+		T d = x[k];
+		x[k] = (T)0;
+
+		for(; top < n; ++top)
+		{
+			const Index i = stack[top];
+			const T lki = x[i] / mValues[mColumnPtr[i]];
+			x[i] = (T)0;
+
+			for(Index p = mColumnPtr[i] + 1; p < next[i]; ++p)
+				x[mRowIndex[p]] -= mValues[p] * lki;
+
+			d -= lki * complex_conj(lki);
+
+			const Index p = next[i]++;
+			mRowIndex[p] = k;
+			mValues[p] = complex_conj(lki);
+		}
+
+		if(!(std::real(d) > 0))
+			throw NotPositiveDefiniteException();
+
+		const Index p = next[k]++;
+		mRowIndex[p] = k;
+		mValues[p] = std::sqrt(d);
+	}
+
+	mFactorized = true;
+}
+
+template<typename T>
+void SparseCholesky<T>::compute(const SparseMatrix<T>& A)
+{
+	analyze(A);
+	numeric();
+}
+
+template<typename T>
+DynamicVector<T> SparseCholesky<T>::solve(const DynamicVector<T>& b) const
+{
+	NS_ASSERT(mFactorized);
+
+	if(b.size() != mSize)
+		throw MatrixVectorMismatchException();
+
+	const Index n = mSize;
+	std::vector<T> x(n);
+	for(Index i = 0; i < n; ++i)
+		x[i] = b[mPermutation[i]];
+
+	// L y = P b
+	for(Index j = 0; j < n; ++j)
+	{
+		const T xj = x[j] / mValues[mColumnPtr[j]];
+		x[j] = xj;
+		for(Index p = mColumnPtr[j] + 1; p < mColumnPtr[j+1]; ++p)
+			x[mRowIndex[p]] -= mValues[p] * xj;
+	}
+
+	// L^* z = y
+	for(Index j = n; j-- > 0; )
+	{
+		T s = x[j];
+		for(Index p = mColumnPtr[j] + 1; p < mColumnPtr[j+1]; ++p)
+			s -= complex_conj(mValues[p]) * x[mRowIndex[p]];
+		x[j] = s / complex_conj(mValues[mColumnPtr[j]]);
+	}
+
+	DynamicVector<T> r(n);
+	for(Index i = 0; i < n; ++i)
+		r[mPermutation[i]] = x[i];
+
+	return r;
+}
+
+template<typename T>
+SparseMatrix<T> SparseCholesky<T>::factor() const
+{
+	const Index n = mSize;
+
+	// The row offsets are bounded by the amount of entries
+	const Index count = SparseMatrix<T>::to_index(mRowIndex.size());
+	std::vector<typename SparseMatrix<T>::index_type> rowPtr(n+1, 0);
+	for(Index p = 0; p < count; ++p)
+		++rowPtr[mRowIndex[p]+1];
+	for(Index i = 0; i < n; ++i)
+		rowPtr[i+1] += rowPtr[i];
+
+	std::vector<typename SparseMatrix<T>::index_type> cols(count);
+	std::vector<T> vals(count);
+	std::vector<Index> next(rowPtr.begin(), rowPtr.end()-1);
+	for(Index j = 0; j < n; ++j)
+	{
+		for(Index p = mColumnPtr[j]; p < mColumnPtr[j+1]; ++p)
+		{
+			const Index q = next[mRowIndex[p]]++;
+			cols[q] = j;
+			vals[q] = mValues[p];
+		}
+	}
+
+	return SparseMatrix<T>(n, n, std::move(rowPtr), std::move(cols), std::move(vals));
+}
+
+template<typename T>
+const std::vector<Index>& SparseCholesky<T>::permutation() const
+{
+	return mPermutation;
+}
+
+template<typename T>
+const std::vector<Index>& SparseCholesky<T>::elimination_tree() const
+{
+	return mParent;
+}
+
+template<typename T>
+Dimension SparseCholesky<T>::size() const
+{
+	return mSize;
+}
+
+template<typename T>
+size_t SparseCholesky<T>::filled_count() const
+{
+	return mColumnPtr.empty() ? 0 : mColumnPtr.back();
+}
+
+// ----------------------------------------------
+template<typename T>
+SparseLU<T>::SparseLU(SparseOrdering order, real_type threshold) :
+	mOrdering(order), mThreshold(threshold), mSize(0)
+{
+}
+
+template<typename T>
+SparseLU<T>::SparseLU(const SparseMatrix<T>& A, SparseOrdering order, real_type threshold) :
+	mOrdering(order), mThreshold(threshold), mSize(0)
+{
+	compute(A);
+}
+
+template<typename T>
+Index SparseLU<T>::reach(const std::vector<Index>& aColPtr, const std::vector<Index>& aRowIndex, Index column,
+	std::vector<Index>& stack, std::vector<Index>& work, std::vector<bool>& mark) const
+{
+	const Index n = mSize;
+	Index* dfs = work.data();
+	Index* pos = work.data() + n;
+
+	// Non recursive depth first search through the graph of L, starting at every entry of the column
+	Index top = n;
+	for(Index p = aColPtr[column]; p < aColPtr[column+1]; ++p)
+	{
+		if(mark[aRowIndex[p]])
+			continue;
+
+		Index head = 0;
+		dfs[0] = aRowIndex[p];
+		while(true)
+		{
+			const Index j = dfs[head];
+			const Index J = mInverseRowPermutation[j];
+			if(!mark[j])
+			{
+				mark[j] = true;
+				pos[head] = J == n ? 0 : mLColumnPtr[J] + 1;
+			}
+
+			const Index end = J == n ? 0 : mLColumnPtr[J+1];
+			bool done = true;
+			for(Index q = pos[head]; q < end; ++q)
+			{
+				const Index i = mLRowIndex[q];
+				if(mark[i])
+					continue;
+
+				pos[head] = q + 1;
+				dfs[++head] = i;
+				done = false;
+				break;
+			}
+
+			if(done)
+			{
+				stack[--top] = j;
+				if(head == 0)
+					break;
+				--head;
+			}
+		}
+	}
+
+	return top;
+}
+
+template<typename T>
+void SparseLU<T>::compute(const SparseMatrix<T>& A)
+{
+	if (A.rows() != A.columns())
+		throw NotSquareException();
+
+	const Index n = A.rows();
+	mSize = n;
+
+	if(mOrdering == SO_Natural)
+		mColumnPermutation = Symbolic::ordering(A, SO_Natural);
+	else
+		mColumnPermutation = Symbolic::ordering(Symbolic::symmetric_pattern(A), mOrdering);
+
+	// CCS of A
+	const auto* aRow = A.row_ptr();
+	const auto* aCol = A.column_ptr();
+	const T* aVal = A.value_ptr();
+
+	std::vector<Index> colPtr(n+1, 0);
+	for(Index p = 0; p < aRow[n]; ++p)
+		++colPtr[aCol[p]+1];
+	for(Index i = 0; i < n; ++i)
+		colPtr[i+1] += colPtr[i];
+
+	std::vector<Index> rowIndex(aRow[n]);
+	std::vector<T> values(aRow[n]);
+	std::vector<Index> next(colPtr.begin(), colPtr.end()-1);
+	for(Index i = 0; i < n; ++i)
+	{
+		for(Index p = aRow[i]; p < aRow[i+1]; ++p)
+		{
+			const Index q = next[aCol[p]]++;
+			rowIndex[q] = i;
+			values[q] = aVal[p];
+		}
+	}
+
+	// Factorization
+	mInverseRowPermutation.assign(n, n);// n marks a not yet pivoted row
+	mLColumnPtr.assign(1, 0);
+	mLRowIndex.clear();
+	mLValues.clear();
+	mUColumnPtr.assign(1, 0);
+	mURowIndex.clear();
+	mUValues.clear();
+	mLRowIndex.reserve(2*aRow[n] + n);
+	mLValues.reserve(2*aRow[n] + n);
+	mURowIndex.reserve(2*aRow[n] + n);
+	mUValues.reserve(2*aRow[n] + n);
+
+	std::vector<T> x(n, (T)0);
+	std::vector<Index> stack(n);
+	std::vector<Index> work(2*n);
+	std::vector<bool> mark(n, false);
+	for(Index k = 0; k < n; ++k)
+	{
+		const Index col = mColumnPermutation[k];
+
+		// x = L \ A(:,col) on the reachable pattern only
+		const Index top = reach(colPtr, rowIndex, col, stack, work, mark);
+		for(Index p = colPtr[col]; p < colPtr[col+1]; ++p)
+			x[rowIndex[p]] = values[p];
+
+		for(Index t = top; t < n; ++t)
+		{
+			const Index j = stack[t];
+			const Index J = mInverseRowPermutation[j];
+			if(J == n)
+				continue;
+
+			const T xj = x[j];
+			for(Index p = mLColumnPtr[J] + 1; p < mLColumnPtr[J+1]; ++p)
+				x[mLRowIndex[p]] -= mLValues[p] * xj;
+		}
+
+		// Pivot search
+		Index pivotRow = n;
+		real_type maxValue = -1;
+		for(Index t = top; t < n; ++t)
+		{
+			const Index i = stack[t];
+			if(mInverseRowPermutation[i] == n)
+			{
+				const real_type v = std::abs(x[i]);
+				if(v > maxValue)
+				{
+					maxValue = v;
+					pivotRow = i;
+				}
+			}
+			else
+			{
+				mURowIndex.push_back(mInverseRowPermutation[i]);
+				mUValues.push_back(x[i]);
+			}
+		}
+
+		if(pivotRow == n || maxValue <= std::numeric_limits<real_type>::epsilon())
+			throw SingularException();
+
+		if(mInverseRowPermutation[col] == n && std::abs(x[col]) >= mThreshold*maxValue)
+			pivotRow = col;
+
+		const T pivot = x[pivotRow];
+		mURowIndex.push_back(k);
+		mUValues.push_back(pivot);
+		mUColumnPtr.push_back(mURowIndex.size());
+
+		mInverseRowPermutation[pivotRow] = k;
+		mLRowIndex.push_back(pivotRow);
+		mLValues.push_back((T)1);
+		for(Index t = top; t < n; ++t)
+		{
+			const Index i = stack[t];
+			if(mInverseRowPermutation[i] == n)
+			{
+				mLRowIndex.push_back(i);
+				mLValues.push_back(x[i] / pivot);
+			}
+
+			x[i] = (T)0;
+			mark[i] = false;
+		}
+		mLColumnPtr.push_back(mLRowIndex.size());
+	}
+
+	// Final row indices of L
+	for(Index p = 0; p < mLRowIndex.size(); ++p)
+		mLRowIndex[p] = mInverseRowPermutation[mLRowIndex[p]];
+
+	mRowPermutation.resize(n);
+	for(Index i = 0; i < n; ++i)
+		mRowPermutation[mInverseRowPermutation[i]] = i;
+}
+
+template<typename T>
+DynamicVector<T> SparseLU<T>::solve(const DynamicVector<T>& b) const
+{
+	if(b.size() != mSize)
+		throw MatrixVectorMismatchException();
+
+	const Index n = mSize;
+	std::vector<T> x(n);
+	for(Index i = 0; i < n; ++i)
+		x[i] = b[mRowPermutation[i]];
+
+	// L y = P b
+	for(Index j = 0; j < n; ++j)
+	{
+		const T xj = x[j];
+		for(Index p = mLColumnPtr[j] + 1; p < mLColumnPtr[j+1]; ++p)
+			x[mLRowIndex[p]] -= mLValues[p] * xj;
+	}
+
+	// U z = y
+	for(Index j = n; j-- > 0; )
+	{
+		const Index diag = mUColumnPtr[j+1] - 1;
+		const T xj = x[j] / mUValues[diag];
+		x[j] = xj;
+		for(Index p = mUColumnPtr[j]; p < diag; ++p)
+			x[mURowIndex[p]] -= mUValues[p] * xj;
+	}
+
+	DynamicVector<T> r(n);
+	for(Index i = 0; i < n; ++i)
+		r[mColumnPermutation[i]] = x[i];
+
+	return r;
+}
+
+template<typename T>
+SparseMatrix<T> SparseLU<T>::to_crs(Dimension n, const std::vector<Index>& colPtr,
+	const std::vector<Index>& rowIndex, const std::vector<T>& values)
+{
+	// The row offsets are bounded by the amount of entries, including the cancelled ones
+	SparseMatrix<T>::to_index(rowIndex.size());
+	std::vector<typename SparseMatrix<T>::index_type> rowPtr(n+1, 0);
+	for(Index p = 0; p < rowIndex.size(); ++p)
+	{
+		if(values[p] != (T)0)
+			++rowPtr[rowIndex[p]+1];
+	}
+	for(Index i = 0; i < n; ++i)
+		rowPtr[i+1] += rowPtr[i];
+
+	std::vector<typename SparseMatrix<T>::index_type> cols(rowPtr[n]);
+	std::vector<T> vals(rowPtr[n]);
+	std::vector<Index> next(rowPtr.begin(), rowPtr.end()-1);
+	for(Index j = 0; j < n; ++j)
+	{
+		for(Index p = colPtr[j]; p < colPtr[j+1]; ++p)
+		{
+			if(values[p] == (T)0)
+				continue;
+
+			const Index q = next[rowIndex[p]]++;
+			cols[q] = j;
+			vals[q] = values[p];
+		}
+	}
+
+	return SparseMatrix<T>(n, n, std::move(rowPtr), std::move(cols), std::move(vals));
+}
+
+template<typename T>
+SparseMatrix<T> SparseLU<T>::lower() const
+{
+	return to_crs(mSize, mLColumnPtr, mLRowIndex, mLValues);
+}
+
+template<typename T>
+SparseMatrix<T> SparseLU<T>::upper() const
+{
+	return to_crs(mSize, mUColumnPtr, mURowIndex, mUValues);
+}
+
+template<typename T>
+const std::vector<Index>& SparseLU<T>::row_permutation() const
+{
+	return mRowPermutation;
+}
+
+template<typename T>
+const std::vector<Index>& SparseLU<T>::column_permutation() const
+{
+	return mColumnPermutation;
+}
+
+template<typename T>
+Dimension SparseLU<T>::size() const
+{
+	return mSize;
+}
+
+template<typename T>
+size_t SparseLU<T>::filled_count() const
+{
+	return mLRowIndex.size() + mURowIndex.size();
+}
+
+NS_END_NAMESPACE
\ No newline at end of file
@@ -481,6 +481,20 @@ public:
 	*/
 	void linear_set(Index i, const T& val);
 
+	/**
+	* @brief Direct access to the row major array with size() entries.
+	* @details The entry \f$ A_{ij} \f$ is at `data()[i*D2 + j]`.
+	* @par Complexity
+	* Always: \f$ O(1) \f$
+	* @sa linear_at
+	*/
+	const T* data() const;
+
+	/**
+	* @copydoc data() const
+	*/
+	T* data();
+
 	/**
 	* @brief Returns true if the entry at the respective location has a value different then 0.
 	* @details Same as `at(i,j) != 0`
@@ -174,6 +174,18 @@ void BaseMatrix<T,DC>::linear_set(Index i, const T& v)
 	mValues.Container[i] = v;
 }
 
+template<typename T, class DC>
+const T* BaseMatrix<T,DC>::data() const
+{
+	return mValues.Container.data();
+}
+
+template<typename T, class DC>
+T* BaseMatrix<T,DC>::data()
+{
+	return mValues.Container.data();
+}
+
 template<typename T, class DC>
 bool BaseMatrix<T,DC>::has(Index i1, Index i2) const
 {
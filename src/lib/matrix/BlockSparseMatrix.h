@@ -0,0 +1,306 @@
+#pragma once
+
+#include "Types.h"
+#include "Vector.h"
+#include "Utils.h"
+#include "Exceptions.h"
+
+#include "FixedMatrix.h"
+
+#include <algorithm>
+
+NS_BEGIN_NAMESPACE
+
+/**
+ * @brief A sparse matrix built out of dense BxB blocks.
+ * @details Internally it uses the BSR (Block Compressed Row Storage) method.
+ * Only one column index is stored per block instead of per entry,
+ * which reduces the index storage by \f$ B^2 \f$ compared to SparseMatrix.\n
+ * Matrices of vector valued problems, like linear elasticity or coupled systems,
+ * where every node carries B degrees of freedom, fit naturally into this format.\n
+ * The values of a block are stored row by row and contiguous,
+ * which allows the matrix vector multiplication to use small dense kernels.
+ *
+ * @par Topological Order
+ * The blocks are ordered from left to right, and then from top to down.\n
+ * \f$A_{ij}\f$ is the scalar entry at the row `i` and column `j`,
+ * and is part of the block at block row `i/B` and block column `j/B`.
+ *
+ * @note All complexity values are calculated with all operations of T assumed to be of \f$ O(1) \f$ complexity.\n
+ * NB is the amount of filled blocks.
+ *
+ * @tparam T Internal data type.
+ * @tparam B Size of the square blocks.
+ * @sa SparseMatrix
+ */
+template<typename T, Dimension B>
+class BlockSparseMatrix
+{
+	static_assert(B > 0, "Block size has to be greater than 0.");
+
+public:
+	/**
+	* @brief A typedef of the underlying value type.
+	*/
+	typedef T value_type;
+
+	/**
+	* @brief A typedef of the index type used in the BSR arrays.
+	*/
+	typedef Index index_type;
+
+	/**
+	* @brief A typedef of a single block.
+	*/
+	typedef FixedMatrix<T, B, B> block_type;
+
+	/**
+	* @brief Size of the square blocks.
+	*/
+	static constexpr Dimension BlockSize = B;
+
+private:
+	std::vector<T> mValues;// B*B entries per block
+	std::vector<index_type> mColumnPtr;
+	std::vector<index_type> mRowPtr;// BD1+1 entries, the last one is the amount of filled blocks
+
+	Dimension mBlockColumnCount;
+
+	bool find_block(Index bi, Index bj, Index& pos) const;
+	Index insert_block(Index bi, Index bj);
+
+public:
+	/**
+	* @brief Constructs an empty block sparse matrix of zero size (Not useful)
+	*/
+	BlockSparseMatrix();
+
+	/**
+	* @brief Constructs an empty block sparse matrix of size(bd1*B,bd2*B)
+	* @param bd1 Block row dimension
+	* @param bd2 Block column dimension
+	* @param expected How much blocks are expected. Gives performance benefits if known. Keep it 0 if unknown.
+	*/
+	BlockSparseMatrix(Dimension bd1, Dimension bd2, size_t expected = 0);
+
+	/**
+	* @brief Constructs a block sparse matrix directly from BSR arrays.
+	* @details The blocks of block row `i` are at the positions `[rowPtr[i], rowPtr[i+1])`
+	* in columnPtr. The entries of block `p` are at `[p*B*B, (p+1)*B*B)` in values, row by row.\n
+	* The block column indices of every block row have to be sorted.
+	* @param bd1 Block row dimension
+	* @param bd2 Block column dimension
+	* @param rowPtr Block row offsets with bd1+1 entries.
+	* @param columnPtr Block column index of every block.
+	* @param values Entries of every block.
+	*/
+	BlockSparseMatrix(Dimension bd1, Dimension bd2,
+		std::vector<index_type>&& rowPtr, std::vector<index_type>&& columnPtr, std::vector<T>&& values);
+
+	virtual ~BlockSparseMatrix();
+
+	/**
+	* @brief Returns a copy of the scalar value at the respective location.
+	* @par Complexity
+	* Worst case: \f$ O(\log BD2) \f$
+	* @param i Index of the row.
+	* @param j Index of the column.
+	* @return Copy of the value at \f$ A_{ij} \f$
+	*/
+	T at(Index i, Index j) const;
+
+	/**
+	* @brief Returns a copy of the block at the respective block location.
+	* @par Complexity
+	* Worst case: \f$ O(\log BD2 + B^2) \f$
+	* @param bi Index of the block row.
+	* @param bj Index of the block column.
+	* @return Copy of the block, or a zero block if not filled.
+	*/
+	block_type block(Index bi, Index bj) const;
+
+	/**
+	* @brief Returns true if the block at the respective block location is filled.
+	* @par Complexity
+	* Worst case: \f$ O(\log BD2) \f$
+	* @param bi Index of the block row.
+	* @param bj Index of the block column.
+	*/
+	bool has_block(Index bi, Index bj) const;
+
+	/**
+	* @brief Sets the block at the respective block location.
+	* @par Complexity
+	* Worst case: \f$ O(NB*B^2) \f$\n
+	* If the block already exists then \f$ O(\log BD2 + B^2) \f$
+	* @param bi Index of the block row.
+	* @param bj Index of the block column.
+	* @param val New block replacing the old one.
+	* @note Unlike SparseMatrix::set a zero block is kept as filled block.
+	*/
+	void set_block(Index bi, Index bj, const block_type& val);
+
+	/**
+	* @brief Adds the block to the block at the respective block location.
+	* @details Useful for the assembly of element matrices.
+	* @par Complexity
+	* Worst case: \f$ O(NB*B^2) \f$\n
+	* If the block already exists then \f$ O(\log BD2 + B^2) \f$
+	* @param bi Index of the block row.
+	* @param bj Index of the block column.
+	* @param val Block to add.
+	*/
+	void add_block(Index bi, Index bj, const block_type& val);
+
+	/**
+	* @brief Multiplies entries with a scalar.
+	* @par Complexity
+	* Always: \f$ O(NB*B^2) \f$
+	* @param f Scalar.
+	* @return A reference to this matrix.
+	*/
+	BlockSparseMatrix& operator *=(const T& f);
+
+	/**
+	* @brief The scalar column count
+	* @par Complexity
+	* Always: \f$ O(1) \f$
+	* @return BD2*B
+	*/
+	Dimension columns() const;
+
+	/**
+	* @brief The scalar row count
+	* @par Complexity
+	* Always: \f$ O(1) \f$
+	* @return BD1*B
+	*/
+	Dimension rows() const;
+
+	/**
+	* @brief The linear scalar dimension of the matrix.
+	* @par Complexity
+	* Always: \f$ O(1) \f$
+	* @return rows()*columns()
+	*/
+	Dimension size() const;
+
+	/**
+	* @brief The block column count
+	* @par Complexity
+	* Always: \f$ O(1) \f$
+	* @return BD2
+	*/
+	Dimension block_columns() const;
+
+	/**
+	* @brief The block row count
+	* @par Complexity
+	* Always: \f$ O(1) \f$
+	* @return BD1
+	*/
+	Dimension block_rows() const;
+
+	/**
+	* @brief The amount of blocks currently filled
+	* @par Complexity
+	* Always: \f$ O(1) \f$
+	* @return NB
+	*/
+	Dimension block_filled_count() const;
+
+	/**
+	* @brief The amount of scalar entries stored in the filled blocks, including zeros inside the blocks.
+	* @par Complexity
+	* Always: \f$ O(1) \f$
+	* @return NB*B*B
+	*/
+	Dimension filled_count() const;
+
+	/**
+	* @brief Swaps the entries of the matrices.
+	* @par Complexity
+	* Always: \f$ O(1) \f$
+	* @param m The other matrix.
+	*/
+	void swap(BlockSparseMatrix& m);
+
+	/**
+	* @brief Direct access to the BSR value array with filled_count() entries.
+	* @par Complexity
+	* Always: \f$ O(1) \f$
+	*/
+	const T* value_ptr() const;
+
+	/**
+	* @copydoc value_ptr() const
+	*/
+	T* value_ptr();
+
+	/**
+	* @brief Direct access to the BSR block column indices with block_filled_count() entries.
+	* @par Complexity
+	* Always: \f$ O(1) \f$
+	*/
+	const index_type* column_ptr() const;
+
+	/**
+	* @brief Direct access to the BSR block row offsets with block_rows()+1 entries.
+	* @details The blocks of block row `i` are at `[row_ptr()[i], row_ptr()[i+1])`.
+	* @par Complexity
+	* Always: \f$ O(1) \f$
+	*/
+	const index_type* row_ptr() const;
+
+	/**
+	* @brief Transpose matrix.
+	* @par Complexity
+	* Always: \f$ O(BD1+BD2+NB*B^2) \f$
+	* @return Transpose of the matrix \f$ A^T \f$
+	* @sa adjugate()
+	*/
+	BlockSparseMatrix transpose() const;
+
+	/**
+	* @brief The adjugate / conjugate transpose of the matrix.
+	* @note If the matrix has no complex entries, it is the same as transpose().
+	* @par Complexity
+	* Always: \f$ O(BD1+BD2+NB*B^2) \f$
+	* @return Conjugate transpose of the matrix \f$ A^* \f$
+	* @sa transpose()
+	*/
+	BlockSparseMatrix adjugate() const;
+
+	/**
+	* @brief Right side matrix vector multiplication.
+	* @details Every block row is accumulated with a dense BxB kernel.
+	* @par Complexity
+	* Always: \f$ O(BD1+NB*B^2) \f$
+	* @param right A vector with the same size as the column count of the matrix.
+	* @return A vector with the same size as the row count.
+	*/
+	template<typename DC>
+	DynamicVector<T> mul(const Vector<T,DC>& right) const;
+
+	/**
+	* @brief Left side matrix vector multiplication.
+	* @par Complexity
+	* Always: \f$ O(BD1+BD2+NB*B^2) \f$
+	* @param left A vector with the same size as the row count of the matrix.
+	* @return A vector with the same size as the column count.
+	*/
+	template<typename DC>
+	DynamicVector<T> mul_left(const Vector<T,DC>& left) const;
+};
+
+// Comparison
+template<typename T, Dimension B>
+bool operator ==(const BlockSparseMatrix<T,B>& v1, const BlockSparseMatrix<T,B>& v2);
+template<typename T, Dimension B>
+bool operator !=(const BlockSparseMatrix<T,B>& v1, const BlockSparseMatrix<T,B>& v2);
+
+NS_END_NAMESPACE
+
+#define _NS_BLOCKSPARSEMATRIX_INL
+# include "BlockSparseMatrix.inl"
+#undef _NS_BLOCKSPARSEMATRIX_INL
\ No newline at end of file
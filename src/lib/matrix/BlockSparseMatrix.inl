@@ -0,0 +1,382 @@
+#ifndef _NS_BLOCKSPARSEMATRIX_INL
+# error BlockSparseMatrix.inl should only be included by BlockSparseMatrix.h
+#endif
+
+NS_BEGIN_NAMESPACE
+
+template<typename T, Dimension B>
+constexpr Dimension BlockSparseMatrix<T,B>::BlockSize;
+
+template<typename T, Dimension B>
+BlockSparseMatrix<T,B>::BlockSparseMatrix() :
+	mValues(), mColumnPtr(), mRowPtr(1, 0), mBlockColumnCount(0)
+{
+	static_assert(is_number<T>::value, "Type T has to be a number.\nAllowed are std::complex and the types allowed by std::is_floating_point.");
+}
+
+template<typename T, Dimension B>
+BlockSparseMatrix<T,B>::BlockSparseMatrix(Dimension bd1, Dimension bd2, size_t expected) :
+	mValues(), mColumnPtr(), mRowPtr(bd1+1, 0), mBlockColumnCount(bd2)
+{
+	NS_ASSERT(bd1 > 0);
+	NS_ASSERT(bd2 > 0);
+	static_assert(is_number<T>::value, "Type T has to be a number.\nAllowed are std::complex and the types allowed by std::is_floating_point.");
+
+	if (expected > 0)
+	{
+		mValues.reserve(expected*B*B);
+		mColumnPtr.reserve(expected);
+	}
+}
+
+template<typename T, Dimension B>
+BlockSparseMatrix<T,B>::BlockSparseMatrix(Dimension bd1, Dimension bd2,
+	std::vector<index_type>&& rowPtr, std::vector<index_type>&& columnPtr, std::vector<T>&& values) :
+	mValues(std::move(values)), mColumnPtr(std::move(columnPtr)), mRowPtr(std::move(rowPtr)), mBlockColumnCount(bd2)
+{
+	NS_ASSERT(bd1 > 0);
+	NS_ASSERT(bd2 > 0);
+	NS_ASSERT(mRowPtr.size() == bd1+1);
+	NS_ASSERT(mColumnPtr.size()*B*B == mValues.size());
+	NS_ASSERT(mRowPtr.back() == mColumnPtr.size());
+	static_assert(is_number<T>::value, "Type T has to be a number.\nAllowed are std::complex and the types allowed by std::is_floating_point.");
+}
+
+template<typename T, Dimension B>
+BlockSparseMatrix<T,B>::~BlockSparseMatrix()
+{
+}
+
+/*
+ Only for internal use.
+ Returns the position of the block, or the position it has to be inserted at.
+ */
+template<typename T, Dimension B>
+bool BlockSparseMatrix<T,B>::find_block(Index bi, Index bj, Index& pos) const
+{
+	NS_ASSERT(bi < block_rows());
+	NS_ASSERT(bj < block_columns());
+
+	const auto first = mColumnPtr.begin() + mRowPtr[bi];
+	const auto last = mColumnPtr.begin() + mRowPtr[bi + 1];
+	const auto it = std::lower_bound(first, last, (index_type)bj);
+
+	pos = it - mColumnPtr.begin();
+	return it != last && *it == bj;
+}
+
+template<typename T, Dimension B>
+Index BlockSparseMatrix<T,B>::insert_block(Index bi, Index bj)
+{
+	Index pos;
+	if (find_block(bi, bj, pos))
+		return pos;
+
+	mColumnPtr.insert(mColumnPtr.begin() + pos, bj);
+	mValues.insert(mValues.begin() + pos*B*B, B*B, (T)0);
+
+	for (Index i = bi + 1; i < mRowPtr.size(); ++i)
+		++mRowPtr[i];
+
+	return pos;
+}
+
+template<typename T, Dimension B>
+T BlockSparseMatrix<T,B>::at(Index i, Index j) const
+{
+	Index pos;
+	if (!find_block(i / B, j / B, pos))
+		return (T)0;
+
+	return mValues[pos*B*B + (i % B)*B + (j % B)];
+}
+
+template<typename T, Dimension B>
+typename BlockSparseMatrix<T,B>::block_type BlockSparseMatrix<T,B>::block(Index bi, Index bj) const
+{
+	block_type res;
+
+	Index pos;
+	if (find_block(bi, bj, pos))
+		std::copy(mValues.begin() + pos*B*B, mValues.begin() + (pos + 1)*B*B, res.data());
+	else
+		std::fill(res.data(), res.data() + B*B, (T)0);
+
+	return res;
+}
+
+template<typename T, Dimension B>
+bool BlockSparseMatrix<T,B>::has_block(Index bi, Index bj) const
+{
+	Index pos;
+	return find_block(bi, bj, pos);
+}
+
+template<typename T, Dimension B>
+void BlockSparseMatrix<T,B>::set_block(Index bi, Index bj, const block_type& val)
+{
+	const Index pos = insert_block(bi, bj);
+	std::copy(val.data(), val.data() + B*B, mValues.begin() + pos*B*B);
+}
+
+template<typename T, Dimension B>
+void BlockSparseMatrix<T,B>::add_block(Index bi, Index bj, const block_type& val)
+{
+	const Index pos = insert_block(bi, bj);
+
+	const T* src = val.data();
+	T* dst = &mValues[pos*B*B];
+	for (Index k = 0; k < B*B; ++k)
+		dst[k] += src[k];
+}
+
+template<typename T, Dimension B>
+BlockSparseMatrix<T,B>& BlockSparseMatrix<T,B>::operator *=(const T& f)
+{
+	for (T& v : mValues)
+		v *= f;
+
+	return *this;
+}
+
+template<typename T, Dimension B>
+Dimension BlockSparseMatrix<T,B>::columns() const
+{
+	return mBlockColumnCount*B;
+}
+
+template<typename T, Dimension B>
+Dimension BlockSparseMatrix<T,B>::rows() const
+{
+	return (mRowPtr.size() - 1)*B;
+}
+
+template<typename T, Dimension B>
+Dimension BlockSparseMatrix<T,B>::size() const
+{
+	return rows()*columns();
+}
+
+template<typename T, Dimension B>
+Dimension BlockSparseMatrix<T,B>::block_columns() const
+{
+	return mBlockColumnCount;
+}
+
+template<typename T, Dimension B>
+Dimension BlockSparseMatrix<T,B>::block_rows() const
+{
+	return mRowPtr.size() - 1;
+}
+
+template<typename T, Dimension B>
+Dimension BlockSparseMatrix<T,B>::block_filled_count() const
+{
+	return mColumnPtr.size();
+}
+
+template<typename T, Dimension B>
+Dimension BlockSparseMatrix<T,B>::filled_count() const
+{
+	return mValues.size();
+}
+
+template<typename T, Dimension B>
+void BlockSparseMatrix<T,B>::swap(BlockSparseMatrix<T,B>& m)
+{
+	mValues.swap(m.mValues);
+	mColumnPtr.swap(m.mColumnPtr);
+	mRowPtr.swap(m.mRowPtr);
+	std::swap(mBlockColumnCount, m.mBlockColumnCount);
+}
+
+template<typename T, Dimension B>
+const T* BlockSparseMatrix<T,B>::value_ptr() const
+{
+	return mValues.data();
+}
+
+template<typename T, Dimension B>
+T* BlockSparseMatrix<T,B>::value_ptr()
+{
+	return mValues.data();
+}
+
+template<typename T, Dimension B>
+const typename BlockSparseMatrix<T,B>::index_type* BlockSparseMatrix<T,B>::column_ptr() const
+{
+	return mColumnPtr.data();
+}
+
+template<typename T, Dimension B>
+const typename BlockSparseMatrix<T,B>::index_type* BlockSparseMatrix<T,B>::row_ptr() const
+{
+	return mRowPtr.data();
+}
+
+template<typename T, Dimension B>
+BlockSparseMatrix<T,B> BlockSparseMatrix<T,B>::transpose() const
+{
+	const Index n = block_rows();
+	const Index m = block_columns();
+
+	// Counting sort by block column, as in SparseMatrix::transpose
+	std::vector<index_type> rowPtr(m + 1, 0);
+	for (Index p = 0; p < mColumnPtr.size(); ++p)
+		++rowPtr[mColumnPtr[p] + 1];
+	for (Index j = 0; j < m; ++j)
+		rowPtr[j + 1] += rowPtr[j];
+
+	std::vector<index_type> columnPtr(mColumnPtr.size());
+	std::vector<T> values(mValues.size());
+	std::vector<index_type> next(rowPtr.begin(), rowPtr.end() - 1);
+	for (Index i = 0; i < n; ++i)
+	{
+		for (Index p = mRowPtr[i]; p < mRowPtr[i + 1]; ++p)
+		{
+			const Index q = next[mColumnPtr[p]]++;
+			columnPtr[q] = i;
+
+			// The block itself has to be transposed too
+			const T* src = &mValues[p*B*B];
+			T* dst = &values[q*B*B];
+			for (Index r = 0; r < B; ++r)
+				for (Index c = 0; c < B; ++c)
+					dst[c*B + r] = src[r*B + c];
+		}
+	}
+
+	return BlockSparseMatrix<T,B>(m, n, std::move(rowPtr), std::move(columnPtr), std::move(values));
+}
+
+template<typename T, Dimension B>
+BlockSparseMatrix<T,B> BlockSparseMatrix<T,B>::adjugate() const
+{
+	BlockSparseMatrix<T,B> tmp = transpose();
+
+	for (T& v : tmp.mValues)
+		v = complex_conj(v);
+
+	return tmp;
+}
+
+template<typename T, Dimension B>
+template<typename DC>
+DynamicVector<T> BlockSparseMatrix<T,B>::mul(const Vector<T,DC>& v) const
+{
+	if (columns() != v.size())
+		throw MatrixMulMismatchException();
+
+	DynamicVector<T> r;
+	r.resize(rows());
+
+	T s[B];
+	T x[B];
+	for (Index i = 0; i < block_rows(); ++i)// O(BD1)
+	{
+		std::fill(s, s + B, (T)0);
+		for (Index p = mRowPtr[i]; p < mRowPtr[i + 1]; ++p)
+		{
+			const Index c = mColumnPtr[p]*B;
+			for (Index l = 0; l < B; ++l)
+				x[l] = v[c + l];
+
+			// B is known at compile time, which lets the compiler unroll and vectorize this
+			const T* a = &mValues[p*B*B];
+			for (Index k = 0; k < B; ++k)
+				for (Index l = 0; l < B; ++l)
+					s[k] += a[k*B + l] * x[l];
+		}
+
+		for (Index k = 0; k < B; ++k)
+			r[i*B + k] = s[k];
+	}
+
+	return r;
+}
+
+template<typename T, Dimension B>
+template<typename DC>
+DynamicVector<T> BlockSparseMatrix<T,B>::mul_left(const Vector<T,DC>& v) const
+{
+	if (rows() != v.size())
+		throw MatrixMulMismatchException();
+
+	DynamicVector<T> r;
+	r.resize(columns());
+
+	T x[B];
+	for (Index i = 0; i < block_rows(); ++i)// O(BD1)
+	{
+		for (Index k = 0; k < B; ++k)
+			x[k] = v[i*B + k];
+
+		for (Index p = mRowPtr[i]; p < mRowPtr[i + 1]; ++p)
+		{
+			const Index c = mColumnPtr[p]*B;
+			const T* a = &mValues[p*B*B];
+			for (Index l = 0; l < B; ++l)
+			{
+				T s = (T)0;
+				for (Index k = 0; k < B; ++k)
+					s += a[k*B + l] * x[k];
+				r[c + l] += s;
+			}
+		}
+	}
+
+	return r;
+}
+
+template<typename T, Dimension B>
+bool operator ==(const BlockSparseMatrix<T,B>& v1, const BlockSparseMatrix<T,B>& v2)
+{
+	if (v1.block_rows() != v2.block_rows() || v1.block_columns() != v2.block_columns())
+		return false;
+
+	const auto is_zero = [](const T* a)
+	{
+		return std::all_of(a, a + B*B, [](const T& v) { return v == (T)0; });
+	};
+
+	// Merge every block row, blocks only present in one of the matrices have to be zero
+	for (Index i = 0; i < v1.block_rows(); ++i)
+	{
+		Index p1 = v1.row_ptr()[i];
+		Index p2 = v2.row_ptr()[i];
+		const Index e1 = v1.row_ptr()[i + 1];
+		const Index e2 = v2.row_ptr()[i + 1];
+		while (p1 < e1 || p2 < e2)
+		{
+			if (p2 >= e2 || (p1 < e1 && v1.column_ptr()[p1] < v2.column_ptr()[p2]))
+			{
+				if (!is_zero(v1.value_ptr() + p1*B*B))
+					return false;
+				++p1;
+			}
+			else if (p1 >= e1 || v2.column_ptr()[p2] < v1.column_ptr()[p1])
+			{
+				if (!is_zero(v2.value_ptr() + p2*B*B))
+					return false;
+				++p2;
+			}
+			else
+			{
+				if (!std::equal(v1.value_ptr() + p1*B*B, v1.value_ptr() + (p1 + 1)*B*B, v2.value_ptr() + p2*B*B))
+					return false;
+				++p1;
+				++p2;
+			}
+		}
+	}
+
+	return true;
+}
+
+template<typename T, Dimension B>
+bool operator !=(const BlockSparseMatrix<T,B>& v1, const BlockSparseMatrix<T,B>& v2)
+{
+	return !(v1 == v2);
+}
+
+NS_END_NAMESPACE
\ No newline at end of file
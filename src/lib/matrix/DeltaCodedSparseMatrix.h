@@ -0,0 +1,155 @@
+#pragma once
+
+#include "Types.h"
+#include "Vector.h"
+#include "Utils.h"
+#include "Exceptions.h"
+#include "Parallel.h"
+
+#include "SparseMatrix.h"
+
+NS_BEGIN_NAMESPACE
+
+/**
+ * @brief A read-only sparse matrix with compressed column indices.
+ * @details The column indices of every row are stored as differences to the previous column,
+ * coded as variable length integers with 7 bits per byte.
+ * The first column of a row is stored relative to the row itself, which makes it small for banded matrices.\n
+ * Matrices from meshes and stencils most of the time need only one byte per entry,
+ * instead of four bytes with SparseMatrix, or eight bytes with `BasicSparseMatrix<T,uint64>`.
+ * This is useful for very large matrices, where the matrix vector multiplication is bound by memory bandwidth.\n
+ * The indices are decoded on the fly in mul().
+ * Only the offsets of every block of BlockSize rows are stored, so a row has to be found by decoding its block.\n
+ * The matrix is created from a SparseMatrix and is meant for repeated matrix vector multiplications, like in CG or Iterative.
+ *
+ * @note All complexity values are calculated with all operations of T assumed to be of \f$ O(1) \f$ complexity.\n
+ * N is the amount of filled entries.
+ *
+ * @tparam T Internal data type.
+ * @sa SparseMatrix
+ */
+template<typename T>
+class DeltaCodedSparseMatrix
+{
+private:
+	std::vector<T> mValues;
+	std::vector<uint8> mIndices;// Per row: entry count, first column, column differences - 1
+	std::vector<Index> mBlockBytePtr;// Blocks+1 entries
+	std::vector<Index> mBlockValuePtr;// Blocks+1 entries
+
+	Dimension mRowCount;
+	Dimension mColumnCount;
+
+	static void encode(std::vector<uint8>& bytes, uint64 v);
+	static uint64 decode(const uint8*& p);
+	static Index decode_first(const uint8*& p, Index row);
+
+public:
+	/**
+	* @brief A typedef of the underlying value type.
+	*/
+	typedef T value_type;
+
+	/**
+	* @brief Amount of rows in every block.
+	*/
+	static constexpr Dimension BlockSize = 64;
+
+	/**
+	* @brief Constructs the matrix from a sparse matrix with any index type.
+	* @par Complexity
+	* Always: \f$ O(D1+N) \f$
+	* @param m The sparse matrix.
+	*/
+	template<typename I>
+	explicit DeltaCodedSparseMatrix(const BasicSparseMatrix<T,I>& m);
+
+	virtual ~DeltaCodedSparseMatrix();
+
+	/**
+	* @brief Returns a copy of the value at the respective location.
+	* @par Complexity
+	* Worst case: \f$ O(BlockSize*D2) \f$
+	* @param i Index of the row.
+	* @param j Index of the column.
+	* @return Copy of the value at \f$ A_{ij} \f$
+	*/
+	T at(Index i, Index j) const;
+
+	/**
+	* @brief The column count
+	* @par Complexity
+	* Always: \f$ O(1) \f$
+	* @return D2
+	*/
+	Dimension columns() const;
+
+	/**
+	* @brief The row count
+	* @par Complexity
+	* Always: \f$ O(1) \f$
+	* @return D1
+	*/
+	Dimension rows() const;
+
+	/**
+	* @brief The amount of stored entries.
+	* @par Complexity
+	* Always: \f$ O(1) \f$
+	*/
+	Dimension filled_count() const;
+
+	/**
+	* @brief The amount of bytes used by the coded column indices, including the row lengths.
+	* @details Compare it to `filled_count()*sizeof(index_type)` of SparseMatrix to see the saving.
+	* @par Complexity
+	* Always: \f$ O(1) \f$
+	*/
+	Dimension index_bytes() const;
+
+	/**
+	* @brief Decodes the matrix back into a sparse matrix.
+	* @par Complexity
+	* Always: \f$ O(D1+N) \f$
+	* @tparam I Index type of the returned sparse matrix.
+	* @throw IndexOverflowException if the matrix does not fit into I.
+	*/
+	template<typename I = uint32>
+	BasicSparseMatrix<T,I> decompress() const;
+
+	/**
+	* @brief The adjugate / conjugate transpose of the matrix.
+	* @par Complexity
+	* Always: \f$ O(D1+D2+N) \f$
+	* @return Conjugate transpose of the matrix \f$ A^* \f$
+	*/
+	DeltaCodedSparseMatrix adjugate() const;
+
+	/**
+	* @brief Right side matrix vector multiplication.
+	* @details The blocks of rows are distributed over multiple threads if the matrix has at least
+	* Parallel::SerialThreshold filled entries.
+	* @par Complexity
+	* Always: \f$ O(D1+N) \f$
+	* @param right A vector with the same size as the column count of the matrix.
+	* @param threads Amount of threads to use. 0 uses Parallel::thread_count().
+	* @return A vector with the same size as the row count.
+	*/
+	template<typename DC>
+	DynamicVector<T> mul(const Vector<T,DC>& right, size_t threads = 0) const;
+
+	template<typename U>
+	friend bool operator ==(const DeltaCodedSparseMatrix<U>& v1, const DeltaCodedSparseMatrix<U>& v2);
+};
+
+// Comparison
+template<typename T>
+bool operator ==(const DeltaCodedSparseMatrix<T>& v1, const DeltaCodedSparseMatrix<T>& v2);
+template<typename T>
+bool operator !=(const DeltaCodedSparseMatrix<T>& v1, const DeltaCodedSparseMatrix<T>& v2);
+
+NS_END_NAMESPACE
+
+#define _NS_DELTACODEDSPARSEMATRIX_INL
+# include "DeltaCodedSparseMatrix.inl"
+#undef _NS_DELTACODEDSPARSEMATRIX_INL
\ No newline at end of file
@@ -0,0 +1,259 @@
+#ifndef _NS_DELTACODEDSPARSEMATRIX_INL
+# error DeltaCodedSparseMatrix.inl should only be included by DeltaCodedSparseMatrix.h
+#endif
+
+NS_BEGIN_NAMESPACE
+
+template<typename T>
+constexpr Dimension DeltaCodedSparseMatrix<T>::BlockSize;
+
+/*
+ Only for internal use.
+ 7 bits per byte, the highest bit marks a following byte.
+ */
+template<typename T>
+void DeltaCodedSparseMatrix<T>::encode(std::vector<uint8>& bytes, uint64 v)
+{
+	while (v >= 0x80)
+	{
+		bytes.push_back((uint8)(v | 0x80));
+		v >>= 7;
+	}
+	bytes.push_back((uint8)v);
+}
+
+template<typename T>
+uint64 DeltaCodedSparseMatrix<T>::decode(const uint8*& p)
+{
+	uint64 v = *p++;
+	if (v < 0x80)// Most of the differences fit into one byte
+		return v;
+
+	v &= 0x7F;
+	for (uint32 shift = 7; ; shift += 7)
+	{
+		const uint8 b = *p++;
+		v |= (uint64)(b & 0x7F) << shift;
+		if (b < 0x80)
+			return v;
+	}
+}
+
+template<typename T>
+Index DeltaCodedSparseMatrix<T>::decode_first(const uint8*& p, Index row)
+{
+	// Undo the zigzag coding of the signed difference to the diagonal
+	const uint64 z = decode(p);
+	return row + (Index)((z >> 1) ^ (~(z & 1) + 1));
+}
+
+template<typename T>
+template<typename I>
+DeltaCodedSparseMatrix<T>::DeltaCodedSparseMatrix(const BasicSparseMatrix<T,I>& m) :
+	mValues(m.value_ptr(), m.value_ptr() + m.filled_count()), mRowCount(m.rows()), mColumnCount(m.columns())
+{
+	static_assert(is_number<T>::value, "Type T has to be a number.\nAllowed are std::complex and the types allowed by std::is_floating_point.");
+
+	const Index n = m.rows();
+	const I* rowPtr = m.row_ptr();
+	const I* columnPtr = m.column_ptr();
+
+	mIndices.reserve(m.filled_count() + n);
+	mBlockBytePtr.reserve(n / BlockSize + 2);
+	mBlockValuePtr.reserve(n / BlockSize + 2);
+	for (Index i = 0; i < n; ++i)
+	{
+		if (i % BlockSize == 0)
+		{
+			mBlockBytePtr.push_back(mIndices.size());
+			mBlockValuePtr.push_back(rowPtr[i]);
+		}
+
+		encode(mIndices, rowPtr[i + 1] - rowPtr[i]);
+		if (rowPtr[i + 1] == rowPtr[i])
+			continue;
+
+		// Zigzag coding of the signed difference to the diagonal
+		const int64 d = (int64)columnPtr[rowPtr[i]] - (int64)i;
+		encode(mIndices, ((uint64)d << 1) ^ (uint64)(d >> 63));
+
+		for (Index p = rowPtr[i] + 1; p < rowPtr[i + 1]; ++p)
+		{
+			NS_ASSERT(columnPtr[p] > columnPtr[p - 1]);
+			encode(mIndices, columnPtr[p] - columnPtr[p - 1] - 1);
+		}
+	}
+	mBlockBytePtr.push_back(mIndices.size());
+	mBlockValuePtr.push_back(mValues.size());
+
+	mIndices.shrink_to_fit();
+}
+
+template<typename T>
+DeltaCodedSparseMatrix<T>::~DeltaCodedSparseMatrix()
+{
+}
+
+template<typename T>
+T DeltaCodedSparseMatrix<T>::at(Index i, Index j) const
+{
+	NS_ASSERT(i < rows());
+	NS_ASSERT(j < columns());
+
+	const Index b = i / BlockSize;
+	const uint8* p = mIndices.data() + mBlockBytePtr[b];
+	Index q = mBlockValuePtr[b];
+
+	// Skip the previous rows of the block
+	for (Index r = b*BlockSize; r < i; ++r)
+	{
+		const Index count = decode(p);
+		for (Index k = 0; k < count; ++k)
+			decode(p);
+		q += count;
+	}
+
+	const Index count = decode(p);
+	if (count == 0)
+		return (T)0;
+
+	Index c = decode_first(p, i);
+	for (Index k = 0; ; ++k)
+	{
+		if (c == j)
+			return mValues[q + k];
+		else if (c > j || k + 1 == count)
+			break;
+
+		c += decode(p) + 1;
+	}
+
+	return (T)0;
+}
+
+template<typename T>
+Dimension DeltaCodedSparseMatrix<T>::columns() const
+{
+	return mColumnCount;
+}
+
+template<typename T>
+Dimension DeltaCodedSparseMatrix<T>::rows() const
+{
+	return mRowCount;
+}
+
+template<typename T>
+Dimension DeltaCodedSparseMatrix<T>::filled_count() const
+{
+	return mValues.size();
+}
+
+template<typename T>
+Dimension DeltaCodedSparseMatrix<T>::index_bytes() const
+{
+	return mIndices.size();
+}
+
+template<typename T>
+template<typename I>
+BasicSparseMatrix<T,I> DeltaCodedSparseMatrix<T>::decompress() const
+{
+	const Index n = rows();
+	if (n > std::numeric_limits<I>::max() || columns() > std::numeric_limits<I>::max() ||
+		mValues.size() > std::numeric_limits<I>::max())
+		throw IndexOverflowException();
+
+	std::vector<I> rowPtr(n + 1, 0);
+	std::vector<I> columnPtr(mValues.size());
+	std::vector<T> values(mValues);
+
+	const uint8* p = mIndices.data();
+	for (Index i = 0; i < n; ++i)
+	{
+		const Index count = decode(p);
+		rowPtr[i + 1] = rowPtr[i] + count;
+		if (count == 0)
+			continue;
+
+		Index c = decode_first(p, i);
+		columnPtr[rowPtr[i]] = c;
+		for (Index q = rowPtr[i] + 1; q < rowPtr[i + 1]; ++q)
+		{
+			c += decode(p) + 1;
+			columnPtr[q] = c;
+		}
+	}
+
+	return BasicSparseMatrix<T,I>(rows(), columns(), std::move(rowPtr), std::move(columnPtr), std::move(values));
+}
+
+template<typename T>
+DeltaCodedSparseMatrix<T> DeltaCodedSparseMatrix<T>::adjugate() const
+{
+	return DeltaCodedSparseMatrix<T>(decompress<Index>().adjugate());
+}
+
+template<typename T>
+template<typename DC>
+DynamicVector<T> DeltaCodedSparseMatrix<T>::mul(const Vector<T,DC>& v, size_t threads) const
+{
+	if (columns() != v.size())
+		throw MatrixMulMismatchException();
+
+	const Index n = rows();
+
+	DynamicVector<T> r;
+	r.resize(n);
+
+	if (mValues.size() < Parallel::SerialThreshold)
+		threads = 1;
+
+	const T* x = &v[0];
+	T* y = &r[0];
+	Parallel::for_range(0, mBlockBytePtr.size() - 1, [&](Index begin, Index end, Index)
+	{
+		for (Index b = begin; b < end; ++b)
+		{
+			const uint8* p = mIndices.data() + mBlockBytePtr[b];
+			const T* a = mValues.data() + mBlockValuePtr[b];
+
+			const Index last = std::min(n, (b + 1)*BlockSize);
+			for (Index i = b*BlockSize; i < last; ++i)
+			{
+				const Index count = decode(p);
+				T s = (T)0;
+				if (count > 0)
+				{
+					Index c = decode_first(p, i);
+					s += a[0] * x[c];
+					for (Index k = 1; k < count; ++k)
+					{
+						c += decode(p) + 1;
+						s += a[k] * x[c];
+					}
+					a += count;
+				}
+				y[i] = s;
+			}
+		}
+	}, threads);
+
+	return r;
+}
+
+template<typename T>
+bool operator ==(const DeltaCodedSparseMatrix<T>& v1, const DeltaCodedSparseMatrix<T>& v2)
+{
+	// The coding is unique, so equal matrices have equal arrays
+	return v1.mRowCount == v2.mRowCount && v1.mColumnCount == v2.mColumnCount &&
+		v1.mIndices == v2.mIndices && v1.mValues == v2.mValues;
+}
+
+template<typename T>
+bool operator !=(const DeltaCodedSparseMatrix<T>& v1, const DeltaCodedSparseMatrix<T>& v2)
+{
+	return !(v1 == v2);
+}
+
+NS_END_NAMESPACE
\ No newline at end of file
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "BaseMatrix.h"
+#include "MatrixKernel.h"
 
 NS_BEGIN_NAMESPACE
 
@@ -134,13 +135,15 @@ public:
 	* \f[
 	* A.mul(B) := A \cdot B \textrm{ with } A \in T^{D1 \times D2} \times B \in T^{D2 \times D3} \to C \in T^{D1 \times D3}
 	* \f]
+	* The product is computed by the cache blocked Kernel::gemm().
 	* @par Complexity
-	* Worst case: UNKNOWN
+	* Always: \f$ O(D1*D2*D3) \f$
 	* @param right The other matrix, which row count must match the column count of this matrix.
+	* @param threads Amount of threads to use. 0 uses Parallel::thread_count().
 	* @return The result of the matrix multiplication.
-	* @todo Complexity?
+	* @throw MatrixMulMismatchException
 	*/
-	DenseMatrix mul(const DenseMatrix& right) const;
+	DenseMatrix mul(const DenseMatrix& right, size_t threads = 0) const;
 
 	/**
 	* @brief Right side matrix vector multiplication.
@@ -157,24 +157,15 @@ DenseMatrix<T> DenseMatrix<T>::adjugate() const
 }
 
 template<typename T>
-DenseMatrix<T> DenseMatrix<T>::mul(const DenseMatrix<T>& m) const
+DenseMatrix<T> DenseMatrix<T>::mul(const DenseMatrix<T>& m, size_t threads) const
 {
 	if (this->columns() != m.rows())
 		throw MatrixMulMismatchException();
 
 	DenseMatrix<T> tmp(this->rows(), m.columns());
-	for (Index i = 0; i < this->rows(); ++i)
-	{
-		for (Index k = 0; k < m.columns(); ++k)
-		{
-			T v = 0;
-			for (Index j = 0; j < this->columns(); ++j)
-			{
-				v += this->at(i, j) * m.at(j, k);
-			}
-			tmp.set(i, k, v);
-		}
-	}
+	Kernel::gemm(this->rows(), m.columns(), this->columns(), (T)1,
+		this->data(), this->columns(), m.data(), m.columns(),
+		(T)0, tmp.data(), tmp.columns(), threads);
 	return tmp;
 }
 
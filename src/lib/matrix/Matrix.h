@@ -1,6 +1,10 @@
 #pragma once
 
 #include "matrix/SparseMatrix.h"
+#include "matrix/BlockSparseMatrix.h"
+#include "matrix/SlicedEllpackMatrix.h"
+#include "matrix/SymmetricSparseMatrix.h"
+#include "matrix/DeltaCodedSparseMatrix.h"
 #include "matrix/FixedMatrix.h"
 #include "matrix/DenseMatrix.h"
 
@@ -32,6 +36,22 @@ struct is_dynamic_matrix : std::integral_constant<bool,
 	std::is_same<DenseMatrix<T>, typename std::remove_cv<class M<T> >::type>::value ||
 		std::is_same<SparseMatrix<T>, typename std::remove_cv<class M<T> >::type>::value> {};
 
+/**
+ * @brief A std:: conform type-trait for the several dynamic matrix types.
+ * @details Unlike is_dynamic_matrix it takes the complete type,
+ * which also covers sparse matrices with a different index type like `BasicSparseMatrix<T,uint64>`.
+ * @sa is_dynamic_matrix
+ * @ingroup TypeTraits
+ */
+template<typename M>
+struct is_dynamic_matrix_type : std::false_type {};
+
+template<typename T>
+struct is_dynamic_matrix_type<DenseMatrix<T> > : std::true_type {};
+
+template<typename T, typename I>
+struct is_dynamic_matrix_type<BasicSparseMatrix<T,I> > : std::true_type {};
+
 /**
  * @brief A std:: conform type-trait for all the matrix classes.
  * @see is_dense_matrix
@@ -15,9 +15,9 @@ namespace Check
 	 * @param m Matrix to check
 	 * @return True if orthogonal, false otherwise.
 	 */
-	template<template<typename> class M, typename T>
-	typename std::enable_if<is_dynamic_matrix<M, T>::value, bool >::type
-	matrixIsOrthogonal(const M<T>& m);
+	template<class M>
+	typename std::enable_if<is_dynamic_matrix_type<M>::value, bool >::type
+	matrixIsOrthogonal(const M& m);
 
 	template<typename T, Dimension K1, Dimension K2>
 	bool matrixIsOrthogonal(const FixedMatrix<T,K1,K2>& m);
@@ -31,9 +31,9 @@ namespace Check
 	* @param m Matrix to check
 	* @return True if unitary, false otherwise.
 	*/
-	template<template<typename> class M, typename T>
-	typename std::enable_if<is_dynamic_matrix<M, T>::value, bool >::type
-	matrixIsUnitary(const M<T>& m);
+	template<class M>
+	typename std::enable_if<is_dynamic_matrix_type<M>::value, bool >::type
+	matrixIsUnitary(const M& m);
 
 	template<typename T, Dimension K1, Dimension K2>
 	bool matrixIsUnitary(const FixedMatrix<T,K1,K2>& m);
@@ -6,14 +6,25 @@ NS_BEGIN_NAMESPACE
 
 namespace Check
 {
-	template<template<typename> class M, typename T>
-	typename std::enable_if<is_dynamic_matrix<M, T>::value, bool >::type
-	matrixIsOrthogonal(const M<T>& m)
+	/* Same as Construct::eye, which can not take matrices with other template parameters like the index type. */
+	template<class M>
+	M identity(const M& m)
+	{
+		M e(m.rows(), m.columns());
+		for (Index i = 0; i < std::min(m.rows(), m.columns()); ++i)
+			e.set(i, i, (typename M::value_type)1);
+
+		return e;
+	}
+
+	template<class M>
+	typename std::enable_if<is_dynamic_matrix_type<M>::value, bool >::type
+	matrixIsOrthogonal(const M& m)
 	{
 		if (m.rows() != m.columns())// Not square
 			return false;
 
-		return (m.mul(m.transpose())) == Construct::eye<M, T>(m.rows(), m.columns());
+		return (m.mul(m.transpose())) == identity(m);
 	}
 
 	template<typename T, Dimension K>
@@ -22,14 +33,14 @@ namespace Check
 		return (m.mul(m.transpose())) == Construct::eye<T,K,K>();
 	}
 
-	template<template<typename> class M, typename T>
-	typename std::enable_if<is_dynamic_matrix<M, T>::value, bool >::type
-	matrixIsUnitary(const M<T>& m)
+	template<class M>
+	typename std::enable_if<is_dynamic_matrix_type<M>::value, bool >::type
+	matrixIsUnitary(const M& m)
 	{
 		if (m.rows() != m.columns())// Not square
 			return false;
 
-		return (m.mul(m.adjugate())) == Construct::eye<M, T>(m.rows(), m.columns());
+		return (m.mul(m.adjugate())) == identity(m);
 	}
 
 	template<typename T, Dimension K>
@@ -34,9 +34,9 @@ namespace Construct
 	* @param v A matrix.
 	* @return A new vector with the size `min(m.rows(),m.columns())` and the diagonal of the matrix as his content.
 	*/
-	template<template<typename> class M, typename T>
-	typename std::enable_if<is_dynamic_matrix<M, T>::value, DynamicVector<T> >::type
-		diag(const M<T>& m);
+	template<class M>
+	typename std::enable_if<is_dynamic_matrix_type<M>::value, DynamicVector<typename M::value_type> >::type
+		diag(const M& m);
 
 	/**
 	* @brief Returns the lower left triangle matrix of a matrix.
@@ -45,9 +45,9 @@ namespace Construct
 	* @return A new matrix with the same size as m.
 	* @sa triu
 	*/
-	template<template<typename> class M, typename T>
-	typename std::enable_if<is_dynamic_matrix<M, T>::value, M<T> >::type
-		tril(const M<T>& m, int32 k = 0);
+	template<class M>
+	typename std::enable_if<is_dynamic_matrix_type<M>::value, M>::type
+		tril(const M& m, int32 k = 0);
 
 	/**
 	* @brief Returns the upper right triangle matrix of a matrix.
@@ -56,9 +56,9 @@ namespace Construct
 	* @return A new matrix with the same size as m.
 	* @sa tril
 	*/
-	template<template<typename> class M, typename T>
-	typename std::enable_if<is_dynamic_matrix<M, T>::value, M<T> >::type
-		triu(const M<T>& m, int32 k = 0);
+	template<class M>
+	typename std::enable_if<is_dynamic_matrix_type<M>::value, M>::type
+		triu(const M& m, int32 k = 0);
 
 	/**
 	* @brief Returns the hilbert matrix.
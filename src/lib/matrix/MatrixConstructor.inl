@@ -38,11 +38,11 @@ namespace Construct
 		return m;
 	}
 
-	template<template<typename> class M, typename T>
-	typename std::enable_if<is_dynamic_matrix<M, T>::value, DynamicVector<T> >::type
-		diag(const M<T>& m)
+	template<class M>
+	typename std::enable_if<is_dynamic_matrix_type<M>::value, DynamicVector<typename M::value_type> >::type
+		diag(const M& m)
 	{
-		DynamicVector<T> v;
+		DynamicVector<typename M::value_type> v;
 		v.resize(std::min(m.rows(), m.columns()));
 
 		for (Index i = 0; i < std::min(m.rows(), m.columns()); ++i)
@@ -51,11 +51,11 @@ namespace Construct
 		return v;
 	}
 
-	template<template<typename> class M, typename T>
-	typename std::enable_if<is_dynamic_matrix<M, T>::value, M<T> >::type
-		tril(const M<T>& m, int32 k)
+	template<class M>
+	typename std::enable_if<is_dynamic_matrix_type<M>::value, M>::type
+		tril(const M& m, int32 k)
 	{
-		M<T> r(m.rows(), m.columns());
+		M r(m.rows(), m.columns());
 
 		if (k >= 0)
 		{
@@ -73,11 +73,11 @@ namespace Construct
 		return r;
 	}
 
-	template<template<typename> class M, typename T>
-	typename std::enable_if<is_dynamic_matrix<M, T>::value, M<T> >::type
-		triu(const M<T>& m, int32 k)
+	template<class M>
+	typename std::enable_if<is_dynamic_matrix_type<M>::value, M>::type
+		triu(const M& m, int32 k)
 	{
-		M<T> r(m.rows(), m.columns());
+		M r(m.rows(), m.columns());
 
 		if (k >= 0)
 		{
@@ -20,7 +20,43 @@ namespace Convert
 	* @return The new dense matrix.
 	*/
 	template<typename T>
-	DynamicMatrix<T> toDenseMatrix(const SparseMatrix<T>& m);
+	DenseMatrix<T> toDenseMatrix(const SparseMatrix<T>& m);
+
+	/**
+	* @brief Converts the entries of a sparse matrix to another precision, like double to float.
+	* @details Entries becoming zero are kept as filled entries.
+	* @param m Sparse matrix to convert.
+	* @return The new sparse matrix with the same structure.
+	*/
+	template<typename U, typename T>
+	SparseMatrix<U> toPrecision(const SparseMatrix<T>& m);
+
+	/**
+	* @brief Converts a sparse matrix to a block sparse matrix with BxB blocks.
+	* @details Every block containing at least one filled entry is stored as a full block.
+	* @param m Sparse matrix to convert. Row and column count have to be multiples of B.
+	* @return The new block sparse matrix.
+	* @throw MatrixSizeMismatchException
+	*/
+	template<Dimension B, typename T>
+	BlockSparseMatrix<T,B> toBlockSparseMatrix(const SparseMatrix<T>& m);
+
+	/**
+	* @brief Converts a block sparse matrix to a sparse matrix.
+	* @details Zero entries inside the blocks are not stored.
+	* @param m Block sparse matrix to convert.
+	* @return The new sparse matrix.
+	*/
+	template<typename T, Dimension B>
+	SparseMatrix<T> toSparseMatrix(const BlockSparseMatrix<T,B>& m);
+
+	/**
+	* @brief Converts a symmetric sparse matrix to a sparse matrix with both triangles.
+	* @param m Symmetric sparse matrix to convert.
+	* @return The new sparse matrix.
+	*/
+	template<typename T>
+	SparseMatrix<T> toSparseMatrix(const SymmetricSparseMatrix<T>& m);
 }
 
 NS_END_NAMESPACE
@@ -24,9 +24,9 @@ namespace Convert
 	}
 
 	template<typename T>
-	DynamicMatrix<T> toDenseMatrix(const SparseMatrix<T>& m)
+	DenseMatrix<T> toDenseMatrix(const SparseMatrix<T>& m)
 	{
-		Matrix<T> res(m.rows(), m.columns());
+		DenseMatrix<T> res(m.rows(), m.columns());
 		for (auto it = m.begin(); it != m.end(); ++it)
 		{
 			res.set(it.row(), it.column(), *it);
@@ -34,6 +34,135 @@ namespace Convert
 
 		return res;
 	}
+
+	template<typename U, typename T>
+	SparseMatrix<U> toPrecision(const SparseMatrix<T>& m)
+	{
+		std::vector<typename SparseMatrix<U>::index_type> rowPtr(m.row_ptr(), m.row_ptr() + m.rows() + 1);
+		std::vector<typename SparseMatrix<U>::index_type> columnPtr(m.column_ptr(), m.column_ptr() + m.filled_count());
+		std::vector<U> values(m.filled_count());
+		for (Index p = 0; p < values.size(); ++p)
+			values[p] = (U)m.value_ptr()[p];
+
+		return SparseMatrix<U>(m.rows(), m.columns(), std::move(rowPtr), std::move(columnPtr), std::move(values));
+	}
+
+	template<Dimension B, typename T>
+	BlockSparseMatrix<T,B> toBlockSparseMatrix(const SparseMatrix<T>& m)
+	{
+		if (m.rows() % B != 0 || m.columns() % B != 0)
+			throw MatrixSizeMismatchException();
+
+		const Index n = m.rows() / B;
+		const Index k = m.columns() / B;
+		const Index none = std::numeric_limits<Index>::max();
+
+		// Collect the block pattern of every block row first with a marker, as in SparseMatrix::mul
+		std::vector<Index> rowPtr(n + 1, 0);
+		std::vector<Index> columnPtr;
+		std::vector<Index> mark(k, none);
+		for (Index i = 0; i < n; ++i)
+		{
+			const Index start = columnPtr.size();
+			for (Index r = i*B; r < (i + 1)*B; ++r)
+			{
+				for (Index p = m.row_ptr()[r]; p < m.row_ptr()[r + 1]; ++p)
+				{
+					const Index j = m.column_ptr()[p] / B;
+					if (mark[j] != i)
+					{
+						mark[j] = i;
+						columnPtr.push_back(j);
+					}
+				}
+			}
+			std::sort(columnPtr.begin() + start, columnPtr.end());
+			rowPtr[i + 1] = columnPtr.size();
+		}
+
+		std::vector<T> values(columnPtr.size()*B*B, (T)0);
+		for (Index i = 0; i < n; ++i)
+		{
+			for (Index r = i*B; r < (i + 1)*B; ++r)
+			{
+				// Both the scalar row and the block row are sorted, so the block position only moves forward
+				Index q = rowPtr[i];
+				for (Index p = m.row_ptr()[r]; p < m.row_ptr()[r + 1]; ++p)
+				{
+					const Index j = m.column_ptr()[p];
+					while (columnPtr[q] != j / B)
+						++q;
+					values[q*B*B + (r % B)*B + (j % B)] = m.value_ptr()[p];
+				}
+			}
+		}
+
+		return BlockSparseMatrix<T,B>(n, k, std::move(rowPtr), std::move(columnPtr), std::move(values));
+	}
+
+	template<typename T, Dimension B>
+	SparseMatrix<T> toSparseMatrix(const BlockSparseMatrix<T,B>& m)
+	{
+		std::vector<typename SparseMatrix<T>::index_type> rowPtr(m.rows() + 1, 0);
+		std::vector<typename SparseMatrix<T>::index_type> columnPtr;
+		std::vector<T> values;
+		columnPtr.reserve(m.filled_count());
+		values.reserve(m.filled_count());
+
+		for (Index i = 0; i < m.block_rows(); ++i)
+		{
+			for (Index r = 0; r < B; ++r)
+			{
+				for (Index p = m.row_ptr()[i]; p < m.row_ptr()[i + 1]; ++p)
+				{
+					const T* a = m.value_ptr() + p*B*B + r*B;
+					for (Index l = 0; l < B; ++l)
+					{
+						if (a[l] != (T)0)
+						{
+							columnPtr.push_back(m.column_ptr()[p]*B + l);
+							values.push_back(a[l]);
+						}
+					}
+				}
+				rowPtr[i*B + r + 1] = SparseMatrix<T>::to_index(columnPtr.size());
+			}
+		}
+
+		return SparseMatrix<T>(m.rows(), m.columns(), std::move(rowPtr), std::move(columnPtr), std::move(values));
+	}
+
+	template<typename T>
+	SparseMatrix<T> toSparseMatrix(const SymmetricSparseMatrix<T>& m)
+	{
+		// The lower triangle is the adjugate of the strict upper triangle, which comes sorted by row already
+		const SparseMatrix<T>& upper = m.upper();
+		const SparseMatrix<T> lower = upper.adjugate();
+		const Index n = m.rows();
+
+		std::vector<typename SparseMatrix<T>::index_type> rowPtr(n + 1, 0);
+		std::vector<typename SparseMatrix<T>::index_type> columnPtr;
+		std::vector<T> values;
+		columnPtr.reserve(2*upper.filled_count());
+		values.reserve(2*upper.filled_count());
+
+		for (Index i = 0; i < n; ++i)
+		{
+			for (Index p = lower.row_ptr()[i]; p < lower.row_ptr()[i + 1] && lower.column_ptr()[p] < i; ++p)
+			{
+				columnPtr.push_back(lower.column_ptr()[p]);
+				values.push_back(lower.value_ptr()[p]);
+			}
+			for (Index p = upper.row_ptr()[i]; p < upper.row_ptr()[i + 1]; ++p)
+			{
+				columnPtr.push_back(upper.column_ptr()[p]);
+				values.push_back(upper.value_ptr()[p]);
+			}
+			rowPtr[i + 1] = SparseMatrix<T>::to_index(columnPtr.size());
+		}
+
+		return SparseMatrix<T>(n, n, std::move(rowPtr), std::move(columnPtr), std::move(values));
+	}
 }
 
 NS_END_NAMESPACE
\ No newline at end of file
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <algorithm>
+#include <complex>
+#include <vector>
+
+#include "nsConfig.h"
+#include "Parallel.h"
+
+NS_BEGIN_NAMESPACE
+
+/**
+ * Low level kernels working directly on row major arrays.
+ * Used by the dense matrix operations and the blocked factorizations.
+ */
+namespace Kernel
+{
+	/**
+	* @brief Block sizes of gemm() for the internal type T.
+	* @details The micro kernel computes a MR x NR block of C in registers.
+	* A MC x KC block of A is packed to stay in the L2 cache and
+	* a KC x NC panel of B is packed to stay in the L3 cache.
+	*/
+	template<typename T>
+	struct GemmBlocking
+	{
+		static constexpr Index MR = sizeof(T) > 8 ? 2 : 4;
+		static constexpr Index NR = sizeof(T) > 8 ? 4 : 32/sizeof(T);
+		static constexpr Index MC = sizeof(T) > 8 ? 64 : 128;
+		static constexpr Index KC = 256;
+		static constexpr Index NC = 4096;
+	};
+
+	/**
+	* @brief General matrix matrix multiplication \f$ C = \alpha A B + \beta C \f$.
+	* @details A is a m x k, B a k x n and C a m x n row major array with the given leading dimensions (row strides).
+	* Both A and B are packed block wise for the cache and the product is computed by a register blocked micro kernel.
+	* Small products use a simple loop instead.
+	* If beta is 0, C is not read.
+	* @param threads Amount of threads to use for the row blocks. 0 uses Parallel::thread_count().
+	* Products with less than 2^18 multiplications are computed in the calling thread.
+	* @par Complexity
+	* Always: \f$ O(m*n*k) \f$
+	*/
+	template<typename T>
+	void gemm(Index m, Index n, Index k, const T& alpha,
+		const T* A, Index lda, const T* B, Index ldb,
+		const T& beta, T* C, Index ldc, size_t threads = 0);
+}
+
+NS_END_NAMESPACE
+
+#define _NS_MATRIXKERNEL_INL
+# include "MatrixKernel.inl"
+#undef _NS_MATRIXKERNEL_INL
\ No newline at end of file
@@ -0,0 +1,195 @@
+#ifndef _NS_MATRIXKERNEL_INL
+# error MatrixKernel.inl should only be included by MatrixKernel.h
+#endif
+
+NS_BEGIN_NAMESPACE
+
+namespace Kernel
+{
+	template<typename T>
+	constexpr Index GemmBlocking<T>::MR;
+	template<typename T>
+	constexpr Index GemmBlocking<T>::NR;
+	template<typename T>
+	constexpr Index GemmBlocking<T>::MC;
+	template<typename T>
+	constexpr Index GemmBlocking<T>::KC;
+	template<typename T>
+	constexpr Index GemmBlocking<T>::NC;
+
+	// Packs the mc x kc block of A into slivers of MR rows, every sliver stored column by column.
+	// Missing rows are padded with zeros.
+	template<typename T, Index MR>
+	void gemm_pack_a(Index mc, Index kc, const T* A, Index lda, T* packed)
+	{
+		for(Index i = 0; i < mc; i += MR)
+		{
+			const Index mr = std::min(MR, mc - i);
+			for(Index p = 0; p < kc; ++p)
+			{
+				for(Index r = 0; r < mr; ++r)
+					packed[r] = A[(i + r)*lda + p];
+				for(Index r = mr; r < MR; ++r)
+					packed[r] = (T)0;
+				packed += MR;
+			}
+		}
+	}
+
+	// Packs the kc x nc panel of B into slivers of NR columns, every sliver stored row by row.
+	// Missing columns are padded with zeros.
+	template<typename T, Index NR>
+	void gemm_pack_b(Index kc, Index nc, const T* B, Index ldb, T* packed)
+	{
+		for(Index j = 0; j < nc; j += NR)
+		{
+			const Index nr = std::min(NR, nc - j);
+			for(Index p = 0; p < kc; ++p)
+			{
+				const T* row = B + p*ldb + j;
+				for(Index c = 0; c < nr; ++c)
+					packed[c] = row[c];
+				for(Index c = nr; c < NR; ++c)
+					packed[c] = (T)0;
+				packed += NR;
+			}
+		}
+	}
+
+	// acc += a*b
+	template<typename T>
+	inline void gemm_fma(T& acc, const T& a, const T& b)
+	{
+		acc += a*b;
+	}
+
+	// Without the inf/nan recovery of the standard complex multiplication, which prevents vectorization
+	template<typename T>
+	inline void gemm_fma(std::complex<T>& acc, const std::complex<T>& a, const std::complex<T>& b)
+	{
+		acc = std::complex<T>(acc.real() + a.real()*b.real() - a.imag()*b.imag(),
+			acc.imag() + a.real()*b.imag() + a.imag()*b.real());
+	}
+
+	// C[mr x nr] = alpha * a*b + beta * C with the packed slivers a and b.
+	// The accumulator has constant size, so the compiler can keep it in (vector) registers.
+	template<typename T, Index MR, Index NR>
+	void gemm_micro(Index kc, const T* a, const T* b,
+		const T& alpha, const T& beta, T* C, Index ldc, Index mr, Index nr)
+	{
+		T acc[MR*NR];
+		for(Index i = 0; i < MR*NR; ++i)
+			acc[i] = (T)0;
+
+		for(Index p = 0; p < kc; ++p)
+		{
+			for(Index i = 0; i < MR; ++i)
+			{
+				const T ai = a[i];
+				for(Index j = 0; j < NR; ++j)
+					gemm_fma(acc[i*NR + j], ai, b[j]);
+			}
+			a += MR;
+			b += NR;
+		}
+
+		for(Index i = 0; i < mr; ++i)
+		{
+			T* row = C + i*ldc;
+			if(beta == (T)0)
+			{
+				for(Index j = 0; j < nr; ++j)
+					row[j] = alpha*acc[i*NR + j];
+			}
+			else
+			{
+				for(Index j = 0; j < nr; ++j)
+					row[j] = alpha*acc[i*NR + j] + beta*row[j];
+			}
+		}
+	}
+
+	template<typename T>
+	void gemm(Index m, Index n, Index k, const T& alpha,
+		const T* A, Index lda, const T* B, Index ldb,
+		const T& beta, T* C, Index ldc, size_t threads)
+	{
+		typedef GemmBlocking<T> BS;
+		constexpr Index MR = BS::MR;
+		constexpr Index NR = BS::NR;
+
+		if(m == 0 || n == 0)
+			return;
+
+		if(k == 0 || alpha == (T)0)
+		{
+			for(Index i = 0; i < m; ++i)
+			{
+				for(Index j = 0; j < n; ++j)
+					C[i*ldc + j] = beta == (T)0 ? (T)0 : beta*C[i*ldc + j];
+			}
+			return;
+		}
+
+		// Packing does not pay off for small products
+		if(m*n*k < 32*32*32)
+		{
+			for(Index i = 0; i < m; ++i)
+			{
+				T* row = C + i*ldc;
+				for(Index j = 0; j < n; ++j)
+					row[j] = beta == (T)0 ? (T)0 : beta*row[j];
+
+				for(Index p = 0; p < k; ++p)
+				{
+					const T a = alpha*A[i*lda + p];
+					const T* b = B + p*ldb;
+					for(Index j = 0; j < n; ++j)
+						row[j] += a*b[j];
+				}
+			}
+			return;
+		}
+
+		if(m*n*k < (1 << 18))
+			threads = 1;
+
+		const Index blocks = (m + BS::MC - 1)/BS::MC;
+		std::vector<T> packedB(BS::KC*((std::min(n, BS::NC) + NR - 1)/NR)*NR);
+
+		for(Index jc = 0; jc < n; jc += BS::NC)
+		{
+			const Index nc = std::min(BS::NC, n - jc);
+			for(Index pc = 0; pc < k; pc += BS::KC)
+			{
+				const Index kc = std::min(BS::KC, k - pc);
+				const T b = pc == 0 ? beta : (T)1;// Accumulate after the first panel
+
+				gemm_pack_b<T,NR>(kc, nc, B + pc*ldb + jc, ldb, packedB.data());
+
+				Parallel::for_range(0, blocks, [&](Index begin, Index end, Index)
+				{
+					std::vector<T> packedA(BS::MC*kc);
+					for(Index block = begin; block < end; ++block)
+					{
+						const Index ic = block*BS::MC;
+						const Index mc = std::min(BS::MC, m - ic);
+						gemm_pack_a<T,MR>(mc, kc, A + ic*lda + pc, lda, packedA.data());
+
+						for(Index jr = 0; jr < nc; jr += NR)
+						{
+							for(Index ir = 0; ir < mc; ir += MR)
+							{
+								gemm_micro<T,MR,NR>(kc, packedA.data() + ir*kc, packedB.data() + jr*kc,
+									alpha, b, C + (ic + ir)*ldc + jc + jr, ldc,
+									std::min(MR, mc - ir), std::min(NR, nc - jr));
+							}
+						}
+					}
+				}, threads);
+			}
+		}
+	}
+}
+
+NS_END_NAMESPACE
\ No newline at end of file
@@ -13,18 +13,41 @@ namespace Operations
 	* @param m Square Matrix or square Sparse Matrix
 	* @return 0 if non square or singular, determinant else
 	*/
-	template<template<typename> class M, typename T>
-	T determinant(const M<T>& m);
+	template<class M>
+	typename std::enable_if<is_dynamic_matrix_type<M>::value, typename M::value_type>::type
+	determinant(const M& m);
 	
+	/**
+	* @brief Calculates the determinant of the fixed matrix m
+	* @details Square matrices up to 4x4 use an unrolled closed form.
+	* @return 0 if non square or singular, determinant else
+	*/
 	template<typename T, Dimension K1, Dimension K2>
 	T determinant(const FixedMatrix<T, K1, K2>& m);
 
 	template<class M>
 	M inverse(const M& m);
 
+	/**
+	* @brief Calculates the inverse of the fixed square matrix m
+	* @details Matrices up to 4x4 use an unrolled closed form (adjugate divided by determinant).
+	* @throw SingularException if m is singular
+	*/
+	template<typename T, Dimension K>
+	FixedMatrix<T,K,K> inverse(const FixedMatrix<T,K,K>& m);
+
+	/**
+	* @brief Calculates the determinant and the inverse of the fixed square matrix m at once.
+	* @details Unlike inverse(), this does not throw.
+	* If the determinant is zero, inv is left untouched.
+	* @return Determinant of m
+	*/
+	template<typename T, Dimension K>
+	T determinant_inverse(const FixedMatrix<T,K,K>& m, FixedMatrix<T,K,K>& inv);
+
 	// Optimized version
-	template<template<typename> class M, typename T>
-	M<T> inverse(const M<T>& L, const M<T>& U);
+	template<class M>
+	M inverse(const M& L, const M& U);
 
 	template<class M>
 	M inverse(const M& L, const M& U, const M& P);
@@ -37,6 +60,39 @@ namespace Operations
 
 	template<class M>
 	typename M::value_type cond(const M& m);
+
+	/**
+	* @brief Applies dirichlet constraints x_i = g_i to the system A x = b.
+	* @details Symmetric elimination: The right hand side is lifted by b_j -= a_ji g_i,
+	* row and column i are set to zero and the diagonal to the given value with b_i = diagonal g_i.
+	* The eliminated entries are kept as explicit zeros, therefore the pattern of A does not change.
+	* A hermitian matrix stays hermitian.
+	* @param rows Constrained rows
+	* @param values Value g_i for every constrained row
+	* @throw NotSquareException
+	* @throw MatrixVectorMismatchException
+	* @throw VectorSizeMismatchException if rows and values differ in size
+	* @throw MatrixHasZeroInDiagException if a constrained row has no diagonal entry
+	* @par Complexity
+	* Always: \f$ O(D+N) \f$ with N the amount of filled entries
+	*/
+	template<typename T, class V>
+	void apply_dirichlet(SparseMatrix<T>& A, V& b,
+		const std::vector<Index>& rows, const std::vector<T>& values, const T& diagonal = (T)1);
+
+	namespace parallel
+	{
+		/**
+		* @brief Sparse matrix vector multiplication y = A x with the rows distributed over multiple threads.
+		* @details y is resized if necessary and should not be x.
+		* Matrices with less than Parallel::SerialThreshold filled entries are multiplied in the calling thread.
+		* The products are accumulated in the precision of y, which may differ from T and x.
+		* @param threads Amount of threads to use. 0 uses Parallel::thread_count().
+		* @throw MatrixMulMismatchException
+		*/
+		template<typename T, class VX, class VY>
+		void mul(const SparseMatrix<T>& A, const VX& x, VY& y, size_t threads = 0);
+	}
 }
 
 NS_END_NAMESPACE
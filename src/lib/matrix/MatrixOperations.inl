@@ -6,12 +6,15 @@ NS_BEGIN_NAMESPACE
 
 namespace Operations
 {
-	template<template<typename> class M, typename T>
-	T determinant(const M<T>& m)
+	template<class M>
+	typename std::enable_if<is_dynamic_matrix_type<M>::value, typename M::value_type>::type
+	determinant(const M& m)
 	{
+		typedef typename M::value_type T;
+
 		try
 		{
-			M<T> L(m.rows(), m.columns()), U(m.rows(), m.columns()), P(m.rows(), m.columns());
+			M L(m.rows(), m.columns()), U(m.rows(), m.columns()), P(m.rows(), m.columns());
 			size_t pivotCount;
 			LU::serial::doolittle(m, L, U, P, &pivotCount);
 			T det = (T)Math::sign_pow(pivotCount);
@@ -27,25 +30,225 @@ namespace Operations
 		}
 	}
 
+	/* Closed forms for small fixed matrices.
+	 * The generic version falls back to the LU decomposition. */
 	template<typename T, Dimension K1, Dimension K2>
-	T determinant(const FixedMatrix<T, K1, K2>& m)
+	struct SmallMatrixOperations
 	{
-		try
+		static constexpr bool ClosedForm = false;
+
+		static T determinant(const FixedMatrix<T, K1, K2>& m)
 		{
-			FixedMatrix<T, K1, K2> L, U, P;
-			size_t pivotCount;
-			LU::serial::doolittle(m, L, U, P, &pivotCount);
-			T det = (T)Math::sign_pow(pivotCount);
+			try
+			{
+				FixedMatrix<T, K1, K2> L, U, P;
+				size_t pivotCount;
+				LU::serial::doolittle(m, L, U, P, &pivotCount);
+				T det = (T)Math::sign_pow(pivotCount);
 
-			for(Index i = 0; i < U.rows(); ++i)
-				det *= U.at(i,i);
-			
-			return det;
+				for(Index i = 0; i < U.rows(); ++i)
+					det *= U.at(i,i);
+				
+				return det;
+			}
+			catch(const MathException&)
+			{
+				return (T)0;
+			}
 		}
-		catch(const MathException&)
+	};
+
+	template<typename T>
+	struct SmallMatrixOperations<T,1,1>
+	{
+		static constexpr bool ClosedForm = true;
+
+		static T determinant(const FixedMatrix<T,1,1>& m)
 		{
-			return (T)0;
+			return m.linear_at(0);
+		}
+
+		static void inverse(const FixedMatrix<T,1,1>&, const T& det, FixedMatrix<T,1,1>& inv)
+		{
+			inv.linear_set(0, (T)1/det);
+		}
+	};
+
+	template<typename T>
+	struct SmallMatrixOperations<T,2,2>
+	{
+		static constexpr bool ClosedForm = true;
+
+		static T determinant(const FixedMatrix<T,2,2>& m)
+		{
+			return m.linear_at(0)*m.linear_at(3) - m.linear_at(1)*m.linear_at(2);
+		}
+
+		static void inverse(const FixedMatrix<T,2,2>& m, const T& det, FixedMatrix<T,2,2>& inv)
+		{
+			const T f = (T)1/det;
+			const T a0 = m.linear_at(0);
+			const T a1 = m.linear_at(1);
+			const T a2 = m.linear_at(2);
+			const T a3 = m.linear_at(3);
+
+			inv.linear_set(0, a3*f);
+			inv.linear_set(1, -a1*f);
+			inv.linear_set(2, -a2*f);
+			inv.linear_set(3, a0*f);
+		}
+	};
+
+	template<typename T>
+	struct SmallMatrixOperations<T,3,3>
+	{
+		static constexpr bool ClosedForm = true;
+
+		static T determinant(const FixedMatrix<T,3,3>& m)
+		{
+			T a[9];
+			for(Index i = 0; i < 9; ++i)
+				a[i] = m.linear_at(i);
+
+			return a[0]*(a[4]*a[8] - a[5]*a[7])
+				- a[1]*(a[3]*a[8] - a[5]*a[6])
+				+ a[2]*(a[3]*a[7] - a[4]*a[6]);
+		}
+
+		static void inverse(const FixedMatrix<T,3,3>& m, const T& det, FixedMatrix<T,3,3>& inv)
+		{
+			T a[9];
+			for(Index i = 0; i < 9; ++i)
+				a[i] = m.linear_at(i);
+
+			const T f = (T)1/det;
+			inv.linear_set(0, (a[4]*a[8] - a[5]*a[7])*f);
+			inv.linear_set(1, (a[2]*a[7] - a[1]*a[8])*f);
+			inv.linear_set(2, (a[1]*a[5] - a[2]*a[4])*f);
+			inv.linear_set(3, (a[5]*a[6] - a[3]*a[8])*f);
+			inv.linear_set(4, (a[0]*a[8] - a[2]*a[6])*f);
+			inv.linear_set(5, (a[2]*a[3] - a[0]*a[5])*f);
+			inv.linear_set(6, (a[3]*a[7] - a[4]*a[6])*f);
+			inv.linear_set(7, (a[1]*a[6] - a[0]*a[7])*f);
+			inv.linear_set(8, (a[0]*a[4] - a[1]*a[3])*f);
+		}
+	};
+
+	template<typename T>
+	struct SmallMatrixOperations<T,4,4>
+	{
+		static constexpr bool ClosedForm = true;
+
+		// 2x2 minors of the upper (s) and lower (c) two rows
+		static void minors(const T* a, T* s, T* c)
+		{
+			s[0] = a[0]*a[5] - a[4]*a[1];
+			s[1] = a[0]*a[6] - a[4]*a[2];
+			s[2] = a[0]*a[7] - a[4]*a[3];
+			s[3] = a[1]*a[6] - a[5]*a[2];
+			s[4] = a[1]*a[7] - a[5]*a[3];
+			s[5] = a[2]*a[7] - a[6]*a[3];
+
+			c[0] = a[8]*a[13] - a[12]*a[9];
+			c[1] = a[8]*a[14] - a[12]*a[10];
+			c[2] = a[8]*a[15] - a[12]*a[11];
+			c[3] = a[9]*a[14] - a[13]*a[10];
+			c[4] = a[9]*a[15] - a[13]*a[11];
+			c[5] = a[10]*a[15] - a[14]*a[11];
+		}
+
+		static T determinant(const FixedMatrix<T,4,4>& m)
+		{
+			T a[16], s[6], c[6];
+			for(Index i = 0; i < 16; ++i)
+				a[i] = m.linear_at(i);
+			minors(a, s, c);
+
+			return s[0]*c[5] - s[1]*c[4] + s[2]*c[3] + s[3]*c[2] - s[4]*c[1] + s[5]*c[0];
+		}
+
+		static void inverse(const FixedMatrix<T,4,4>& m, const T& det, FixedMatrix<T,4,4>& inv)
+		{
+			T a[16], s[6], c[6];
+			for(Index i = 0; i < 16; ++i)
+				a[i] = m.linear_at(i);
+			minors(a, s, c);
+
+			const T f = (T)1/det;
+			inv.linear_set(0, ( a[5]*c[5] - a[6]*c[4] + a[7]*c[3])*f);
+			inv.linear_set(1, (-a[1]*c[5] + a[2]*c[4] - a[3]*c[3])*f);
+			inv.linear_set(2, ( a[13]*s[5] - a[14]*s[4] + a[15]*s[3])*f);
+			inv.linear_set(3, (-a[9]*s[5] + a[10]*s[4] - a[11]*s[3])*f);
+
+			inv.linear_set(4, (-a[4]*c[5] + a[6]*c[2] - a[7]*c[1])*f);
+			inv.linear_set(5, ( a[0]*c[5] - a[2]*c[2] + a[3]*c[1])*f);
+			inv.linear_set(6, (-a[12]*s[5] + a[14]*s[2] - a[15]*s[1])*f);
+			inv.linear_set(7, ( a[8]*s[5] - a[10]*s[2] + a[11]*s[1])*f);
+
+			inv.linear_set(8, ( a[4]*c[4] - a[5]*c[2] + a[7]*c[0])*f);
+			inv.linear_set(9, (-a[0]*c[4] + a[1]*c[2] - a[3]*c[0])*f);
+			inv.linear_set(10, ( a[12]*s[4] - a[13]*s[2] + a[15]*s[0])*f);
+			inv.linear_set(11, (-a[8]*s[4] + a[9]*s[2] - a[11]*s[0])*f);
+
+			inv.linear_set(12, (-a[4]*c[3] + a[5]*c[1] - a[6]*c[0])*f);
+			inv.linear_set(13, ( a[0]*c[3] - a[1]*c[1] + a[2]*c[0])*f);
+			inv.linear_set(14, (-a[12]*s[3] + a[13]*s[1] - a[14]*s[0])*f);
+			inv.linear_set(15, ( a[8]*s[3] - a[9]*s[1] + a[10]*s[0])*f);
 		}
+	};
+
+	template<typename T, Dimension K>
+	inline void small_inverse(const FixedMatrix<T,K,K>& m, const T& det, FixedMatrix<T,K,K>& inv, std::true_type)
+	{
+		SmallMatrixOperations<T,K,K>::inverse(m, det, inv);
+	}
+
+	template<typename T, Dimension K>
+	void small_inverse(const FixedMatrix<T,K,K>& m, const T&, FixedMatrix<T,K,K>& inv, std::false_type)
+	{
+		FixedMatrix<T,K,K> L, U, P;
+		size_t pivotCount;
+		LU::serial::doolittle(m, L, U, P, &pivotCount);
+
+		FixedVector<T,K> b;
+		for(Index i = 0; i < K; ++i)
+		{
+			b[i] = 1;
+			const FixedVector<T,K> x = LU::serial::solve_lu(L, U, P.mul(b));
+
+			for(Index j = 0; j < K; ++j)
+				inv.set(j, i, x[j]);
+
+			b[i] = 0;
+		}
+	}
+
+	template<typename T, Dimension K1, Dimension K2>
+	T determinant(const FixedMatrix<T, K1, K2>& m)
+	{
+		return SmallMatrixOperations<T, K1, K2>::determinant(m);
+	}
+
+	template<typename T, Dimension K>
+	FixedMatrix<T,K,K> inverse(const FixedMatrix<T,K,K>& m)
+	{
+		FixedMatrix<T,K,K> inv;
+		if(determinant_inverse(m, inv) == (T)0)
+			throw SingularException();
+
+		return inv;
+	}
+
+	template<typename T, Dimension K>
+	T determinant_inverse(const FixedMatrix<T,K,K>& m, FixedMatrix<T,K,K>& inv)
+	{
+		typedef std::integral_constant<bool, SmallMatrixOperations<T,K,K>::ClosedForm> closed_form;
+
+		const T det = SmallMatrixOperations<T,K,K>::determinant(m);
+		if(det != (T)0)
+			small_inverse(m, det, inv, closed_form());
+
+		return det;
 	}
 
 	template<class M>
@@ -60,9 +263,11 @@ namespace Operations
 		return inverse(L, U, P);
 	}
 
-	template<template<typename> class M, typename T>
-	M<T> inverse(const M<T>& L, const M<T>& U)
+	template<class M>
+	M inverse(const M& L, const M& U)
 	{
+		typedef typename M::value_type T;
+
 		if (L.rows() != L.columns())
 			throw NotSquareException();
 
@@ -72,7 +277,7 @@ namespace Operations
 		if (L.rows() != U.rows())
 			throw MatrixSizeMismatchException();
 
-		M<T> Inv(L.rows(), L.columns());
+		M Inv(L.rows(), L.columns());
 		for(Index i = 0; i < L.columns(); ++i)
 		{
 			// Forward
@@ -194,6 +399,103 @@ namespace Operations
 	{
 		return max_norm2(m)/min_norm2(m);
 	}
+
+	template<typename T, class V>
+	void apply_dirichlet(SparseMatrix<T>& A, V& b,
+		const std::vector<Index>& rows, const std::vector<T>& values, const T& diagonal)
+	{
+		if (A.rows() != A.columns())
+			throw NotSquareException();
+		if (A.rows() != b.size())
+			throw MatrixVectorMismatchException();
+		if (rows.size() != values.size())
+			throw VectorSizeMismatchException();
+
+		const Index n = A.rows();
+		std::vector<bool> constrained(n, false);
+		std::vector<T> g(n, (T)0);
+		for (Index k = 0; k < rows.size(); ++k)
+		{
+			NS_ASSERT(rows[k] < n);
+			constrained[rows[k]] = true;
+			g[rows[k]] = values[k];
+		}
+
+		const auto* rowPtr = A.row_ptr();
+		const auto* colPtr = A.column_ptr();
+		T* vals = A.value_ptr();
+
+		for (Index i = 0; i < n; ++i)
+		{
+			if (constrained[i])
+			{
+				bool hasDiagonal = false;
+				for (Index k = rowPtr[i]; k < rowPtr[i + 1]; ++k)
+				{
+					if (colPtr[k] == i)
+					{
+						vals[k] = diagonal;
+						hasDiagonal = true;
+					}
+					else
+					{
+						vals[k] = (T)0;
+					}
+				}
+
+				if (!hasDiagonal)
+					throw MatrixHasZeroInDiagException();
+
+				b[i] = diagonal * g[i];
+			}
+			else
+			{
+				for (Index k = rowPtr[i]; k < rowPtr[i + 1]; ++k)
+				{
+					if (constrained[colPtr[k]])
+					{
+						b[i] -= vals[k] * g[colPtr[k]];
+						vals[k] = (T)0;
+					}
+				}
+			}
+		}
+	}
+
+	namespace parallel
+	{
+		template<typename T, class VX, class VY>
+		void mul(const SparseMatrix<T>& A, const VX& x, VY& y, size_t threads)
+		{
+			if (A.columns() != x.size())
+				throw MatrixMulMismatchException();
+
+			NS_ASSERT((const void*)&x != (const void*)&y);
+
+			if (y.size() != A.rows())
+				y = VY(A.rows());
+
+			const auto* rowPtr = A.row_ptr();
+			const auto* colPtr = A.column_ptr();
+			const T* values = A.value_ptr();
+
+			const auto rowMul = [&](Index begin, Index end, Index)
+			{
+				for (Index i = begin; i < end; ++i)
+				{
+					typename VY::value_type s = 0;
+					for (Index k = rowPtr[i]; k < rowPtr[i + 1]; ++k)
+						s += values[k] * x[colPtr[k]];
+					y[i] = s;
+				}
+			};
+
+			if (A.filled_count() < Parallel::SerialThreshold)
+				rowMul(0, A.rows(), 0);
+			else
+				Parallel::for_range(0, A.rows(), rowMul, threads);
+		}
+	}
 }
 
 NS_END_NAMESPACE
\ No newline at end of file
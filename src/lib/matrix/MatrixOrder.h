@@ -1,30 +1,60 @@
 #pragma once
 
-#include <queue>
-#include <map>
+#include <algorithm>
+#include <limits>
+#include <vector>
 
 #include "SparseMatrix.h"
 #include "Vector.h"
 #include "Utils.h"
+#include "Parallel.h"
 
 NS_BEGIN_NAMESPACE
 
 /**
 * @brief Applies the CutHill-McKee algorithm
-* @param m Should be a square symmetric sparse matrix
+* @details Every connected component starts at a pseudo-peripheral node
+* found by the George-Liu level structure search.
+* @param m Should be a square sparse matrix with symmetric pattern
 * @return Returns new ordering of matrix
+* @par Complexity
+* Always: \f$ O(D+N) \f$ with N the amount of filled entries
 */
 template<typename T>
 DynamicVector<Index> cuthill_mckee(const SparseMatrix<T>& m);
 
 /**
 * @brief Applies the reverse CutHill-McKee algorithm
-* @param m Should be a square symmetric sparse matrix
+* @param m Should be a square sparse matrix with symmetric pattern
 * @return Returns new ordering of matrix
+* @par Complexity
+* Always: \f$ O(D+N) \f$ with N the amount of filled entries
 */
 template<typename T>
 DynamicVector<Index> r_cuthill_mckee(const SparseMatrix<T>& m);
 
+/**
+* @brief Approximate minimum degree ordering to reduce the fill-in of factorizations.
+* @details Eliminates the nodes on the quotient graph and uses the approximated
+* external degree of Amestoy, Davis and Duff with element absorption.
+* @param m Should be a square sparse matrix. Only the pattern of m + m^T is used.
+* @return Returns new ordering of matrix
+*/
+template<typename T>
+DynamicVector<Index> approximate_minimum_degree(const SparseMatrix<T>& m);
+
+/**
+* @brief Nested dissection ordering to reduce the fill-in of factorizations.
+* @details The graph is recursively split by vertex separators, which are numbered last.
+* Separators are calculated from a multilevel bisection with heavy edge matching,
+* graph growing and boundary refinement.
+* Parts with at most leafSize nodes are ordered by approximate_minimum_degree().
+* @param m Should be a square sparse matrix. Only the pattern of m + m^T is used.
+* @return Returns new ordering of matrix
+*/
+template<typename T>
+DynamicVector<Index> nested_dissection(const SparseMatrix<T>& m, Index leafSize = 64);
+
 template<typename T>
 SparseMatrix<T> permutation_matrix(const DynamicVector<Index>& permutation);
 
@@ -32,12 +62,18 @@ DynamicVector<Index> inverse_permutation(const DynamicVector<Index>& permutation
 
 /**
 * @brief Reorders the given matrix based on the permuation
+* @details Calculates \f$ P m P^T \f$, i.e. new(i,j) = m(permutation[i], permutation[j]).
+* The result is build directly in CRS format: Row pointers are counted,
+* every row is copied with its columns renumbered and sorted afterwards.
+* Rows are processed in parallel for large matrices.
 * @param m Should be a square sparse matrix
+* @param threads Amount of threads to use. 0 uses Parallel::thread_count().
 * @return Returns new matrix
-* @todo Need an inplace algorithm and faster algorithm.
+* @par Complexity
+* Always: \f$ O(D+N) \f$ with N the amount of filled entries, plus sorting of the rows.
 */
 template<typename T>
-SparseMatrix<T> permutate(const SparseMatrix<T>& m, const DynamicVector<Index>& permutation);
+SparseMatrix<T> permutate(const SparseMatrix<T>& m, const DynamicVector<Index>& permutation, size_t threads = 0);
 
 template<typename T>
 DynamicVector<T> permutate(const DynamicVector<T>& m, const DynamicVector<Index>& permutation);
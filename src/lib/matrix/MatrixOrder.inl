@@ -4,84 +4,152 @@
 
 NS_BEGIN_NAMESPACE
 
-template<class K, class V>
-typename std::multimap<K, V>::const_iterator find_pair(const std::multimap<K, V>& map,
-	const std::pair<K, V>& pair)
-{
-    const auto range = map.equal_range(pair.first);
-    for (auto it = range.first; it != range.second; ++it)
-        if (it->second == pair.second)
-            return it;
-    return map.end();
-}
-
 template<typename T>
 DynamicVector<Index> cuthill_mckee(const SparseMatrix<T>& m)
 {
 	if(m.rows() != m.columns())
 		throw NotSquareException();
-	
-	DynamicVector<Index> R(m.rows());
-	Index currentIndex = 0;
 
-	std::queue<Index> Q;
-	std::multimap<Dimension, Index> Rows;
-	for(Index i = 0; i < m.rows(); ++i)
+	const Index n = m.rows();
+	const auto* rowPtr = m.row_ptr();
+	const auto* colPtr = m.column_ptr();
+
+	// Degree of every node without the diagonal
+	std::vector<Index> degree(n, 0);
+	for(Index k = 0; k < rowPtr[n]; ++k)
+		++degree[colPtr[k]];
+	for(Index i = 0; i < n; ++i)
 	{
-		Index mc = m.row_filled_count(i);
-		if(mc > 0)
-			Rows.insert(std::pair<Dimension, Index>(mc, i));
+		for(Index k = rowPtr[i]; k < rowPtr[i+1]; ++k)
+		{
+			if(colPtr[k] == i)
+				--degree[i];
+		}
 	}
-	
-	while(!Rows.empty())
+
+	// Bucket sort by degree; nodes with the same degree stay in index order
+	Index maxDegree = 0;
+	for(Index i = 0; i < n; ++i)
+		maxDegree = std::max(maxDegree, degree[i]);
+
+	std::vector<Index> bucket(maxDegree + 2, 0);
+	for(Index i = 0; i < n; ++i)
+		++bucket[degree[i] + 1];
+	for(Index d = 0; d <= maxDegree; ++d)
+		bucket[d + 1] += bucket[d];
+
+	std::vector<Index> sorted(n);
+	for(Index i = 0; i < n; ++i)
+		sorted[bucket[degree[i]]++] = i;
+
+	// Adjacency lists. Scattering the nodes in sorted order sorts every list by degree
+	std::vector<Index> adjPtr(n + 1, 0);
+	for(Index i = 0; i < n; ++i)
+		adjPtr[i + 1] = adjPtr[i] + degree[i];
+
+	std::vector<Index> adj(adjPtr[n]);
+	std::vector<Index> next(adjPtr.begin(), adjPtr.end() - 1);
+	for(Index v : sorted)
+	{
+		for(Index k = rowPtr[v]; k < rowPtr[v+1]; ++k)
+		{
+			if(colPtr[k] != v)
+				adj[next[colPtr[k]]++] = v;
+		}
+	}
+
+	// Rooted level structure restricted to not yet numbered nodes.
+	// Returns the amount of levels, the last level is levels[lastLevel, size).
+	std::vector<bool> numbered(n, false);
+	std::vector<Index> stamp(n, 0);
+	std::vector<Index> levels(n);
+	Index currentStamp = 0;
+	const auto level_structure = [&](Index root, Index& lastLevel, Index& size) -> Index
 	{
-		// Find first p with lowest degree
-		Index p = Rows.begin()->second;
-		R[currentIndex] = p;
-		Rows.erase(Rows.begin());
-		++currentIndex;
+		++currentStamp;
+		levels[0] = root;
+		stamp[root] = currentStamp;
 
-		// Add all adjacent nodes to the queue
-		std::multimap<Dimension, Index> adj;
-		for(auto it = m.row_cbegin(p); it != m.row_cend(p); ++it)
+		Index depth = 0;
+		Index begin = 0;
+		Index end = 1;
+		while(begin < end)
 		{
-			if(it.column() != it.row())
+			++depth;
+			lastLevel = begin;
+
+			size = end;
+			for(Index i = begin; i < end; ++i)
 			{
-				Index mc = m.row_filled_count(it.column());
-				if(mc > 0)
-					adj.insert(std::pair<Dimension, Index>(mc, it.column()));
+				const Index v = levels[i];
+				for(Index k = adjPtr[v]; k < adjPtr[v+1]; ++k)
+				{
+					const Index u = adj[k];
+					if(!numbered[u] && stamp[u] != currentStamp)
+					{
+						stamp[u] = currentStamp;
+						levels[size++] = u;
+					}
+				}
 			}
+
+			begin = end;
+			end = size;
 		}
 
-		for(std::pair<Dimension, Index> pair : adj)
-			Q.push(pair.second);
+		return depth;
+	};
+
+	DynamicVector<Index> R(n);
+	Index currentIndex = 0;
+	Index nextStart = 0;
+	while(currentIndex < n)
+	{
+		// Lowest degree node of the next component
+		while(numbered[sorted[nextStart]])
+			++nextStart;
+		Index root = sorted[nextStart];
 
-		// Examine first entry of the queue
-		while(!Q.empty())
+		// Pseudo-peripheral node: Move to a node of the last level with lowest degree
+		// as long as the level structure gets deeper
+		Index lastLevel;
+		Index size;
+		Index depth = level_structure(root, lastLevel, size);
+		for(;;)
 		{
-			Index c = Q.front();
-			Q.pop();
-			Index mc = m.row_filled_count(c);
-			auto rit = find_pair(Rows, std::pair<Dimension, Index>(mc, c));
-			if(rit != Rows.end())
+			Index candidate = levels[lastLevel];
+			for(Index i = lastLevel + 1; i < size; ++i)
 			{
-				R[currentIndex] = c;
-				Rows.erase(rit);
-				++currentIndex;
+				if(degree[levels[i]] < degree[candidate])
+					candidate = levels[i];
+			}
+
+			if(candidate == root)
+				break;
+
+			const Index candidateDepth = level_structure(candidate, lastLevel, size);
+			if(candidateDepth <= depth)
+				break;
+
+			root = candidate;
+			depth = candidateDepth;
+		}
 
-				adj.clear();
-				for(auto it = m.row_cbegin(c); it != m.row_cend(c); ++it)
+		// Breadth first search with neighbours ordered by degree
+		Index head = currentIndex;
+		R[currentIndex++] = root;
+		numbered[root] = true;
+		while(head < currentIndex)
+		{
+			const Index v = R[head++];
+			for(Index k = adjPtr[v]; k < adjPtr[v+1]; ++k)
+			{
+				const Index u = adj[k];
+				if(!numbered[u])
 				{
-					if(it.column() != it.row())
-					{
-						Index mc = m.row_filled_count(it.column());
-						if(mc > 0)
-							adj.insert(std::pair<Dimension, Index>(mc, it.column()));
-					}
+					numbered[u] = true;
+					R[currentIndex++] = u;
 				}
-
-				for(std::pair<Dimension, Index> pair : adj)
-					Q.push(pair.second);
 			}
 		}
 	}
@@ -105,16 +173,600 @@ DynamicVector<Index> r_cuthill_mckee(const SparseMatrix<T>& m)
 	return v;
 }
 
+/*
+ * Undirected graph in CRS format used by the fill-reducing orderings.
+ * Weights are only used while coarsening.
+ */
+struct OrderGraph
+{
+	std::vector<Index> Ptr;
+	std::vector<Index> Adj;
+	std::vector<Index> EdgeWeight;
+	std::vector<Index> Weight;
+
+	inline Index size() const { return Ptr.size() - 1; }
+};
+
+template<typename T>
+OrderGraph order_graph(const SparseMatrix<T>& m)
+{
+	if(m.rows() != m.columns())
+		throw NotSquareException();
+
+	const Index n = m.rows();
+	const auto* rowPtr = m.row_ptr();
+	const auto* colPtr = m.column_ptr();
+
+	// Pattern of m + m^T without the diagonal, still with duplicates
+	std::vector<Index> ptr(n + 1, 0);
+	for(Index i = 0; i < n; ++i)
+	{
+		for(Index k = rowPtr[i]; k < rowPtr[i+1]; ++k)
+		{
+			if(colPtr[k] != i)
+			{
+				++ptr[i + 1];
+				++ptr[colPtr[k] + 1];
+			}
+		}
+	}
+	for(Index i = 0; i < n; ++i)
+		ptr[i + 1] += ptr[i];
+
+	std::vector<Index> adj(ptr[n]);
+	std::vector<Index> next(ptr.begin(), ptr.end() - 1);
+	for(Index i = 0; i < n; ++i)
+	{
+		for(Index k = rowPtr[i]; k < rowPtr[i+1]; ++k)
+		{
+			if(colPtr[k] != i)
+			{
+				adj[next[i]++] = colPtr[k];
+				adj[next[colPtr[k]]++] = i;
+			}
+		}
+	}
+
+	OrderGraph g;
+	g.Ptr.resize(n + 1, 0);
+	g.Adj.reserve(adj.size());
+	std::vector<Index> mark(n, std::numeric_limits<Index>::max());
+	for(Index i = 0; i < n; ++i)
+	{
+		for(Index k = ptr[i]; k < ptr[i+1]; ++k)
+		{
+			if(mark[adj[k]] != i)
+			{
+				mark[adj[k]] = i;
+				g.Adj.push_back(adj[k]);
+			}
+		}
+		g.Ptr[i + 1] = g.Adj.size();
+	}
+
+	g.EdgeWeight.assign(g.Adj.size(), 1);
+	g.Weight.assign(n, 1);
+	return g;
+}
+
+inline OrderGraph order_subgraph(const OrderGraph& g, const std::vector<Index>& nodes, std::vector<Index>& local)
+{
+	const Index None = std::numeric_limits<Index>::max();
+
+	for(Index i = 0; i < nodes.size(); ++i)
+		local[nodes[i]] = i;
+
+	OrderGraph sub;
+	sub.Ptr.resize(nodes.size() + 1, 0);
+	for(Index i = 0; i < nodes.size(); ++i)
+	{
+		const Index v = nodes[i];
+		for(Index k = g.Ptr[v]; k < g.Ptr[v+1]; ++k)
+		{
+			if(local[g.Adj[k]] != None)
+				sub.Adj.push_back(local[g.Adj[k]]);
+		}
+		sub.Ptr[i + 1] = sub.Adj.size();
+	}
+
+	for(Index v : nodes)
+		local[v] = None;
+
+	sub.EdgeWeight.assign(sub.Adj.size(), 1);
+	sub.Weight.assign(nodes.size(), 1);
+	return sub;
+}
+
+inline std::vector<Index> order_minimum_degree(const OrderGraph& g)
+{
+	const Index None = std::numeric_limits<Index>::max();
+	const Index n = g.size();
+
+	// Quotient graph: Variables are adjacent to variables and elements (eliminated nodes).
+	std::vector<std::vector<Index> > variables(n);
+	std::vector<std::vector<Index> > elements(n);
+	std::vector<std::vector<Index> > elementVariables(n);
+	for(Index i = 0; i < n; ++i)
+		variables[i].assign(g.Adj.begin() + g.Ptr[i], g.Adj.begin() + g.Ptr[i+1]);
+
+	enum { Variable = 0, Element, Absorbed };
+	std::vector<char> status(n, Variable);
+
+	// Doubly linked degree lists
+	std::vector<Index> degree(n);
+	std::vector<Index> head(n + 1, None);
+	std::vector<Index> next(n, None);
+	std::vector<Index> prev(n, None);
+	Index minDegree = 0;
+
+	const auto insert = [&](Index i)
+	{
+		const Index d = degree[i];
+		prev[i] = None;
+		next[i] = head[d];
+		if(head[d] != None)
+			prev[head[d]] = i;
+		head[d] = i;
+		minDegree = std::min(minDegree, d);
+	};
+
+	const auto remove = [&](Index i)
+	{
+		if(prev[i] != None)
+			next[prev[i]] = next[i];
+		else
+			head[degree[i]] = next[i];
+
+		if(next[i] != None)
+			prev[next[i]] = prev[i];
+	};
+
+	for(Index i = 0; i < n; ++i)
+	{
+		degree[i] = variables[i].size();
+		insert(i);
+	}
+
+	std::vector<Index> mark(n, None);
+	std::vector<Index> wMark(n, None);
+	std::vector<Index> w(n, 0);
+
+	std::vector<Index> order;
+	order.reserve(n);
+	for(Index k = 0; k < n; ++k)
+	{
+		while(head[minDegree] == None)
+			++minDegree;
+
+		const Index p = head[minDegree];
+		remove(p);
+		order.push_back(p);
+		status[p] = Element;
+
+		// The new element contains all variables reachable from p
+		std::vector<Index>& Lp = elementVariables[p];
+		mark[p] = k;
+		for(Index v : variables[p])
+		{
+			if(status[v] == Variable && mark[v] != k)
+			{
+				mark[v] = k;
+				Lp.push_back(v);
+			}
+		}
+
+		for(Index e : elements[p])
+		{
+			if(status[e] != Element)
+				continue;
+
+			for(Index v : elementVariables[e])
+			{
+				if(status[v] == Variable && mark[v] != k)
+				{
+					mark[v] = k;
+					Lp.push_back(v);
+				}
+			}
+
+			// Elements adjacent to p are absorbed by the new element
+			status[e] = Absorbed;
+			std::vector<Index>().swap(elementVariables[e]);
+		}
+
+		std::vector<Index>().swap(variables[p]);
+		std::vector<Index>().swap(elements[p]);
+
+		// w(e) = |Le \ Lp| for all elements adjacent to Lp
+		for(Index i : Lp)
+		{
+			for(Index e : elements[i])
+			{
+				if(status[e] != Element)
+					continue;
+
+				if(wMark[e] != k)
+				{
+					wMark[e] = k;
+					w[e] = elementVariables[e].size();
+				}
+				--w[e];
+			}
+		}
+
+		// Approximate external degree of all variables in Lp
+		const Index lpSize = Lp.size();
+		for(Index i : Lp)
+		{
+			remove(i);
+
+			Index external = 0;
+			Index o = 0;
+			for(Index e : elements[i])
+			{
+				if(status[e] != Element)
+					continue;
+
+				if(w[e] == 0)// Aggressive absorption: Le is a subset of Lp
+				{
+					status[e] = Absorbed;
+					std::vector<Index>().swap(elementVariables[e]);
+					continue;
+				}
+
+				external += w[e];
+				elements[i][o++] = e;
+			}
+			elements[i].resize(o);
+			elements[i].push_back(p);
+
+			// Variables in Lp are already covered by the new element
+			o = 0;
+			for(Index v : variables[i])
+			{
+				if(status[v] == Variable && mark[v] != k)
+					variables[i][o++] = v;
+			}
+			variables[i].resize(o);
+
+			Index d = variables[i].size() + lpSize - 1 + external;
+			d = std::min(d, degree[i] + lpSize - 1);
+			d = std::min(d, n - k - 2);
+			degree[i] = d;
+			insert(i);
+		}
+	}
+
+	return order;
+}
+
+inline void order_coarsen(const OrderGraph& g, OrderGraph& coarse, std::vector<Index>& map)
+{
+	const Index None = std::numeric_limits<Index>::max();
+	const Index n = g.size();
+
+	// Heavy edge matching
+	map.assign(n, None);
+	Index count = 0;
+	for(Index i = 0; i < n; ++i)
+	{
+		if(map[i] != None)
+			continue;
+
+		Index best = None;
+		Index bestWeight = 0;
+		for(Index k = g.Ptr[i]; k < g.Ptr[i+1]; ++k)
+		{
+			if(map[g.Adj[k]] == None && g.EdgeWeight[k] > bestWeight)
+			{
+				best = g.Adj[k];
+				bestWeight = g.EdgeWeight[k];
+			}
+		}
+
+		map[i] = count;
+		if(best != None)
+			map[best] = count;
+		++count;
+	}
+
+	// Fine nodes of every coarse node
+	std::vector<Index> memberPtr(count + 1, 0);
+	for(Index i = 0; i < n; ++i)
+		++memberPtr[map[i] + 1];
+	for(Index c = 0; c < count; ++c)
+		memberPtr[c + 1] += memberPtr[c];
+
+	std::vector<Index> members(n);
+	std::vector<Index> next(memberPtr.begin(), memberPtr.end() - 1);
+	for(Index i = 0; i < n; ++i)
+		members[next[map[i]]++] = i;
+
+	coarse.Ptr.assign(count + 1, 0);
+	coarse.Adj.clear();
+	coarse.EdgeWeight.clear();
+	coarse.Weight.assign(count, 0);
+
+	std::vector<Index> position(count, None);
+	for(Index c = 0; c < count; ++c)
+	{
+		const Index rowStart = coarse.Adj.size();
+		for(Index m = memberPtr[c]; m < memberPtr[c+1]; ++m)
+		{
+			const Index i = members[m];
+			coarse.Weight[c] += g.Weight[i];
+
+			for(Index k = g.Ptr[i]; k < g.Ptr[i+1]; ++k)
+			{
+				const Index cj = map[g.Adj[k]];
+				if(cj == c)
+					continue;
+
+				if(position[cj] != None && position[cj] >= rowStart)
+				{
+					coarse.EdgeWeight[position[cj]] += g.EdgeWeight[k];
+				}
+				else
+				{
+					position[cj] = coarse.Adj.size();
+					coarse.Adj.push_back(cj);
+					coarse.EdgeWeight.push_back(g.EdgeWeight[k]);
+				}
+			}
+		}
+		coarse.Ptr[c + 1] = coarse.Adj.size();
+	}
+}
+
+inline void order_refine(const OrderGraph& g, std::vector<char>& part)
+{
+	const Index n = g.size();
+
+	Index total = 0;
+	Index maxWeight = 0;
+	Index sideWeight[2] = { 0, 0 };
+	for(Index i = 0; i < n; ++i)
+	{
+		total += g.Weight[i];
+		maxWeight = std::max(maxWeight, g.Weight[i]);
+		sideWeight[(int)part[i]] += g.Weight[i];
+	}
+
+	// Allow 5% imbalance
+	const Index limit = total/2 + total/40 + maxWeight;
+
+	for(int pass = 0; pass < 8; ++pass)
+	{
+		bool moved = false;
+		for(Index i = 0; i < n; ++i)
+		{
+			const int from = part[i];
+			const int to = 1 - from;
+
+			int64 gain = 0;
+			for(Index k = g.Ptr[i]; k < g.Ptr[i+1]; ++k)
+			{
+				if(part[g.Adj[k]] == from)
+					gain -= g.EdgeWeight[k];
+				else
+					gain += g.EdgeWeight[k];
+			}
+
+			const bool balances = sideWeight[from] > sideWeight[to] + g.Weight[i];
+			if(sideWeight[to] + g.Weight[i] <= limit &&
+				(gain > 0 || (gain == 0 && balances)))
+			{
+				part[i] = to;
+				sideWeight[from] -= g.Weight[i];
+				sideWeight[to] += g.Weight[i];
+				moved = true;
+			}
+		}
+
+		if(!moved)
+			break;
+	}
+}
+
+inline std::vector<char> order_bisect(const OrderGraph& g)
+{
+	const Index n = g.size();
+
+	OrderGraph coarse;
+	std::vector<Index> map;
+	if(n > 64)
+		order_coarsen(g, coarse, map);
+
+	std::vector<char> part(n, 1);
+	if(n > 64 && coarse.size() < n - n/10)
+	{
+		const std::vector<char> coarsePart = order_bisect(coarse);
+		for(Index i = 0; i < n; ++i)
+			part[i] = coarsePart[map[i]];
+	}
+	else
+	{
+		// Graph growing from a node far away from the first one
+		Index total = 0;
+		for(Index i = 0; i < n; ++i)
+			total += g.Weight[i];
+
+		std::vector<bool> visited(n, false);
+		std::vector<Index> queue;
+		queue.reserve(n);
+
+		Index start = 0;
+		queue.push_back(start);
+		visited[start] = true;
+		for(Index head = 0; head < queue.size(); ++head)
+		{
+			start = queue[head];
+			for(Index k = g.Ptr[start]; k < g.Ptr[start+1]; ++k)
+			{
+				if(!visited[g.Adj[k]])
+				{
+					visited[g.Adj[k]] = true;
+					queue.push_back(g.Adj[k]);
+				}
+			}
+		}
+
+		visited.assign(n, false);
+		queue.clear();
+		queue.push_back(start);
+		visited[start] = true;
+
+		Index grown = 0;
+		Index nextUnvisited = 0;
+		for(Index head = 0; grown < total/2; ++head)
+		{
+			if(head == queue.size())// Disconnected: Continue with another component
+			{
+				while(visited[nextUnvisited])
+					++nextUnvisited;
+				visited[nextUnvisited] = true;
+				queue.push_back(nextUnvisited);
+			}
+
+			const Index v = queue[head];
+			part[v] = 0;
+			grown += g.Weight[v];
+
+			for(Index k = g.Ptr[v]; k < g.Ptr[v+1]; ++k)
+			{
+				if(!visited[g.Adj[k]])
+				{
+					visited[g.Adj[k]] = true;
+					queue.push_back(g.Adj[k]);
+				}
+			}
+		}
+	}
+
+	order_refine(g, part);
+	return part;
+}
+
+inline void order_dissect(const OrderGraph& g, const std::vector<Index>& nodes, Index leafSize,
+	std::vector<Index>& local, std::vector<Index>& perm)
+{
+	const Index n = g.size();
+
+	const auto leaf = [&]()
+	{
+		for(Index i : order_minimum_degree(g))
+			perm.push_back(nodes[i]);
+	};
+
+	if(n <= leafSize)
+	{
+		leaf();
+		return;
+	}
+
+	std::vector<char> part = order_bisect(g);
+
+	// Vertex separator: The smaller boundary of both parts
+	Index boundary[2] = { 0, 0 };
+	std::vector<bool> isBoundary(n, false);
+	for(Index i = 0; i < n; ++i)
+	{
+		for(Index k = g.Ptr[i]; k < g.Ptr[i+1]; ++k)
+		{
+			if(part[g.Adj[k]] != part[i])
+			{
+				isBoundary[i] = true;
+				++boundary[(int)part[i]];
+				break;
+			}
+		}
+	}
+
+	const char separatorSide = boundary[0] <= boundary[1] ? 0 : 1;
+	std::vector<Index> sides[2];
+	std::vector<Index> separator;
+	for(Index i = 0; i < n; ++i)
+	{
+		if(isBoundary[i] && part[i] == separatorSide)
+			separator.push_back(i);
+		else
+			sides[(int)part[i]].push_back(i);
+	}
+
+	if(sides[0].empty() || sides[1].empty())
+	{
+		leaf();
+		return;
+	}
+
+	for(int s = 0; s < 2; ++s)
+	{
+		const OrderGraph sub = order_subgraph(g, sides[s], local);
+
+		std::vector<Index> subNodes(sides[s].size());
+		for(Index i = 0; i < sides[s].size(); ++i)
+			subNodes[i] = nodes[sides[s][i]];
+
+		order_dissect(sub, subNodes, leafSize, local, perm);
+	}
+
+	for(Index i : separator)
+		perm.push_back(nodes[i]);
+}
+
+template<typename T>
+DynamicVector<Index> approximate_minimum_degree(const SparseMatrix<T>& m)
+{
+	const std::vector<Index> order = order_minimum_degree(order_graph(m));
+
+	DynamicVector<Index> R(order.size());
+	for(Index i = 0; i < order.size(); ++i)
+		R[i] = order[i];
+
+	return R;
+}
+
+template<typename T>
+DynamicVector<Index> nested_dissection(const SparseMatrix<T>& m, Index leafSize)
+{
+	const OrderGraph g = order_graph(m);
+	const Index n = g.size();
+
+	std::vector<Index> nodes(n);
+	for(Index i = 0; i < n; ++i)
+		nodes[i] = i;
+
+	std::vector<Index> local(n, std::numeric_limits<Index>::max());
+	std::vector<Index> perm;
+	perm.reserve(n);
+	order_dissect(g, nodes, std::max<Index>(leafSize, 1), local, perm);
+
+	DynamicVector<Index> R(n);
+	for(Index i = 0; i < n; ++i)
+		R[i] = perm[i];
+
+	return R;
+}
+
 template<typename T>
 SparseMatrix<T> permutation_matrix(const DynamicVector<Index>& permutation)
 {
-	SparseMatrix<T> nm(permutation.size(), permutation.size());
-	for(Index i = 0; i < permutation.size(); ++i)
-		nm.set(i, permutation[i], (T)1);
-	return nm;
+	const Index n = permutation.size();
+
+	std::vector<typename SparseMatrix<T>::index_type> rowPtr(n + 1);
+	std::vector<typename SparseMatrix<T>::index_type> columnPtr(n);
+	std::vector<T> values(n, (T)1);
+	for(Index i = 0; i < n; ++i)
+	{
+		rowPtr[i] = i;
+		columnPtr[i] = permutation[i];
+	}
+	rowPtr[n] = n;
+
+	return SparseMatrix<T>(n, n, std::move(rowPtr), std::move(columnPtr), std::move(values));
 }
 
-DynamicVector<Index> inverse_permutation(const DynamicVector<Index>& permutation)
+inline DynamicVector<Index> inverse_permutation(const DynamicVector<Index>& permutation)
 {
 	DynamicVector<Index> np(permutation.size());
 	for(Index i = 0; i < permutation.size(); ++i)
@@ -124,7 +776,7 @@ DynamicVector<Index> inverse_permutation(const DynamicVector<Index>& permutation
 }
 
 template<typename T>
-SparseMatrix<T> permutate(const SparseMatrix<T>& m, const DynamicVector<Index>& permutation)
+SparseMatrix<T> permutate(const SparseMatrix<T>& m, const DynamicVector<Index>& permutation, size_t threads)
 {
 	if(m.rows() != m.columns())
 		throw NotSquareException();
@@ -132,8 +784,71 @@ SparseMatrix<T> permutate(const SparseMatrix<T>& m, const DynamicVector<Index>&
 	if(m.rows() != permutation.size())
 		throw MatrixMulMismatchException();
 
-	const auto P = permutation_matrix<T>(permutation);
-	return P.mul(m.mul(P.transpose()));
+	const Index n = m.rows();
+	const auto* rowPtr = m.row_ptr();
+	const auto* colPtr = m.column_ptr();
+	const T* values = m.value_ptr();
+
+	std::vector<Index> inverse(n);
+	for(Index i = 0; i < n; ++i)
+		inverse[permutation[i]] = i;
+
+	std::vector<typename SparseMatrix<T>::index_type> newRowPtr(n + 1, 0);
+	for(Index i = 0; i < n; ++i)
+		newRowPtr[i + 1] = SparseMatrix<T>::to_index(newRowPtr[i] + (rowPtr[permutation[i] + 1] - rowPtr[permutation[i]]));
+
+	std::vector<typename SparseMatrix<T>::index_type> newColPtr(newRowPtr[n]);
+	std::vector<T> newValues(newRowPtr[n]);
+
+	const auto permuteRows = [&](Index begin, Index end, Index)
+	{
+		for(Index i = begin; i < end; ++i)
+		{
+			const Index start = newRowPtr[i];
+			const Index size = newRowPtr[i + 1] - start;
+			const Index old = rowPtr[permutation[i]];
+
+			if(size > 64)
+			{
+				std::vector<std::pair<Index, T> > row(size);
+				for(Index k = 0; k < size; ++k)
+					row[k] = std::make_pair(inverse[colPtr[old + k]], values[old + k]);
+
+				std::sort(row.begin(), row.end(),
+					[](const std::pair<Index, T>& a, const std::pair<Index, T>& b) { return a.first < b.first; });
+
+				for(Index k = 0; k < size; ++k)
+				{
+					newColPtr[start + k] = row[k].first;
+					newValues[start + k] = row[k].second;
+				}
+				continue;
+			}
+
+			// Insertion sort while scattering; rows of typical matrices are short
+			for(Index k = 0; k < size; ++k)
+			{
+				const Index column = inverse[colPtr[old + k]];
+				const T value = values[old + k];
+
+				Index p = start + k;
+				for(; p > start && newColPtr[p - 1] > column; --p)
+				{
+					newColPtr[p] = newColPtr[p - 1];
+					newValues[p] = newValues[p - 1];
+				}
+				newColPtr[p] = column;
+				newValues[p] = value;
+			}
+		}
+	};
+
+	if(m.filled_count() < Parallel::SerialThreshold)
+		permuteRows(0, n, 0);
+	else
+		Parallel::for_range(0, n, permuteRows, threads);
+
+	return SparseMatrix<T>(n, n, std::move(newRowPtr), std::move(newColPtr), std::move(newValues));
 }
 
 template<typename T>
@@ -0,0 +1,254 @@
+#pragma once
+
+#include "Types.h"
+#include "Vector.h"
+#include "Utils.h"
+#include "Exceptions.h"
+#include "Parallel.h"
+
+#include "SparseMatrix.h"
+
+#include <algorithm>
+
+NS_BEGIN_NAMESPACE
+
+template<typename T, Dimension C>
+class SlicedEllpackMatrix;
+
+/**
+ * @brief An Iterator to traverse through one row of a sliced ELLPACK matrix.
+ * @tparam T Internal data type.
+ * @tparam C Chunk size of the matrix.
+ * @details This iterator can not be created outside of SlicedEllpackMatrix.
+ * Padding entries are skipped.
+ * @sa SlicedEllpackMatrix
+ */
+template<typename T, Dimension C>
+class SlicedEllpackMatrixRowIterator
+{
+private:
+	friend SlicedEllpackMatrix<T,C>;
+	SlicedEllpackMatrixRowIterator(const SlicedEllpackMatrix<T,C>& m, Index row, Index pos);
+
+public:
+	/**
+	* @brief Returns the current row.
+	*/
+	Index row() const
+	{
+		return mRow;
+	}
+
+	/**
+	* @brief Returns the current column.
+	*/
+	Index column() const;
+
+	/**
+	* @brief Checks if both iterators are equal.
+	* @param other The other iterator. Has to be from the same matrix.
+	*/
+	bool operator ==(const SlicedEllpackMatrixRowIterator& other) const
+	{
+		return mMatrix == other.mMatrix && mPos == other.mPos;
+	}
+
+	/**
+	* @brief Checks if both iterators are not equal.
+	* @param other The other iterator.
+	*/
+	bool operator !=(const SlicedEllpackMatrixRowIterator& other) const
+	{
+		return !(*this == other);
+	}
+
+	/**
+	* @brief Accessing the filled entry this iterator is pointing at.
+	* @return Returns the copy of the entry at the position `at(row(),column())`
+	*/
+	T operator *() const;
+
+	/**
+	* @brief Moves the iterator forward, from left to right.
+	* @return Reference to `this` iterator.
+	*/
+	SlicedEllpackMatrixRowIterator& operator++ ();
+
+	/**
+	* @brief Moves the iterator forward, from left to right.
+	* @return Copy of `this` iterator before moving forward.
+	*/
+	SlicedEllpackMatrixRowIterator operator++ (int);
+
+private:
+	const SlicedEllpackMatrix<T,C>* mMatrix;
+	Index mRow;
+	Index mPos;
+};
+
+/**
+ * @brief A read-only sparse matrix in the sliced ELLPACK (SELL-C-\f$\sigma\f$) format.
+ * @details The rows are grouped into chunks of C rows.
+ * Every chunk is padded to its longest row and stored column by column,
+ * so the C rows of a chunk are processed side by side in the matrix vector multiplication,
+ * which maps well to SIMD units even if the rows are short and irregular.\n
+ * To reduce the padding, the rows are sorted by their length inside windows of \f$\sigma\f$ rows.
+ * The permutation is hidden, all indices given to and returned by this class are the original ones.\n
+ * The matrix is created from a SparseMatrix and is meant as a faster layout for
+ * repeated matrix vector multiplications, like in CG or Iterative.
+ *
+ * @note All complexity values are calculated with all operations of T assumed to be of \f$ O(1) \f$ complexity.\n
+ * N is the amount of stored entries, including padding.
+ *
+ * @tparam T Internal data type.
+ * @tparam C Chunk size. Should be a multiple of the SIMD width of T.
+ * @sa SparseMatrix
+ */
+template<typename T, Dimension C = 8>
+class SlicedEllpackMatrix
+{
+	static_assert(C > 0, "Chunk size has to be greater than 0.");
+
+	friend SlicedEllpackMatrixRowIterator<T,C>;
+private:
+	std::vector<T> mValues;// Column major inside every chunk
+	std::vector<typename SparseMatrix<T>::index_type> mColumnPtr;
+	std::vector<Index> mChunkPtr;// Chunks+1 entries
+	std::vector<Index> mRowLength;// Without padding
+	std::vector<Index> mPermutation;// Sorted position -> original row
+	std::vector<Index> mInversePermutation;// Original row -> sorted position
+
+	Dimension mColumnCount;
+	Dimension mSortScope;
+
+public:
+	/**
+	* @brief The row iterator.
+	* @sa SlicedEllpackMatrixRowIterator
+	*/
+	typedef SlicedEllpackMatrixRowIterator<T,C> row_iterator;
+
+	/**
+	* @brief A const variant of the row iterator.
+	* @sa SlicedEllpackMatrixRowIterator
+	*/
+	typedef const SlicedEllpackMatrixRowIterator<T,C> const_row_iterator;
+
+	/**
+	* @brief A typedef of the underlying value type.
+	*/
+	typedef T value_type;
+
+	/**
+	* @brief A typedef of the index type used for the columns, the same as in SparseMatrix.
+	*/
+	typedef typename SparseMatrix<T>::index_type index_type;
+
+	/**
+	* @brief Chunk size of the matrix.
+	*/
+	static constexpr Dimension ChunkSize = C;
+
+	/**
+	* @brief Constructs the matrix from a sparse matrix.
+	* @par Complexity
+	* Always: \f$ O(D1 \log \sigma + N) \f$
+	* @param m The sparse matrix.
+	* @param sortScope The window \f$\sigma\f$ in which rows are sorted by their length.
+	* 1 keeps the original order, the row count sorts all rows.
+	*/
+	explicit SlicedEllpackMatrix(const SparseMatrix<T>& m, Dimension sortScope = 32*C);
+
+	virtual ~SlicedEllpackMatrix();
+
+	/**
+	* @brief Returns a row iterator pointing at the first entry at the given row.
+	* @par Complexity
+	* Always: \f$ O(1) \f$
+	* @param i Index of the row.
+	*/
+	const_row_iterator row_begin(Index i) const;
+
+	/**
+	* @brief Returns a row iterator representing the end of the row.
+	* @note This iterator can not be dereferenced.
+	* @par Complexity
+	* Always: \f$ O(1) \f$
+	* @param i Index of the row.
+	*/
+	const_row_iterator row_end(Index i) const;
+
+	/**
+	* @brief Returns a copy of the value at the respective location.
+	* @par Complexity
+	* Worst case: \f$ O(D2) \f$
+	* @param i Index of the row.
+	* @param j Index of the column.
+	* @return Copy of the value at \f$ A_{ij} \f$
+	*/
+	T at(Index i, Index j) const;
+
+	/**
+	* @brief The column count
+	* @par Complexity
+	* Always: \f$ O(1) \f$
+	* @return D2
+	*/
+	Dimension columns() const;
+
+	/**
+	* @brief The row count
+	* @par Complexity
+	* Always: \f$ O(1) \f$
+	* @return D1
+	*/
+	Dimension rows() const;
+
+	/**
+	* @brief The amount of stored entries without padding.
+	* @par Complexity
+	* Worst case: \f$ O(D1) \f$
+	*/
+	Dimension filled_count() const;
+
+	/**
+	* @brief The amount of stored entries including padding.
+	* @details The ratio to filled_count() shows how well the matrix fits this format.
+	* @par Complexity
+	* Always: \f$ O(1) \f$
+	*/
+	Dimension storage_count() const;
+
+	/**
+	* @brief The adjugate / conjugate transpose of the matrix, with the same sort scope.
+	* @par Complexity
+	* Always: \f$ O(D1+D2+N) \f$
+	* @return Conjugate transpose of the matrix \f$ A^* \f$
+	*/
+	SlicedEllpackMatrix adjugate() const;
+
+	/**
+	* @brief Right side matrix vector multiplication.
+	* @details The chunks are distributed over multiple threads if the matrix has at least
+	* Parallel::SerialThreshold filled entries.
+	* @par Complexity
+	* Always: \f$ O(D1+N) \f$
+	* @param right A vector with the same size as the column count of the matrix.
+	* @param threads Amount of threads to use. 0 uses Parallel::thread_count().
+	* @return A vector with the same size as the row count.
+	*/
+	template<typename DC>
+	DynamicVector<T> mul(const Vector<T,DC>& right, size_t threads = 0) const;
+};
+
+// Comparison
+template<typename T, Dimension C>
+bool operator ==(const SlicedEllpackMatrix<T,C>& v1, const SlicedEllpackMatrix<T,C>& v2);
+template<typename T, Dimension C>
+bool operator !=(const SlicedEllpackMatrix<T,C>& v1, const SlicedEllpackMatrix<T,C>& v2);
+
+NS_END_NAMESPACE
+
+#define _NS_SLICEDELLPACKMATRIX_INL
+# include "SlicedEllpackMatrix.inl"
+#undef _NS_SLICEDELLPACKMATRIX_INL
\ No newline at end of file
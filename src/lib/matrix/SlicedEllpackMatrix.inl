@@ -0,0 +1,289 @@
+#ifndef _NS_SLICEDELLPACKMATRIX_INL
+# error SlicedEllpackMatrix.inl should only be included by SlicedEllpackMatrix.h
+#endif
+
+NS_BEGIN_NAMESPACE
+
+// Iterator
+template<typename T, Dimension C>
+SlicedEllpackMatrixRowIterator<T,C>::SlicedEllpackMatrixRowIterator(const SlicedEllpackMatrix<T,C>& m, Index row, Index pos) :
+	mMatrix(&m), mRow(row), mPos(pos)
+{
+}
+
+template<typename T, Dimension C>
+Index SlicedEllpackMatrixRowIterator<T,C>::column() const
+{
+	return mMatrix->mColumnPtr[mPos];
+}
+
+template<typename T, Dimension C>
+T SlicedEllpackMatrixRowIterator<T,C>::operator *() const
+{
+	return mMatrix->mValues[mPos];
+}
+
+template<typename T, Dimension C>
+SlicedEllpackMatrixRowIterator<T,C>& SlicedEllpackMatrixRowIterator<T,C>::operator++ ()
+{
+	mPos += C;// Entries of a row are C apart
+	return *this;
+}
+
+template<typename T, Dimension C>
+SlicedEllpackMatrixRowIterator<T,C> SlicedEllpackMatrixRowIterator<T,C>::operator++ (int)
+{
+	auto c = *this;
+	this->operator++ ();
+	return c;
+}
+
+// Main
+template<typename T, Dimension C>
+constexpr Dimension SlicedEllpackMatrix<T,C>::ChunkSize;
+
+template<typename T, Dimension C>
+SlicedEllpackMatrix<T,C>::SlicedEllpackMatrix(const SparseMatrix<T>& m, Dimension sortScope) :
+	mColumnCount(m.columns()), mSortScope(sortScope)
+{
+	NS_ASSERT(sortScope > 0);
+	static_assert(is_number<T>::value, "Type T has to be a number.\nAllowed are std::complex and the types allowed by std::is_floating_point.");
+
+	const Index n = m.rows();
+	const Index chunks = (n + C - 1) / C;
+	const index_type* rowPtr = m.row_ptr();
+
+	// Sort the rows by length inside every window, a stable sort keeps the original order of equal rows
+	mPermutation.resize(n);
+	for (Index i = 0; i < n; ++i)
+		mPermutation[i] = i;
+
+	for (Index start = 0; start < n; start += sortScope)
+	{
+		std::stable_sort(mPermutation.begin() + start, mPermutation.begin() + std::min(n, start + sortScope),
+			[&](Index a, Index b) { return rowPtr[a + 1] - rowPtr[a] > rowPtr[b + 1] - rowPtr[b]; });
+	}
+
+	mInversePermutation.resize(n);
+	mRowLength.resize(n);
+	for (Index p = 0; p < n; ++p)
+	{
+		mInversePermutation[mPermutation[p]] = p;
+		mRowLength[p] = rowPtr[mPermutation[p] + 1] - rowPtr[mPermutation[p]];
+	}
+
+	mChunkPtr.resize(chunks + 1, 0);
+	for (Index c = 0; c < chunks; ++c)
+	{
+		const Index last = std::min(n, (c + 1)*C);
+		const Index width = *std::max_element(mRowLength.begin() + c*C, mRowLength.begin() + last);
+		mChunkPtr[c + 1] = mChunkPtr[c] + width*C;
+	}
+
+	// Padding has a value of 0 and points at a column already used by the row to stay in cache
+	mValues.resize(mChunkPtr.back(), (T)0);
+	mColumnPtr.resize(mChunkPtr.back(), 0);
+	for (Index p = 0; p < n; ++p)
+	{
+		const Index c = p / C;
+		const Index width = (mChunkPtr[c + 1] - mChunkPtr[c]) / C;
+		const Index row = mPermutation[p];
+		const Index start = mChunkPtr[c] + p % C;
+
+		Index k = 0;
+		for (Index q = rowPtr[row]; q < rowPtr[row + 1]; ++q, ++k)
+		{
+			mValues[start + k*C] = m.value_ptr()[q];
+			mColumnPtr[start + k*C] = m.column_ptr()[q];
+		}
+
+		const Index pad = k > 0 ? mColumnPtr[start + (k - 1)*C] : 0;
+		for (; k < width; ++k)
+			mColumnPtr[start + k*C] = pad;
+	}
+}
+
+template<typename T, Dimension C>
+SlicedEllpackMatrix<T,C>::~SlicedEllpackMatrix()
+{
+}
+
+template<typename T, Dimension C>
+typename SlicedEllpackMatrix<T,C>::const_row_iterator SlicedEllpackMatrix<T,C>::row_begin(Index i) const
+{
+	NS_ASSERT(i < rows());
+
+	const Index p = mInversePermutation[i];
+	return SlicedEllpackMatrixRowIterator<T,C>(*this, i, mChunkPtr[p / C] + p % C);
+}
+
+template<typename T, Dimension C>
+typename SlicedEllpackMatrix<T,C>::const_row_iterator SlicedEllpackMatrix<T,C>::row_end(Index i) const
+{
+	NS_ASSERT(i < rows());
+
+	const Index p = mInversePermutation[i];
+	return SlicedEllpackMatrixRowIterator<T,C>(*this, i, mChunkPtr[p / C] + p % C + mRowLength[p]*C);
+}
+
+template<typename T, Dimension C>
+T SlicedEllpackMatrix<T,C>::at(Index i, Index j) const
+{
+	for (auto it = row_begin(i); it != row_end(i); ++it)// O(D2)
+	{
+		if (it.column() == j)
+			return *it;
+		else if (it.column() > j)
+			break;
+	}
+
+	return (T)0;
+}
+
+template<typename T, Dimension C>
+Dimension SlicedEllpackMatrix<T,C>::columns() const
+{
+	return mColumnCount;
+}
+
+template<typename T, Dimension C>
+Dimension SlicedEllpackMatrix<T,C>::rows() const
+{
+	return mPermutation.size();
+}
+
+template<typename T, Dimension C>
+Dimension SlicedEllpackMatrix<T,C>::filled_count() const
+{
+	Dimension count = 0;
+	for (Index l : mRowLength)
+		count += l;
+
+	return count;
+}
+
+template<typename T, Dimension C>
+Dimension SlicedEllpackMatrix<T,C>::storage_count() const
+{
+	return mValues.size();
+}
+
+template<typename T, Dimension C>
+SlicedEllpackMatrix<T,C> SlicedEllpackMatrix<T,C>::adjugate() const
+{
+	const Index n = rows();
+	const Index m = columns();
+
+	// Counting sort by column; scattering the rows in order keeps the new rows sorted
+	std::vector<index_type> rowPtr(m + 1, 0);
+	for (Index i = 0; i < n; ++i)
+		for (auto it = row_begin(i); it != row_end(i); ++it)
+			++rowPtr[it.column() + 1];
+	for (Index j = 0; j < m; ++j)
+		rowPtr[j + 1] += rowPtr[j];
+
+	std::vector<index_type> columnPtr(rowPtr.back());
+	std::vector<T> values(rowPtr.back());
+	std::vector<index_type> next(rowPtr.begin(), rowPtr.end() - 1);
+	for (Index i = 0; i < n; ++i)
+	{
+		for (auto it = row_begin(i); it != row_end(i); ++it)
+		{
+			const Index q = next[it.column()]++;
+			columnPtr[q] = i;
+			values[q] = complex_conj(*it);
+		}
+	}
+
+	return SlicedEllpackMatrix<T,C>(SparseMatrix<T>(m, n, std::move(rowPtr), std::move(columnPtr), std::move(values)), mSortScope);
+}
+
+template<typename T, Dimension C>
+template<typename DC>
+DynamicVector<T> SlicedEllpackMatrix<T,C>::mul(const Vector<T,DC>& v, size_t threads) const
+{
+	if (columns() != v.size())
+		throw MatrixMulMismatchException();
+
+	const Index n = rows();
+
+	DynamicVector<T> r;
+	r.resize(n);
+
+	if (mValues.size() < Parallel::SerialThreshold)
+		threads = 1;
+
+	const T* x = &v[0];
+	T* y = &r[0];
+	Parallel::for_range(0, mChunkPtr.size() - 1, [&](Index begin, Index end, Index)
+	{
+		T s[C];
+		for (Index c = begin; c < end; ++c)
+		{
+			std::fill(s, s + C, (T)0);
+
+			const Index width = (mChunkPtr[c + 1] - mChunkPtr[c]) / C;
+			const T* a = mValues.data() + mChunkPtr[c];
+			const index_type* col = mColumnPtr.data() + mChunkPtr[c];
+
+			// The C rows of the chunk are independent lanes
+			for (Index k = 0; k < width; ++k)
+				for (Index l = 0; l < C; ++l)
+					s[l] += a[k*C + l] * x[col[k*C + l]];
+
+			const Index last = std::min(C, n - c*C);
+			for (Index l = 0; l < last; ++l)
+				y[mPermutation[c*C + l]] = s[l];
+		}
+	}, threads);
+
+	return r;
+}
+
+template<typename T, Dimension C>
+bool operator ==(const SlicedEllpackMatrix<T,C>& v1, const SlicedEllpackMatrix<T,C>& v2)
+{
+	if (v1.rows() != v2.rows() || v1.columns() != v2.columns())
+		return false;
+
+	// Merge every row, entries only present in one of the matrices have to be zero
+	for (Index i = 0; i < v1.rows(); ++i)
+	{
+		auto it1 = v1.row_begin(i);
+		auto it2 = v2.row_begin(i);
+		const auto e1 = v1.row_end(i);
+		const auto e2 = v2.row_end(i);
+		while (it1 != e1 || it2 != e2)
+		{
+			if (it2 == e2 || (it1 != e1 && it1.column() < it2.column()))
+			{
+				if (*it1 != (T)0)
+					return false;
+				++it1;
+			}
+			else if (it1 == e1 || it2.column() < it1.column())
+			{
+				if (*it2 != (T)0)
+					return false;
+				++it2;
+			}
+			else
+			{
+				if (*it1 != *it2)
+					return false;
+				++it1;
+				++it2;
+			}
+		}
+	}
+
+	return true;
+}
+
+template<typename T, Dimension C>
+bool operator !=(const SlicedEllpackMatrix<T,C>& v1, const SlicedEllpackMatrix<T,C>& v2)
+{
+	return !(v1 == v2);
+}
+
+NS_END_NAMESPACE
\ No newline at end of file
@@ -9,23 +9,24 @@
 
 NS_BEGIN_NAMESPACE
 
-template<typename T>
-class SparseMatrix;
+template<typename T, typename I = uint32>
+class BasicSparseMatrix;
 
 /**
  * @brief An Iterator to traverse through the filled entries of a sparse matrix.
  * @tparam T Internal data type.
+ * @tparam I Index type of the sparse matrix.
  * @details This iterator can not be created outside of SparseMatrix.
  * @sa SparseMatrix
  * @sa SparseMatrixRowIterator
  * @sa SparseMatrixColumnIterator
  */
-template<typename T>
+template<typename T, typename I = uint32>
 class SparseMatrixIterator
 {
 protected:
-	friend SparseMatrix<T>;
-	SparseMatrixIterator(const SparseMatrix<T>& m, Index i1, Index i2);
+	friend BasicSparseMatrix<T,I>;
+	SparseMatrixIterator(const BasicSparseMatrix<T,I>& m, Index i1, Index i2);
 
 public:
 	/** 
@@ -116,7 +117,7 @@ public:
 	SparseMatrixIterator operator++ (int);
 
 protected:
-	const SparseMatrix<T>* mMatrix;
+	const BasicSparseMatrix<T,I>* mMatrix;
 	Index mIndex1;
 	Index mIndex2;
 	Index mColumnPtrIndex;
@@ -125,17 +126,18 @@ protected:
 /**
 * @brief An Iterator to traverse through one row of a sparse matrix.
 * @tparam T Internal data type.
+* @tparam I Index type of the sparse matrix.
 * @details This iterator can not be created outside of SparseMatrix.
 * @sa SparseMatrix
 * @sa SparseMatrixIterator
 * @sa SparseMatrixColumnIterator
 */
-template<typename T>
-class SparseMatrixRowIterator : public SparseMatrixIterator<T>
+template<typename T, typename I = uint32>
+class SparseMatrixRowIterator : public SparseMatrixIterator<T,I>
 {
 private:
-	friend SparseMatrix<T>;
-	SparseMatrixRowIterator(const SparseMatrix<T>& m, Index i1, Index i2);
+	friend BasicSparseMatrix<T,I>;
+	SparseMatrixRowIterator(const BasicSparseMatrix<T,I>& m, Index i1, Index i2);
 
 public:
 	/**
@@ -159,17 +161,18 @@ public:
 * @brief An Iterator to traverse through one column of a sparse matrix.
 * @attention This iterator type does not give you any performance benefits. Use Row or Standard if possible.
 * @tparam T Internal data type.
+* @tparam I Index type of the sparse matrix.
 * @details This iterator can not be created outside of SparseMatrix.
 * @sa SparseMatrix
 * @sa SparseMatrixIterator
 * @sa SparseMatrixRowIterator
 */
-template<typename T>
-class SparseMatrixColumnIterator : public SparseMatrixIterator<T>
+template<typename T, typename I = uint32>
+class SparseMatrixColumnIterator : public SparseMatrixIterator<T,I>
 {
 private:
-	friend SparseMatrix<T>;
-	SparseMatrixColumnIterator(const SparseMatrix<T>& m, Index i1, Index i2);
+	friend BasicSparseMatrix<T,I>;
+	SparseMatrixColumnIterator(const BasicSparseMatrix<T,I>& m, Index i1, Index i2);
 
 public:
 	/**
@@ -194,7 +197,11 @@ public:
  * @details A sparse matrix is most of the time the right decision,
  * but for little sized matrices a dense Matrix implementation is recommended.\n
  * Internally it uses the CRS (Compressed Row Storage) method.\n
- * Using the row iterator or the standard iterator is recommend over direct access or the column iterator.
+ * Using the row iterator or the standard iterator is recommend over direct access or the column iterator.\n
+ * The CRS index arrays use the index type I. The default 32 bit indices halve the index traffic
+ * of the matrix vector multiplication compared to 64 bit indices and are enough as long as
+ * the dimensions and the amount of filled entries fit into them, otherwise an IndexOverflowException is thrown.
+ * Use `BasicSparseMatrix<T,uint64>` for larger matrices and DeltaCodedSparseMatrix for a compressed read-only variant.
  *
  * @par Topological Order
  * The order of the entries is from left to right, and then from top to down.\n
@@ -205,18 +212,22 @@ public:
  * @note All complexity values are calculated with all operations of T assumed to be of \f$ O(1) \f$ complexity.
  *
  * @tparam T Internal data type.
+ * @tparam I Unsigned integer type of the CRS index arrays.
  * @sa Matrix
+ * @sa SparseMatrix
  */
-template<typename T>
-class SparseMatrix
+template<typename T, typename I>
+class BasicSparseMatrix
 {
-	friend SparseMatrixIterator<T>;
-	friend SparseMatrixRowIterator<T>;
-	friend SparseMatrixColumnIterator<T>;
+	static_assert(std::is_integral<I>::value && std::is_unsigned<I>::value, "Type I has to be an unsigned integer.");
+
+	friend SparseMatrixIterator<T,I>;
+	friend SparseMatrixRowIterator<T,I>;
+	friend SparseMatrixColumnIterator<T,I>;
 private:
 	std::vector<T> mValues;
-	std::vector<Index> mColumnPtr;
-	std::vector<Index> mRowPtr;
+	std::vector<I> mColumnPtr;
+	std::vector<I> mRowPtr;// D1+1 entries, the last one is the amount of filled entries
 
 	Dimension mColumnCount;
 
@@ -233,55 +244,61 @@ public:
 	 * @brief The standard iterator.
 	 * @sa SparseMatrixIterator
 	 */
-	typedef SparseMatrixIterator<T> iterator;
+	typedef SparseMatrixIterator<T,I> iterator;
 
 	/**
 	* @brief A const variant of the standard iterator.
 	* @sa SparseMatrixIterator
 	*/
-	typedef const SparseMatrixIterator<T> const_iterator;
+	typedef const SparseMatrixIterator<T,I> const_iterator;
 
 	/**
 	* @brief The row iterator.
 	* @sa SparseMatrixRowIterator
 	*/
-	typedef SparseMatrixRowIterator<T> row_iterator;
+	typedef SparseMatrixRowIterator<T,I> row_iterator;
 
 	/**
 	* @brief A const variant of the row iterator.
 	* @sa SparseMatrixRowIterator
 	*/
-	typedef const SparseMatrixRowIterator<T> const_row_iterator;
+	typedef const SparseMatrixRowIterator<T,I> const_row_iterator;
 
 	/**
 	* @brief The column iterator.
 	* @sa SparseMatrixIterator
 	*/
-	typedef SparseMatrixColumnIterator<T> column_iterator;
+	typedef SparseMatrixColumnIterator<T,I> column_iterator;
 
 	/**
 	* @brief A const variant of the column iterator.
 	* @sa SparseMatrixIterator
 	*/
-	typedef const SparseMatrixColumnIterator<T> const_column_iterator;
+	typedef const SparseMatrixColumnIterator<T,I> const_column_iterator;
 
 	/**
 	* @brief A typedef of the underlying value type.
 	*/
 	typedef T value_type;
 
+	/**
+	* @brief A typedef of the index type used in the CRS arrays.
+	*/
+	typedef I index_type;
+
 	/**
 	* @brief Constructs an empty sparse matrix of zero size (Not useful)
 	 */
-	SparseMatrix();
+	BasicSparseMatrix();
 
 	/**
 	* @brief Constructs an empty sparse matrix of size(d1,d2)
 	* @param d1 Row dimension
 	* @param d2 Column dimension
 	* @param expected How much entries are expected. Gives performance benefits if known. Keep it 0 if unknown.
+	* @throw IndexOverflowException if a dimension does not fit into I.
 	 */
-	SparseMatrix(Dimension d1, Dimension d2, size_t expected = 0);
+	BasicSparseMatrix(Dimension d1, Dimension d2, size_t expected = 0);
 
 	/**
 	 * @brief Constructs a sparse matrix from the two dimensional initializer list.
@@ -297,9 +314,44 @@ public:
 	 * @param list A two dimensional initializer list.
 	 * @throw MatrixInitializerListFailedException
 	 */
-	SparseMatrix(std::initializer_list<std::initializer_list<T> > list);
+	BasicSparseMatrix(std::initializer_list<std::initializer_list<T> > list);
+
+	/**
+	* @brief Constructs a sparse matrix directly from CRS arrays.
+	* @details The entries of row `i` are at the positions `[rowPtr[i], rowPtr[i+1])`
+	* in columnPtr and values. The column indices of every row have to be sorted.\n
+	* Explicitly given zeros are kept as filled entries.
+	* @param d1 Row dimension
+	* @param d2 Column dimension
+	* @param rowPtr Row offsets with d1+1 entries.
+	* @param columnPtr Column index of every entry.
+	* @param values Value of every entry.
+	* @throw IndexOverflowException if a dimension or the amount of entries does not fit into I.
+	* @sa to_index()
+	*/
+	BasicSparseMatrix(Dimension d1, Dimension d2,
+		std::vector<index_type>&& rowPtr, std::vector<index_type>&& columnPtr, std::vector<T>&& values);
 
-	virtual ~SparseMatrix();
+	/**
+	* @brief Constructs a sparse matrix from CRS arrays with a different index type.
+	* @details Same as the constructor above, but the index arrays are converted to I.
+	* @par Complexity
+	* Always: \f$ O(D1+N) \f$ with N the amount of filled entries
+	* @throw IndexOverflowException if a dimension or the amount of entries does not fit into I.
+	*/
+	template<typename J>
+	BasicSparseMatrix(Dimension d1, Dimension d2,
+		const std::vector<J>& rowPtr, const std::vector<J>& columnPtr, std::vector<T>&& values);
+
+	virtual ~BasicSparseMatrix();
+
+	/**
+	* @brief Converts an entry offset to the index type.
+	* @details Meant for functions building the CRS arrays directly,
+	* which should convert the row offsets with it instead of casting them.
+	* @throw IndexOverflowException if the offset does not fit into I.
+	*/
+	static index_type to_index(size_t offset);
 
 	/**
 	* @brief Resize dimension of the matrix.
@@ -557,7 +609,7 @@ public:
 	* @return A reference to this matrix.
 	* @todo Is there a better approach, without using set(i,j,v)?
 	*/
-	SparseMatrix& operator +=(const SparseMatrix& m);
+	BasicSparseMatrix& operator +=(const BasicSparseMatrix& m);
 
 	/**
 	* @brief Subtracts entries element wise.
@@ -567,7 +619,7 @@ public:
 	* @return A reference to this matrix.
 	* @todo Is there a better approach, without using set(i,j,v)?
 	*/
-	SparseMatrix& operator -=(const SparseMatrix& m);
+	BasicSparseMatrix& operator -=(const BasicSparseMatrix& m);
 
 	/**
 	* @brief Multiplies entries element wise.
@@ -579,7 +631,7 @@ public:
 	* @return A reference to this matrix.
 	* @todo Is there a better approach?
 	*/
-	SparseMatrix& operator *=(const SparseMatrix& m);
+	BasicSparseMatrix& operator *=(const BasicSparseMatrix& m);
 
 	/**
 	* @brief Multiplies entries with a scalar.
@@ -589,7 +641,7 @@ public:
 	* @return A reference to this matrix.
 	* @todo Is there a better approach?
 	*/
-	SparseMatrix& operator *=(const T& f);
+	BasicSparseMatrix& operator *=(const T& f);
 
 	/**
 	* @brief The column count
@@ -677,7 +729,7 @@ public:
 	* Always: \f$ O(1) \f$
 	* @param m The other matrix.
 	*/
-	void swap(SparseMatrix& m);
+	void swap(BasicSparseMatrix& m);
 
 	/**
 	* @brief Returns true if matrix has NaN entries
@@ -695,6 +747,34 @@ public:
 	*/
 	bool has_inf() const;
 
+	/**
+	* @brief Direct access to the CRS value array with filled_count() entries.
+	* @note Setting a value to 0 through this pointer keeps the entry filled.
+	* @par Complexity
+	* Always: \f$ O(1) \f$
+	*/
+	const T* value_ptr() const;
+
+	/**
+	* @copydoc value_ptr() const
+	*/
+	T* value_ptr();
+
+	/**
+	* @brief Direct access to the CRS column indices with filled_count() entries.
+	* @par Complexity
+	* Always: \f$ O(1) \f$
+	*/
+	const index_type* column_ptr() const;
+
+	/**
+	* @brief Direct access to the CRS row offsets with rows()+1 entries.
+	* @details The entries of row `i` are at `[row_ptr()[i], row_ptr()[i+1])`.
+	* @par Complexity
+	* Always: \f$ O(1) \f$
+	*/
+	const index_type* row_ptr() const;
+
 	/**
 	* @brief Returns true if matrix has a entry with 0.
 	* @par Complexity
@@ -716,13 +796,13 @@ public:
 	/**
 	* @brief Transpose matrix.
 	* @par Complexity
-	* Worst case: \f$ O((D1*D2)^2) \f$
+	* Always: \f$ O(D1+D2+N) \f$ with N the amount of filled entries
 	* @note When using complex matrices most of the time you need the adjugate() operation,\n
 	* as it is the most reasonable one in most of the cases. (Consider looking at your script)
 	* @return Transpose of the matrix \f$ A^T \f$
 	* @sa adjugate()
 	*/
-	SparseMatrix transpose() const;
+	BasicSparseMatrix transpose() const;
 
 	/**
 	* @brief The conjugate of all entries if complex.
@@ -730,17 +810,17 @@ public:
 	* Worst case: \f$ O((D1*D2)^2) \f$
 	* @return Transpose of the matrix \f$ A^T \f$
 	*/
-	SparseMatrix conjugate() const;
+	BasicSparseMatrix conjugate() const;
 
 	/**
 	* @brief The adjugate / conjugate transpose of the matrix.
 	* @note If the matrix has no complex entries, it is the same as transpose().
 	* @par Complexity
-	* Worst case: \f$ O((D1*D2)^2) \f$
+	* Always: \f$ O(D1+D2+N) \f$ with N the amount of filled entries
 	* @return Conjugate transpose of the matrix \f$ A^* \f$
 	* @sa transpose()
 	*/
-	SparseMatrix adjugate() const;
+	BasicSparseMatrix adjugate() const;
 
 	/**
 	* @brief Returns the trace of the matrix.
@@ -760,56 +840,65 @@ public:
 	* \f[
 	* A.mul(B) := A \cdot B \textrm{ with } A \in T^{D1 \times D2} \times B \in T^{D2 \times D3} \to C \in T^{D1 \times D3}
 	* \f]
+	* Uses the row by row algorithm of Gustavson with a dense accumulator.
 	* @par Complexity
-	* Worst case: \f$ O(D1*D3*(D1*D3+D2^2+D2*D3)) \f$
+	* Worst case: \f$ O(D1+D3+F+D1 R \log R) \f$ with F the amount of scalar multiplications and R the longest result row
 	* @param right The other sparse matrix, which row count must match the column count of this matrix.
 	* @return The result of the matrix multiplication.
-	* @todo This method is critical. A sparse solution is needed.
 	*/
-	SparseMatrix mul(const SparseMatrix& right) const;
+	BasicSparseMatrix mul(const BasicSparseMatrix& right) const;
 
 	/**
 	* @brief Right side matrix vector multiplication.
+	* @details The vector may have a different precision U than the matrix, like a float matrix with a double vector.
+	* The products are accumulated in U.
 	* @par Complexity
-	* Worst case: \f$ O(D1*D2*(D1+D2)) \f$
+	* Worst case: \f$ O(D1+N) \f$ with N the amount of filled entries
 	* @param right A vector with the same size as the column count of the matrix.
 	* @return A vector with the same size as the row count.
-	* @todo This method is critical. A better sparse solution is needed.
 	*/
-	template<typename DC>
-	DynamicVector<T> mul(const Vector<T,DC>& right) const;
+	template<typename U, typename DC>
+	DynamicVector<U> mul(const Vector<U,DC>& right) const;
 
 	/**
 	* @brief Left side matrix vector multiplication.
 	* @par Complexity
-	* Worst case: \f$ O(D1*D2*(D1+D2)) \f$
+	* Worst case: \f$ O(D1+D2+N) \f$ with N the amount of filled entries
 	* @param left A vector with the same size as the row count of the matrix.
 	* @return A vector with the same size as the column count.
-	* @todo This method is critical. A better sparse solution is needed.
 	*/
 	template<typename DC>
 	DynamicVector<T> mul_left(const Vector<T,DC>& left) const;
 };
 
-// Element wise operations
-template<typename T>
-SparseMatrix<T> operator +(const SparseMatrix<T>& v1, const SparseMatrix<T>& v2);
-template<typename T>
-SparseMatrix<T> operator -(const SparseMatrix<T>& v1, const SparseMatrix<T>& v2);
-template<typename T>
-SparseMatrix<T> operator -(const SparseMatrix<T>& v);
-template<typename T>
-SparseMatrix<T> operator *(const SparseMatrix<T>& v1, const SparseMatrix<T>& v2);
-template<typename T>
-SparseMatrix<T> operator *(const SparseMatrix<T>& v1, T f);
+/**
+ * @brief The sparse matrix with the default 32 bit index type.
+ * @details An alias instead of a default template argument keeps SparseMatrix usable
+ * as a template template argument of functions like Construct::eye.
+ * @sa BasicSparseMatrix
+ */
 template<typename T>
-SparseMatrix<T> operator *(T f, const SparseMatrix<T>& v1);
+using SparseMatrix = BasicSparseMatrix<T, uint32>;
+
+// Element wise operations
+template<typename T, typename I>
+BasicSparseMatrix<T,I> operator +(const BasicSparseMatrix<T,I>& v1, const BasicSparseMatrix<T,I>& v2);
+template<typename T, typename I>
+BasicSparseMatrix<T,I> operator -(const BasicSparseMatrix<T,I>& v1, const BasicSparseMatrix<T,I>& v2);
+template<typename T, typename I>
+BasicSparseMatrix<T,I> operator -(const BasicSparseMatrix<T,I>& v);
+template<typename T, typename I>
+BasicSparseMatrix<T,I> operator *(const BasicSparseMatrix<T,I>& v1, const BasicSparseMatrix<T,I>& v2);
+template<typename T, typename I>
+BasicSparseMatrix<T,I> operator *(const BasicSparseMatrix<T,I>& v1, T f);
+template<typename T, typename I>
+BasicSparseMatrix<T,I> operator *(T f, const BasicSparseMatrix<T,I>& v1);
 
 // Comparison
-template<typename T>
-bool operator ==(const SparseMatrix<T>& v1, const SparseMatrix<T>& v2);
-template<typename T>
-bool operator !=(const SparseMatrix<T>& v1, const SparseMatrix<T>& v2);
+template<typename T, typename I>
+bool operator ==(const BasicSparseMatrix<T,I>& v1, const BasicSparseMatrix<T,I>& v2);
+template<typename T, typename I>
+bool operator !=(const BasicSparseMatrix<T,I>& v1, const BasicSparseMatrix<T,I>& v2);
 
 NS_END_NAMESPACE
 
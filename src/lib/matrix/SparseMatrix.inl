@@ -5,8 +5,8 @@
 NS_BEGIN_NAMESPACE
 
 // Iterator
-template<typename T>
-SparseMatrixIterator<T>::SparseMatrixIterator(const SparseMatrix<T>& m, Index i1, Index i2) :
+template<typename T, typename I>
+SparseMatrixIterator<T,I>::SparseMatrixIterator(const BasicSparseMatrix<T,I>& m, Index i1, Index i2) :
 	mMatrix(&m), mIndex1(i1), mIndex2(i2), mColumnPtrIndex(0)
 {
 	if (isValid())
@@ -17,8 +17,8 @@ SparseMatrixIterator<T>::SparseMatrixIterator(const SparseMatrix<T>& m, Index i1
 	}
 }
 
-template<typename T>
-SparseMatrixIterator<T>& SparseMatrixIterator<T>::operator++ ()
+template<typename T, typename I>
+SparseMatrixIterator<T,I>& SparseMatrixIterator<T,I>::operator++ ()
 {
 	if (isValid())
 	{
@@ -49,16 +49,16 @@ SparseMatrixIterator<T>& SparseMatrixIterator<T>::operator++ ()
 	return *this;
 }
 
-template<typename T>
-SparseMatrixIterator<T> SparseMatrixIterator<T>::operator++ (int)
+template<typename T, typename I>
+SparseMatrixIterator<T,I> SparseMatrixIterator<T,I>::operator++ (int)
 {
 	auto c = *this;
 	this->operator++ ();
 	return c;
 }
 
-template<typename T>
-T SparseMatrixIterator<T>::operator *() const
+template<typename T, typename I>
+T SparseMatrixIterator<T,I>::operator *() const
 {
 	if (isValid())
 	{
@@ -70,29 +70,29 @@ T SparseMatrixIterator<T>::operator *() const
 	}
 }
 
-template<typename T>
-T& SparseMatrixIterator<T>::operator *()// This is really dirty
+template<typename T, typename I>
+T& SparseMatrixIterator<T,I>::operator *()// This is really dirty
 {
 	if (isValid())
 	{
-		return const_cast<SparseMatrix<T>*>(mMatrix)->mValues[mColumnPtrIndex];
+		return const_cast<BasicSparseMatrix<T,I>*>(mMatrix)->mValues[mColumnPtrIndex];
 	}
 	else
 	{
 		NS_ASSERT(mMatrix->mEmpty == (T)0);
-		return const_cast<SparseMatrix<T>*>(mMatrix)->mEmpty;
+		return const_cast<BasicSparseMatrix<T,I>*>(mMatrix)->mEmpty;
 	}
 }
 
 // Row
-template<typename T>
-SparseMatrixRowIterator<T>::SparseMatrixRowIterator(const SparseMatrix<T>& m, Index i1, Index i2) :
-	SparseMatrixIterator<T>(m,i1,i2)
+template<typename T, typename I>
+SparseMatrixRowIterator<T,I>::SparseMatrixRowIterator(const BasicSparseMatrix<T,I>& m, Index i1, Index i2) :
+	SparseMatrixIterator<T,I>(m,i1,i2)
 {
 }
 
-template<typename T>
-SparseMatrixRowIterator<T>& SparseMatrixRowIterator<T>::operator++ ()
+template<typename T, typename I>
+SparseMatrixRowIterator<T,I>& SparseMatrixRowIterator<T,I>::operator++ ()
 {
 	if (this->isValid())
 	{
@@ -118,8 +118,8 @@ SparseMatrixRowIterator<T>& SparseMatrixRowIterator<T>::operator++ ()
 	return *this;
 }
 
-template<typename T>
-SparseMatrixRowIterator<T> SparseMatrixRowIterator<T>::operator++ (int)
+template<typename T, typename I>
+SparseMatrixRowIterator<T,I> SparseMatrixRowIterator<T,I>::operator++ (int)
 {
 	auto c = *this;
 	this->operator++ ();
@@ -127,14 +127,14 @@ SparseMatrixRowIterator<T> SparseMatrixRowIterator<T>::operator++ (int)
 }
 
 // Column
-template<typename T>
-SparseMatrixColumnIterator<T>::SparseMatrixColumnIterator(const SparseMatrix<T>& m, Index i1, Index i2) :
-	SparseMatrixIterator<T>(m,i1,i2)
+template<typename T, typename I>
+SparseMatrixColumnIterator<T,I>::SparseMatrixColumnIterator(const BasicSparseMatrix<T,I>& m, Index i1, Index i2) :
+	SparseMatrixIterator<T,I>(m,i1,i2)
 {
 }
 
-template<typename T>
-SparseMatrixColumnIterator<T>& SparseMatrixColumnIterator<T>::operator++ ()
+template<typename T, typename I>
+SparseMatrixColumnIterator<T,I>& SparseMatrixColumnIterator<T,I>::operator++ ()
 {
 	if (this->isValid())
 	{
@@ -173,8 +173,8 @@ SparseMatrixColumnIterator<T>& SparseMatrixColumnIterator<T>::operator++ ()
 	return *this;
 }
 
-template<typename T>
-SparseMatrixColumnIterator<T> SparseMatrixColumnIterator<T>::operator++ (int)
+template<typename T, typename I>
+SparseMatrixColumnIterator<T,I> SparseMatrixColumnIterator<T,I>::operator++ (int)
 {
 	auto c = *this;
 	this->operator++ ();
@@ -182,21 +182,24 @@ SparseMatrixColumnIterator<T> SparseMatrixColumnIterator<T>::operator++ (int)
 }
 
 // Main
-template<typename T>
-SparseMatrix<T>::SparseMatrix() :
-	mValues(), mColumnPtr(), mRowPtr(0), mColumnCount(0), mEmpty((T)0)
+template<typename T, typename I>
+BasicSparseMatrix<T,I>::BasicSparseMatrix() :
+	mValues(), mColumnPtr(), mRowPtr(1, 0), mColumnCount(0), mEmpty((T)0)
 {
 	static_assert(is_number<T>::value, "Type T has to be a number.\nAllowed are std::complex and the types allowed by std::is_floating_point.");
 }
 
-template<typename T>
-SparseMatrix<T>::SparseMatrix(Dimension d1, Dimension d2, size_t expected) :
-	mValues(), mColumnPtr(), mRowPtr(d1), mColumnCount(d2), mEmpty((T)0)
+template<typename T, typename I>
+BasicSparseMatrix<T,I>::BasicSparseMatrix(Dimension d1, Dimension d2, size_t expected) :
+	mValues(), mColumnPtr(), mRowPtr(d1+1, 0), mColumnCount(d2), mEmpty((T)0)
 {
 	NS_ASSERT(d1 > 0);
 	NS_ASSERT(d2 > 0);
 	static_assert(is_number<T>::value, "Type T has to be a number.\nAllowed are std::complex and the types allowed by std::is_floating_point.");
 
+	if (d1 > std::numeric_limits<I>::max() || d2 > std::numeric_limits<I>::max())
+		throw IndexOverflowException();
+
 	if (expected > 0)
 	{
 		mValues.reserve(expected);
@@ -204,9 +207,9 @@ SparseMatrix<T>::SparseMatrix(Dimension d1, Dimension d2, size_t expected) :
 	}
 }
 
-template<typename T>
-SparseMatrix<T>::SparseMatrix(std::initializer_list<std::initializer_list<T> > l) :
-	SparseMatrix(l.size(), 
+template<typename T, typename I>
+BasicSparseMatrix<T,I>::BasicSparseMatrix(std::initializer_list<std::initializer_list<T> > l) :
+	BasicSparseMatrix(l.size(), 
 		std::max_element(l.begin(), l.end(), [](const std::initializer_list<T>& a, const std::initializer_list<T>& b)
 		{ return a.size() < b.size(); })->size())
 {
@@ -225,13 +228,62 @@ SparseMatrix<T>::SparseMatrix(std::initializer_list<std::initializer_list<T> > l
 	}
 }
 
-template<typename T>
-SparseMatrix<T>::~SparseMatrix()
+template<typename T, typename I>
+BasicSparseMatrix<T,I>::BasicSparseMatrix(Dimension d1, Dimension d2,
+	std::vector<index_type>&& rowPtr, std::vector<index_type>&& columnPtr, std::vector<T>&& values) :
+	mValues(std::move(values)), mColumnPtr(std::move(columnPtr)), mRowPtr(std::move(rowPtr)), mColumnCount(d2), mEmpty((T)0)
 {
+	NS_ASSERT(d1 > 0);
+	NS_ASSERT(d2 > 0);
+	NS_ASSERT(mRowPtr.size() == d1+1);
+	NS_ASSERT(mColumnPtr.size() == mValues.size());
+	static_assert(is_number<T>::value, "Type T has to be a number.\nAllowed are std::complex and the types allowed by std::is_floating_point.");
+
+	// Row offsets narrowed by the caller would have been truncated
+	if (d1 > std::numeric_limits<I>::max() || d2 > std::numeric_limits<I>::max() ||
+		mValues.size() > std::numeric_limits<I>::max())
+		throw IndexOverflowException();
+
+	NS_ASSERT(mRowPtr.back() == mValues.size());
 }
 
-template<typename T>
-void SparseMatrix<T>::resize(Dimension d1, Dimension d2)
+template<typename T, typename I>
+template<typename J>
+BasicSparseMatrix<T,I>::BasicSparseMatrix(Dimension d1, Dimension d2,
+	const std::vector<J>& rowPtr, const std::vector<J>& columnPtr, std::vector<T>&& values) :
+	mValues(std::move(values)), mColumnPtr(columnPtr.begin(), columnPtr.end()), mRowPtr(rowPtr.begin(), rowPtr.end()),
+	mColumnCount(d2), mEmpty((T)0)
+{
+	NS_ASSERT(d1 > 0);
+	NS_ASSERT(d2 > 0);
+	NS_ASSERT(mRowPtr.size() == d1+1);
+	NS_ASSERT(mColumnPtr.size() == mValues.size());
+	static_assert(is_number<T>::value, "Type T has to be a number.\nAllowed are std::complex and the types allowed by std::is_floating_point.");
+
+	// The columns are smaller than d2, and the row offsets are not larger than the last one
+	if (d1 > std::numeric_limits<I>::max() || d2 > std::numeric_limits<I>::max() ||
+		(Dimension)rowPtr.back() > std::numeric_limits<I>::max())
+		throw IndexOverflowException();
+
+	NS_ASSERT(mRowPtr.back() == mValues.size());
+}
+
+template<typename T, typename I>
+BasicSparseMatrix<T,I>::~BasicSparseMatrix()
+{
+}
+
+template<typename T, typename I>
+I BasicSparseMatrix<T,I>::to_index(size_t offset)
+{
+	if (offset > std::numeric_limits<I>::max())
+		throw IndexOverflowException();
+
+	return (I)offset;
+}
+
+template<typename T, typename I>
+void BasicSparseMatrix<T,I>::resize(Dimension d1, Dimension d2)
 {
 	NS_ASSERT(d1 > 0);
 	NS_ASSERT(d2 > 0);
@@ -241,8 +293,8 @@ void SparseMatrix<T>::resize(Dimension d1, Dimension d2)
 /*
  Only for internal use.
  */
-template<typename T>
-const T& SparseMatrix<T>::internal_at(Index i1, Index i2, Index& columnPtrIndex, bool& found, bool needNear) const
+template<typename T, typename I>
+const T& BasicSparseMatrix<T,I>::internal_at(Index i1, Index i2, Index& columnPtrIndex, bool& found, bool needNear) const
 {
 	Index tmp_i1 = i1;
 
@@ -286,8 +338,8 @@ const T& SparseMatrix<T>::internal_at(Index i1, Index i2, Index& columnPtrIndex,
 	return mEmpty;
 }
 
-template<typename T>
-void SparseMatrix<T>::remove_at(Index i1, Index i2)
+template<typename T, typename I>
+void BasicSparseMatrix<T,I>::remove_at(Index i1, Index i2)
 {
 	Index columnPtrIndex;
 	bool found;
@@ -298,13 +350,13 @@ void SparseMatrix<T>::remove_at(Index i1, Index i2)
 		mValues.erase(mValues.begin() + columnPtrIndex);// O(D1*D2), due to the moving in std::vector<T>::erase
 		mColumnPtr.erase(mColumnPtr.begin() + columnPtrIndex);// O(D1*D2), see above
 
-		for (Index k = i1 + 1; k < rows(); ++k)// O(D1)
+		for (Index k = i1 + 1; k <= rows(); ++k)// O(D1)
 			mRowPtr[k] -= 1;
 	}
 }
 
-template<typename T>
-void SparseMatrix<T>::set_at(Index i1, Index i2, const T& v)
+template<typename T, typename I>
+void BasicSparseMatrix<T,I>::set_at(Index i1, Index i2, const T& v)
 {
 	Index columnPtrIndex;
 	bool found;
@@ -316,21 +368,24 @@ void SparseMatrix<T>::set_at(Index i1, Index i2, const T& v)
 	}
 	else// New
 	{
+		if (mValues.size() >= std::numeric_limits<I>::max())
+			throw IndexOverflowException();
+
 		mValues.insert(mValues.begin() + columnPtrIndex, v);// O(D1*D2)
 		mColumnPtr.insert(mColumnPtr.begin() + columnPtrIndex, i2);// O(D1*D2)
 	
-		for (Index k = i1 + 1; k < rows(); ++k)// O(D1)
+		for (Index k = i1 + 1; k <= rows(); ++k)// O(D1)
 			mRowPtr[k] += 1;
 	}
 }
 
-template<typename T>
-size_t SparseMatrix<T>::row_entry_count(Index i, Index& rowPtr) const
+template<typename T, typename I>
+size_t BasicSparseMatrix<T,I>::row_entry_count(Index i, Index& rowPtr) const
 {
 	if (i < rows())
 	{
 		rowPtr = mRowPtr[i];// O(1)
-		return i != (rows() - 1) ? mRowPtr[i + 1] - rowPtr : mColumnPtr.size() - rowPtr;
+		return mRowPtr[i + 1] - rowPtr;
 	}
 	else
 	{
@@ -339,8 +394,8 @@ size_t SparseMatrix<T>::row_entry_count(Index i, Index& rowPtr) const
 	}
 }
 
-template<typename T>
-T SparseMatrix<T>::at(Index i1, Index i2) const
+template<typename T, typename I>
+T BasicSparseMatrix<T,I>::at(Index i1, Index i2) const
 {
 	NS_ASSERT(i1 < rows());
 	NS_ASSERT(i2 < columns());
@@ -350,8 +405,8 @@ T SparseMatrix<T>::at(Index i1, Index i2) const
 	return internal_at(i1, i2, tmp, found);// O(D2)
 }
 
-template<typename T>
-void SparseMatrix<T>::set(Index i1, Index i2, const T& t)
+template<typename T, typename I>
+void BasicSparseMatrix<T,I>::set(Index i1, Index i2, const T& t)
 {
 	NS_ASSERT(i1 < rows());
 	NS_ASSERT(i2 < columns());
@@ -362,22 +417,22 @@ void SparseMatrix<T>::set(Index i1, Index i2, const T& t)
 		set_at(i1, i2, t);// 
 }
 
-template<typename T>
-T SparseMatrix<T>::linear_at(Index i) const
+template<typename T, typename I>
+T BasicSparseMatrix<T,I>::linear_at(Index i) const
 {
 	NS_ASSERT(i < size());
 	return at(i / columns(), i % columns());
 }
 
-template<typename T>
-void SparseMatrix<T>::linear_set(Index i, const T& v)
+template<typename T, typename I>
+void BasicSparseMatrix<T,I>::linear_set(Index i, const T& v)
 {
 	NS_ASSERT(i < size());
 	set(i / columns(), i % columns(), v);
 }
 
-template<typename T>
-bool SparseMatrix<T>::has(Index i1, Index i2) const
+template<typename T, typename I>
+bool BasicSparseMatrix<T,I>::has(Index i1, Index i2) const
 {
 	NS_ASSERT(i1 < rows());
 	NS_ASSERT(i2 < columns());
@@ -389,8 +444,8 @@ bool SparseMatrix<T>::has(Index i1, Index i2) const
 	return found;
 }
 
-template<typename T>
-bool SparseMatrix<T>::has(Index i1, Index i2, T& val) const
+template<typename T, typename I>
+bool BasicSparseMatrix<T,I>::has(Index i1, Index i2, T& val) const
 {
 	NS_ASSERT(i1 < rows());
 	NS_ASSERT(i2 < columns());
@@ -403,8 +458,8 @@ bool SparseMatrix<T>::has(Index i1, Index i2, T& val) const
 }
 
 // Iterators
-template<typename T>
-const SparseMatrixIterator<T> SparseMatrix<T>::begin() const
+template<typename T, typename I>
+const SparseMatrixIterator<T,I> BasicSparseMatrix<T,I>::begin() const
 {
 	if (empty())
 		return end();
@@ -422,14 +477,14 @@ const SparseMatrixIterator<T> SparseMatrix<T>::begin() const
 	}
 }
 
-template<typename T>
-const SparseMatrixIterator<T> SparseMatrix<T>::end() const
+template<typename T, typename I>
+const SparseMatrixIterator<T,I> BasicSparseMatrix<T,I>::end() const
 {
 	return iterator(*this, rows(), columns());
 }
 
-template<typename T>
-SparseMatrixIterator<T> SparseMatrix<T>::begin()
+template<typename T, typename I>
+SparseMatrixIterator<T,I> BasicSparseMatrix<T,I>::begin()
 {
 	if (empty())
 		return end();
@@ -447,26 +502,26 @@ SparseMatrixIterator<T> SparseMatrix<T>::begin()
 	}
 }
 
-template<typename T>
-SparseMatrixIterator<T> SparseMatrix<T>::end()
+template<typename T, typename I>
+SparseMatrixIterator<T,I> BasicSparseMatrix<T,I>::end()
 {
 	return iterator(*this, rows(), columns());
 }
 
-template<typename T>
-const SparseMatrixIterator<T> SparseMatrix<T>::cbegin() const
+template<typename T, typename I>
+const SparseMatrixIterator<T,I> BasicSparseMatrix<T,I>::cbegin() const
 {
 	return begin();
 }
 
-template<typename T>
-const SparseMatrixIterator<T> SparseMatrix<T>::cend() const
+template<typename T, typename I>
+const SparseMatrixIterator<T,I> BasicSparseMatrix<T,I>::cend() const
 {
 	return end();
 }
 
-template<typename T>
-const SparseMatrixRowIterator<T> SparseMatrix<T>::row_begin(Index i) const
+template<typename T, typename I>
+const SparseMatrixRowIterator<T,I> BasicSparseMatrix<T,I>::row_begin(Index i) const
 {
 	Index tmp;
 	if (empty() || row_entry_count(i, tmp) == 0)
@@ -475,14 +530,14 @@ const SparseMatrixRowIterator<T> SparseMatrix<T>::row_begin(Index i) const
 		return row_iterator(*this, i, mColumnPtr[tmp]);
 }
 
-template<typename T>
-const SparseMatrixRowIterator<T> SparseMatrix<T>::row_end(Index) const
+template<typename T, typename I>
+const SparseMatrixRowIterator<T,I> BasicSparseMatrix<T,I>::row_end(Index) const
 {
 	return row_iterator(*this, rows(), columns());
 }
 
-template<typename T>
-SparseMatrixRowIterator<T> SparseMatrix<T>::row_begin(Index i)
+template<typename T, typename I>
+SparseMatrixRowIterator<T,I> BasicSparseMatrix<T,I>::row_begin(Index i)
 {
 	Index tmp;
 	if (empty() || row_entry_count(i, tmp) == 0)
@@ -491,27 +546,27 @@ SparseMatrixRowIterator<T> SparseMatrix<T>::row_begin(Index i)
 		return row_iterator(*this, i, mColumnPtr[tmp]);
 }
 
-template<typename T>
-SparseMatrixRowIterator<T> SparseMatrix<T>::row_end(Index)
+template<typename T, typename I>
+SparseMatrixRowIterator<T,I> BasicSparseMatrix<T,I>::row_end(Index)
 {
 	return row_iterator(*this, rows(), columns());
 }
 
-template<typename T>
-const SparseMatrixRowIterator<T> SparseMatrix<T>::row_cbegin(Index i) const
+template<typename T, typename I>
+const SparseMatrixRowIterator<T,I> BasicSparseMatrix<T,I>::row_cbegin(Index i) const
 {
 	return row_begin(i);
 }
 
-template<typename T>
-const SparseMatrixRowIterator<T> SparseMatrix<T>::row_cend(Index i) const
+template<typename T, typename I>
+const SparseMatrixRowIterator<T,I> BasicSparseMatrix<T,I>::row_cend(Index i) const
 {
 	return row_end(i);
 }
 
 //Column
-template<typename T>
-const SparseMatrixColumnIterator<T> SparseMatrix<T>::column_begin(Index i) const
+template<typename T, typename I>
+const SparseMatrixColumnIterator<T,I> BasicSparseMatrix<T,I>::column_begin(Index i) const
 {
 	if (empty())
 		return column_end(i);
@@ -528,14 +583,14 @@ const SparseMatrixColumnIterator<T> SparseMatrix<T>::column_begin(Index i) const
 	}
 }
 
-template<typename T>
-const SparseMatrixColumnIterator<T> SparseMatrix<T>::column_end(Index) const
+template<typename T, typename I>
+const SparseMatrixColumnIterator<T,I> BasicSparseMatrix<T,I>::column_end(Index) const
 {
 	return column_iterator(*this, rows(), columns());
 }
 
-template<typename T>
-SparseMatrixColumnIterator<T> SparseMatrix<T>::column_begin(Index i)
+template<typename T, typename I>
+SparseMatrixColumnIterator<T,I> BasicSparseMatrix<T,I>::column_begin(Index i)
 {
 	if (empty())
 		return column_end(i);
@@ -552,27 +607,27 @@ SparseMatrixColumnIterator<T> SparseMatrix<T>::column_begin(Index i)
 	}
 }
 
-template<typename T>
-SparseMatrixColumnIterator<T> SparseMatrix<T>::column_end(Index)
+template<typename T, typename I>
+SparseMatrixColumnIterator<T,I> BasicSparseMatrix<T,I>::column_end(Index)
 {
 	return column_iterator(*this, rows(), columns());
 }
 
-template<typename T>
-const SparseMatrixColumnIterator<T> SparseMatrix<T>::column_cbegin(Index i) const
+template<typename T, typename I>
+const SparseMatrixColumnIterator<T,I> BasicSparseMatrix<T,I>::column_cbegin(Index i) const
 {
 	return column_begin(i);
 }
 
-template<typename T>
-const SparseMatrixColumnIterator<T> SparseMatrix<T>::column_cend(Index i) const
+template<typename T, typename I>
+const SparseMatrixColumnIterator<T,I> BasicSparseMatrix<T,I>::column_cend(Index i) const
 {
 	return column_end(i);
 }
 
 // Set/Erase
-template<typename T>
-SparseMatrixIterator<T> SparseMatrix<T>::set(const SparseMatrixIterator<T>& it, const T& val)
+template<typename T, typename I>
+SparseMatrixIterator<T,I> BasicSparseMatrix<T,I>::set(const SparseMatrixIterator<T,I>& it, const T& val)
 {
 	NS_ASSERT(this == it.mMatrix);
 
@@ -582,7 +637,7 @@ SparseMatrixIterator<T> SparseMatrix<T>::set(const SparseMatrixIterator<T>& it,
 			return erase(it);
 		else
 		{
-			SparseMatrixIterator<T> nit = it;
+			SparseMatrixIterator<T,I> nit = it;
 			mValues[nit.mColumnPtrIndex] = val;
 			return nit;
 		}
@@ -593,8 +648,8 @@ SparseMatrixIterator<T> SparseMatrix<T>::set(const SparseMatrixIterator<T>& it,
 	}
 }
 
-template<typename T>
-SparseMatrixIterator<T> SparseMatrix<T>::erase(const SparseMatrixIterator<T>& it)
+template<typename T, typename I>
+SparseMatrixIterator<T,I> BasicSparseMatrix<T,I>::erase(const SparseMatrixIterator<T,I>& it)
 {
 	NS_ASSERT(this == it.mMatrix);
 
@@ -603,12 +658,12 @@ SparseMatrixIterator<T> SparseMatrix<T>::erase(const SparseMatrixIterator<T>& it
 		mValues.erase(mValues.begin() + it.mColumnPtrIndex);
 		auto cIt = mColumnPtr.erase(mColumnPtr.begin() + it.mColumnPtrIndex);
 
-		for (Index k = it.row() + 1; k < rows(); ++k)
+		for (Index k = it.row() + 1; k <= rows(); ++k)
 		{
 			mRowPtr[k] -= 1;
 		}
 
-		SparseMatrixIterator<T> nIt = it;
+		SparseMatrixIterator<T,I> nIt = it;
 		if (cIt == mColumnPtr.end())// End/Empty
 		{
 			nIt.mIndex1 = rows();
@@ -641,8 +696,8 @@ SparseMatrixIterator<T> SparseMatrix<T>::erase(const SparseMatrixIterator<T>& it
 }
 
 // Operators
-template<typename T>
-SparseMatrix<T>& SparseMatrix<T>::operator +=(const SparseMatrix<T>& v2)
+template<typename T, typename I>
+BasicSparseMatrix<T,I>& BasicSparseMatrix<T,I>::operator +=(const BasicSparseMatrix<T,I>& v2)
 {
 	for (auto it = v2.cbegin(); it != v2.cend(); ++it)// O(D1*D2)
 		set(it.row(), it.column(), at(it.row(), it.column()) + *it);// O(D1*D2)
@@ -650,8 +705,8 @@ SparseMatrix<T>& SparseMatrix<T>::operator +=(const SparseMatrix<T>& v2)
 	return *this;
 }
 
-template<typename T>
-SparseMatrix<T>& SparseMatrix<T>::operator -=(const SparseMatrix<T>& v2)
+template<typename T, typename I>
+BasicSparseMatrix<T,I>& BasicSparseMatrix<T,I>::operator -=(const BasicSparseMatrix<T,I>& v2)
 {
 	for (auto it = v2.cbegin(); it != v2.cend(); ++it)
 		set(it.row(), it.column(), at(it.row(), it.column()) - *it);
@@ -659,8 +714,8 @@ SparseMatrix<T>& SparseMatrix<T>::operator -=(const SparseMatrix<T>& v2)
 	return *this;
 }
 
-template<typename T>
-SparseMatrix<T>& SparseMatrix<T>::operator *=(const SparseMatrix<T>& v2)
+template<typename T, typename I>
+BasicSparseMatrix<T,I>& BasicSparseMatrix<T,I>::operator *=(const BasicSparseMatrix<T,I>& v2)
 {
 	for (auto it = v2.cbegin(); it != v2.cend(); ++it)// O(D1*D2)
 	{
@@ -682,8 +737,8 @@ SparseMatrix<T>& SparseMatrix<T>::operator *=(const SparseMatrix<T>& v2)
 	return *this;
 }
 
-template<typename T>
-SparseMatrix<T>& SparseMatrix<T>::operator *=(const T& f)
+template<typename T, typename I>
+BasicSparseMatrix<T,I>& BasicSparseMatrix<T,I>::operator *=(const T& f)
 {
 	if (f == (T)0)
 	{
@@ -700,32 +755,32 @@ SparseMatrix<T>& SparseMatrix<T>::operator *=(const T& f)
 	return *this;
 }
 
-template<typename T>
-constexpr Dimension SparseMatrix<T>::columns() const
+template<typename T, typename I>
+constexpr Dimension BasicSparseMatrix<T,I>::columns() const
 {
 	return mColumnCount;
 }
 
-template<typename T>
-constexpr Dimension SparseMatrix<T>::rows() const
+template<typename T, typename I>
+constexpr Dimension BasicSparseMatrix<T,I>::rows() const
 {
-	return mRowPtr.size();
+	return mRowPtr.empty() ? 0 : mRowPtr.size() - 1;
 }
 
-template<typename T>
-constexpr Dimension SparseMatrix<T>::size() const
+template<typename T, typename I>
+constexpr Dimension BasicSparseMatrix<T,I>::size() const
 {
 	return rows()*columns();
 }
 
-template<typename T>
-Dimension SparseMatrix<T>::filled_count() const
+template<typename T, typename I>
+Dimension BasicSparseMatrix<T,I>::filled_count() const
 {
 	return mValues.size();
 }
 	
-template<typename T>
-Dimension SparseMatrix<T>::row_filled_count(Index r) const
+template<typename T, typename I>
+Dimension BasicSparseMatrix<T,I>::row_filled_count(Index r) const
 {
 	Index i = 0;
 	for(auto it = row_cbegin(r); it != row_cend(r); ++it)
@@ -733,8 +788,8 @@ Dimension SparseMatrix<T>::row_filled_count(Index r) const
 	return i;
 }
 
-template<typename T>
-Dimension SparseMatrix<T>::column_filled_count(Index c) const
+template<typename T, typename I>
+Dimension BasicSparseMatrix<T,I>::column_filled_count(Index c) const
 {
 	Index i = 0;
 	for(auto it = column_cbegin(c); it != column_cend(c); ++it)
@@ -742,14 +797,14 @@ Dimension SparseMatrix<T>::column_filled_count(Index c) const
 	return i;
 }
 
-template<typename T>
-bool SparseMatrix<T>::empty() const
+template<typename T, typename I>
+bool BasicSparseMatrix<T,I>::empty() const
 {
 	return mValues.empty();
 }
 
-template<typename T>
-T SparseMatrix<T>::sum() const
+template<typename T, typename I>
+T BasicSparseMatrix<T,I>::sum() const
 {
 	T s = 0;
 	for (auto l : mValues)
@@ -758,8 +813,8 @@ T SparseMatrix<T>::sum() const
 	return s;
 }
 
-template<typename T>
-T SparseMatrix<T>::max() const
+template<typename T, typename I>
+T BasicSparseMatrix<T,I>::max() const
 {
 	T s = std::numeric_limits<typename get_complex_internal<T>::type>::min();
 	for (auto l : mValues)
@@ -774,8 +829,8 @@ T SparseMatrix<T>::max() const
 	return s;
 }
 
-template<typename T>
-T SparseMatrix<T>::min() const
+template<typename T, typename I>
+T BasicSparseMatrix<T,I>::min() const
 {
 	T s = std::numeric_limits<typename get_complex_internal<T>::type>::max();
 	for (auto l : mValues)
@@ -790,14 +845,14 @@ T SparseMatrix<T>::min() const
 	return s;
 }
 
-template<typename T>
-T SparseMatrix<T>::avg() const
+template<typename T, typename I>
+T BasicSparseMatrix<T,I>::avg() const
 {
 	return sum() / size();// Overflow?
 }
 
-template<typename T>
-bool SparseMatrix<T>::has_nan() const
+template<typename T, typename I>
+bool BasicSparseMatrix<T,I>::has_nan() const
 {
 	for (auto l : mValues)
 	{
@@ -808,8 +863,8 @@ bool SparseMatrix<T>::has_nan() const
 	return false;
 }
 
-template<typename T>
-bool SparseMatrix<T>::has_inf() const
+template<typename T, typename I>
+bool BasicSparseMatrix<T,I>::has_inf() const
 {
 	for (auto l : mValues)
 	{
@@ -820,35 +875,78 @@ bool SparseMatrix<T>::has_inf() const
 	return false;
 }
 
-template<typename T>
-bool SparseMatrix<T>::has_zero() const
+template<typename T, typename I>
+bool BasicSparseMatrix<T,I>::has_zero() const
 {
 	return mValues.size() != size();
 }
 
-template<typename T>
-void SparseMatrix<T>::swap(SparseMatrix<T>& v)
+template<typename T, typename I>
+void BasicSparseMatrix<T,I>::swap(BasicSparseMatrix<T,I>& v)
 {
 	std::swap(mValues, v.mValues);
 	std::swap(mColumnPtr, v.mColumnPtr);
 	std::swap(mRowPtr, v.mRowPtr);
+	std::swap(mColumnCount, v.mColumnCount);
 }
 
-template<typename T>
-SparseMatrix<T> SparseMatrix<T>::transpose() const
+template<typename T, typename I>
+const T* BasicSparseMatrix<T,I>::value_ptr() const
 {
-	SparseMatrix<T> tmp(columns(), rows());
+	return mValues.data();
+}
 
-	for (auto it = begin(); it != end(); ++it)// O(D1*D2)
-		tmp.set(it.column(), it.row(), *it);// O(D1*D2)
+template<typename T, typename I>
+T* BasicSparseMatrix<T,I>::value_ptr()
+{
+	return mValues.data();
+}
 
-	return tmp;
+template<typename T, typename I>
+const typename BasicSparseMatrix<T,I>::index_type* BasicSparseMatrix<T,I>::column_ptr() const
+{
+	return mColumnPtr.data();
+}
+
+template<typename T, typename I>
+const typename BasicSparseMatrix<T,I>::index_type* BasicSparseMatrix<T,I>::row_ptr() const
+{
+	return mRowPtr.data();
+}
+
+template<typename T, typename I>
+BasicSparseMatrix<T,I> BasicSparseMatrix<T,I>::transpose() const
+{
+	const Index n = rows();
+	const Index m = columns();
+
+	// Counting sort by column; scattering the rows in order keeps the new rows sorted
+	std::vector<I> rowPtr(m + 1, 0);
+	for (Index p = 0; p < mColumnPtr.size(); ++p)
+		++rowPtr[mColumnPtr[p] + 1];
+	for (Index j = 0; j < m; ++j)
+		rowPtr[j + 1] += rowPtr[j];
+
+	std::vector<I> columnPtr(mColumnPtr.size());
+	std::vector<T> values(mValues.size());
+	std::vector<I> next(rowPtr.begin(), rowPtr.end() - 1);
+	for (Index i = 0; i < n; ++i)
+	{
+		for (Index p = mRowPtr[i]; p < mRowPtr[i + 1]; ++p)
+		{
+			const Index q = next[mColumnPtr[p]]++;
+			columnPtr[q] = i;
+			values[q] = mValues[p];
+		}
+	}
+
+	return BasicSparseMatrix<T,I>(m, n, std::move(rowPtr), std::move(columnPtr), std::move(values));
 }
 
-template<typename T>
-SparseMatrix<T> SparseMatrix<T>::conjugate() const
+template<typename T, typename I>
+BasicSparseMatrix<T,I> BasicSparseMatrix<T,I>::conjugate() const
 {
-	SparseMatrix<T> tmp(rows(), columns());
+	BasicSparseMatrix<T,I> tmp(rows(), columns());
 
 	for (auto it = begin(); it != end(); ++it)
 		tmp.set(it.row(), it.column(), complex_conj(*it));
@@ -856,19 +954,19 @@ SparseMatrix<T> SparseMatrix<T>::conjugate() const
 	return tmp;
 }
 
-template<typename T>
-SparseMatrix<T> SparseMatrix<T>::adjugate() const
+template<typename T, typename I>
+BasicSparseMatrix<T,I> BasicSparseMatrix<T,I>::adjugate() const
 {
-	SparseMatrix<T> tmp(columns(), rows());
+	BasicSparseMatrix<T,I> tmp = transpose();
 
-	for (auto it = begin(); it != end(); ++it)// O(D1*D2)
-		tmp.set(it.column(), it.row(), complex_conj(*it));// O(D1*D2)
+	for (T& v : tmp.mValues)
+		v = complex_conj(v);
 
 	return tmp;
 }
 
-template<typename T>
-T SparseMatrix<T>::trace() const
+template<typename T, typename I>
+T BasicSparseMatrix<T,I>::trace() const
 {
 	T v = (T)0;
 	for (Index i = 0; i < t_min(rows(), columns()); ++i)
@@ -878,46 +976,89 @@ T SparseMatrix<T>::trace() const
 }
 
 //TODO: Improve
-template<typename T>
-SparseMatrix<T> SparseMatrix<T>::mul(const SparseMatrix<T>& m) const
+template<typename T, typename I>
+BasicSparseMatrix<T,I> BasicSparseMatrix<T,I>::mul(const BasicSparseMatrix<T,I>& m) const
 {
 	if (columns() != m.rows())
 		throw MatrixMulMismatchException();
 
-	SparseMatrix<T> tmp(rows(), m.columns());
-	for (Index i = 0; i < rows(); ++i)// O(D1)
+	// Gustavson: Row i of the result is the sum of the rows of m scaled by the entries of row i
+	const Index n = rows();
+	const Index k = m.columns();
+	const Index none = std::numeric_limits<Index>::max();
+
+	std::vector<I> rowPtr(n + 1, 0);
+	std::vector<I> columnPtr;
+	std::vector<T> values;
+	columnPtr.reserve(mValues.size() + m.mValues.size());
+	values.reserve(mValues.size() + m.mValues.size());
+
+	std::vector<T> work(k, (T)0);
+	std::vector<Index> mark(k, none);
+	std::vector<Index> pattern;
+	for (Index i = 0; i < n; ++i)// O(D1)
 	{
-		for (Index k = 0; k < m.columns(); ++k)// O(D3)
+		for (Index p = mRowPtr[i]; p < mRowPtr[i + 1]; ++p)
 		{
-			T v = 0;
-			for (auto rit = row_begin(i); rit != row_end(i); ++rit)// O(D2)
-				v += (*rit) * m.at(rit.column(), k);// O(D2) + O(D3)
-			tmp.set(i, k, v);// O(D1*D3)
+			const Index c = mColumnPtr[p];
+			const T a = mValues[p];
+			for (Index q = m.mRowPtr[c]; q < m.mRowPtr[c + 1]; ++q)
+			{
+				const Index j = m.mColumnPtr[q];
+				if (mark[j] != i)
+				{
+					mark[j] = i;
+					work[j] = a * m.mValues[q];
+					pattern.push_back(j);
+				}
+				else
+				{
+					work[j] += a * m.mValues[q];
+				}
+			}
 		}
+
+		std::sort(pattern.begin(), pattern.end());
+		for (Index j : pattern)
+		{
+			if (work[j] != (T)0)
+			{
+				columnPtr.push_back(j);
+				values.push_back(work[j]);
+			}
+		}
+		pattern.clear();
+
+		rowPtr[i + 1] = to_index(columnPtr.size());
 	}
 
-	return tmp;
+	return BasicSparseMatrix<T,I>(n, k, std::move(rowPtr), std::move(columnPtr), std::move(values));
 }
 
-template<typename T>
-template<typename DC>
-DynamicVector<T> SparseMatrix<T>::mul(const Vector<T,DC>& v) const
+template<typename T, typename I>
+template<typename U, typename DC>
+DynamicVector<U> BasicSparseMatrix<T,I>::mul(const Vector<U,DC>& v) const
 {
 	if (columns() != v.size())
 		throw MatrixMulMismatchException();
 
-	DynamicVector<T> r;
+	DynamicVector<U> r;
 	r.resize(rows());
 
-	for (auto it = begin(); it != end(); ++it)// O(D1*D2)
-		r.set(it.row(), r.at(it.row()) + *it * v.at(it.column()));// 2*O(D1)+O(D2)
+	for (Index i = 0; i < rows(); ++i)// O(D1)
+	{
+		U s = (U)0;
+		for (Index k = mRowPtr[i]; k < mRowPtr[i + 1]; ++k)// O(D2)
+			s += mValues[k] * v[mColumnPtr[k]];
+		r[i] = s;
+	}
 
 	return r;
 }
 
-template<typename T>
+template<typename T, typename I>
 template<typename DC>
-DynamicVector<T> SparseMatrix<T>::mul_left(const Vector<T,DC>& v) const
+DynamicVector<T> BasicSparseMatrix<T,I>::mul_left(const Vector<T,DC>& v) const
 {
 	if (rows() != v.size())
 		throw MatrixMulMismatchException();
@@ -925,55 +1066,59 @@ DynamicVector<T> SparseMatrix<T>::mul_left(const Vector<T,DC>& v) const
 	DynamicVector<T> r;
 	r.resize(columns());
 
-	for (auto it = begin(); it != end(); ++it)// O(D1*D2)
-		r.set(it.column(), r.at(it.column()) + *it * v.at(it.row()));// 2*O(D1)+O(D2)
+	for (Index i = 0; i < rows(); ++i)// O(D1)
+	{
+		const T f = v[i];
+		for (Index k = mRowPtr[i]; k < mRowPtr[i + 1]; ++k)// O(D2)
+			r[mColumnPtr[k]] += mValues[k] * f;
+	}
 
 	return r;
 }
 
-template<typename T>
-SparseMatrix<T> operator +(const SparseMatrix<T>& v1, const SparseMatrix<T>& v2)
+template<typename T, typename I>
+BasicSparseMatrix<T,I> operator +(const BasicSparseMatrix<T,I>& v1, const BasicSparseMatrix<T,I>& v2)
 {
-	SparseMatrix<T>  tmp = v1;
+	BasicSparseMatrix<T,I>  tmp = v1;
 	return (tmp += v2);
 }
 
-template<typename T>
-SparseMatrix<T> operator -(const SparseMatrix<T>& v1, const SparseMatrix<T>& v2)
+template<typename T, typename I>
+BasicSparseMatrix<T,I> operator -(const BasicSparseMatrix<T,I>& v1, const BasicSparseMatrix<T,I>& v2)
 {
-	SparseMatrix<T> tmp = v1;
+	BasicSparseMatrix<T,I> tmp = v1;
 	return (tmp -= v2);
 }
 
-template<typename T>
-SparseMatrix<T> operator -(const SparseMatrix<T>& v)
+template<typename T, typename I>
+BasicSparseMatrix<T,I> operator -(const BasicSparseMatrix<T,I>& v)
 {
-	SparseMatrix<T> tmp = v;
+	BasicSparseMatrix<T,I> tmp = v;
 	return (tmp *= (T)-1);
 }
 
-template<typename T>
-SparseMatrix<T> operator *(const SparseMatrix<T>& v1, const SparseMatrix<T>& v2)
+template<typename T, typename I>
+BasicSparseMatrix<T,I> operator *(const BasicSparseMatrix<T,I>& v1, const BasicSparseMatrix<T,I>& v2)
 {
-	SparseMatrix<T> tmp = v1;
+	BasicSparseMatrix<T,I> tmp = v1;
 	return (tmp *= v2);
 }
 
-template<typename T>
-SparseMatrix<T> operator *(const SparseMatrix<T>& v1, T f)
+template<typename T, typename I>
+BasicSparseMatrix<T,I> operator *(const BasicSparseMatrix<T,I>& v1, T f)
 {
-	SparseMatrix<T> tmp = v1;
+	BasicSparseMatrix<T,I> tmp = v1;
 	return (tmp *= f);
 }
 
-template<typename T>
-SparseMatrix<T> operator *(T f, const SparseMatrix<T>& v1)
+template<typename T, typename I>
+BasicSparseMatrix<T,I> operator *(T f, const BasicSparseMatrix<T,I>& v1)
 {
 	return v1 * f;
 }
 
-template<typename T>
-bool operator ==(const SparseMatrix<T>& v1, const SparseMatrix<T>& v2)
+template<typename T, typename I>
+bool operator ==(const BasicSparseMatrix<T,I>& v1, const BasicSparseMatrix<T,I>& v2)
 {
 	if(v1.rows() != v2.rows() || v1.columns() != v2.columns() || v1.filled_count() != v2.filled_count())
 		return false;
@@ -995,8 +1140,8 @@ bool operator ==(const SparseMatrix<T>& v1, const SparseMatrix<T>& v2)
 	return true;
 }
 
-template<typename T>
-bool operator !=(const SparseMatrix<T>& v1, const SparseMatrix<T>& v2)
+template<typename T, typename I>
+bool operator !=(const BasicSparseMatrix<T,I>& v1, const BasicSparseMatrix<T,I>& v2)
 {
 	return !(v1 == v2);
 }
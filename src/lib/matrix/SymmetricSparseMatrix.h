@@ -0,0 +1,160 @@
+#pragma once
+
+#include "Types.h"
+#include "Vector.h"
+#include "Utils.h"
+#include "Exceptions.h"
+#include "Parallel.h"
+
+#include "SparseMatrix.h"
+
+NS_BEGIN_NAMESPACE
+
+/**
+ * @brief A symmetric sparse matrix which only stores the upper triangle and the diagonal.
+ * @details The lower triangle is given by \f$ A_{ij} = \overline{A_{ji}} \f$,
+ * which makes the matrix hermitian for complex types and symmetric otherwise.\n
+ * Compared to SparseMatrix nearly half of the memory and of the bandwidth in every
+ * matrix vector multiplication is saved, which is useful for the stiffness matrices used in CG.\n
+ * Internally the upper triangle is a SparseMatrix in CRS format.
+ *
+ * @note All complexity values are calculated with all operations of T assumed to be of \f$ O(1) \f$ complexity.\n
+ * N is the amount of filled entries in the upper triangle.
+ *
+ * @tparam T Internal data type.
+ * @sa SparseMatrix
+ */
+template<typename T>
+class SymmetricSparseMatrix
+{
+private:
+	SparseMatrix<T> mUpper;
+
+public:
+	/**
+	* @brief A typedef of the underlying value type.
+	*/
+	typedef T value_type;
+
+	/**
+	* @brief A typedef of the index type used in the CRS arrays.
+	*/
+	typedef typename SparseMatrix<T>::index_type index_type;
+
+	/**
+	* @brief Constructs an empty symmetric sparse matrix of size(d,d)
+	* @param d Row and column dimension
+	* @param expected How much entries in the upper triangle are expected. Keep it 0 if unknown.
+	*/
+	explicit SymmetricSparseMatrix(Dimension d, size_t expected = 0);
+
+	/**
+	* @brief Constructs a symmetric sparse matrix from the upper triangle and the diagonal of m.
+	* @details The lower triangle of m is ignored.
+	* If NS_ALLOW_CHECKS is defined, m is checked to be hermitian.
+	* @par Complexity
+	* Always: \f$ O(D+N) \f$
+	* @param m Square sparse matrix.
+	* @throw NotSquareException
+	* @throw NotHermitianException
+	*/
+	explicit SymmetricSparseMatrix(const SparseMatrix<T>& m);
+
+	/**
+	* @brief Constructs a symmetric sparse matrix directly from the CRS arrays of the upper triangle.
+	* @details Every column index has to be greater or equal to its row.
+	* @param d Row and column dimension
+	* @param rowPtr Row offsets with d+1 entries.
+	* @param columnPtr Column index of every entry.
+	* @param values Value of every entry.
+	* @sa SparseMatrix(Dimension, Dimension, std::vector<index_type>&&, std::vector<index_type>&&, std::vector<T>&&)
+	*/
+	SymmetricSparseMatrix(Dimension d,
+		std::vector<index_type>&& rowPtr, std::vector<index_type>&& columnPtr, std::vector<T>&& values);
+
+	virtual ~SymmetricSparseMatrix();
+
+	/**
+	* @brief Returns a copy of the value at the respective location.
+	* @par Complexity
+	* Worst case: \f$ O(D) \f$
+	* @param i Index of the row.
+	* @param j Index of the column.
+	* @return Copy of the value at \f$ A_{ij} \f$
+	*/
+	T at(Index i, Index j) const;
+
+	/**
+	* @brief Sets the value at the respective location and its mirrored entry.
+	* @par Complexity
+	* Same as SparseMatrix::set
+	* @param i Index of the row.
+	* @param j Index of the column.
+	* @param val New value replacing the old one.
+	* @note If `i == j` the imaginary part of val is ignored.
+	*/
+	void set(Index i, Index j, const T& val);
+
+	/**
+	* @brief The column count
+	* @par Complexity
+	* Always: \f$ O(1) \f$
+	*/
+	Dimension columns() const;
+
+	/**
+	* @brief The row count
+	* @par Complexity
+	* Always: \f$ O(1) \f$
+	*/
+	Dimension rows() const;
+
+	/**
+	* @brief The amount of entries stored in the upper triangle and the diagonal.
+	* @par Complexity
+	* Always: \f$ O(1) \f$
+	*/
+	Dimension filled_count() const;
+
+	/**
+	* @brief The upper triangle and the diagonal as sparse matrix.
+	* @par Complexity
+	* Always: \f$ O(1) \f$
+	*/
+	const SparseMatrix<T>& upper() const;
+
+	/**
+	* @brief The adjugate / conjugate transpose of the matrix, which is the matrix itself.
+	* @par Complexity
+	* Always: \f$ O(D+N) \f$
+	*/
+	SymmetricSparseMatrix adjugate() const;
+
+	/**
+	* @brief Right side matrix vector multiplication.
+	* @details Every stored entry \f$ A_{ij} \f$ with \f$ i < j \f$ is used for \f$ y_i \f$ and \f$ y_j \f$.
+	* With multiple threads, the rows are split by their amount of entries. Every thread writes its own rows
+	* directly and buffers the rows after them up to its largest column, which is about the bandwidth
+	* for matrices from meshes. The buffers are local to the call and summed up afterwards.
+	* Matrices with less than Parallel::SerialThreshold filled entries are multiplied in the calling thread.
+	* @par Complexity
+	* Always: \f$ O(D+N) \f$ with one thread
+	* @param right A vector with the same size as the column count of the matrix.
+	* @param threads Amount of threads to use. 0 uses Parallel::thread_count().
+	* @return A vector with the same size as the row count.
+	*/
+	template<typename DC>
+	DynamicVector<T> mul(const Vector<T,DC>& right, size_t threads = 0) const;
+};
+
+// Comparison
+template<typename T>
+bool operator ==(const SymmetricSparseMatrix<T>& v1, const SymmetricSparseMatrix<T>& v2);
+template<typename T>
+bool operator !=(const SymmetricSparseMatrix<T>& v1, const SymmetricSparseMatrix<T>& v2);
+
+NS_END_NAMESPACE
+
+#define _NS_SYMMETRICSPARSEMATRIX_INL
+# include "SymmetricSparseMatrix.inl"
+#undef _NS_SYMMETRICSPARSEMATRIX_INL
\ No newline at end of file
@@ -0,0 +1,223 @@
+#ifndef _NS_SYMMETRICSPARSEMATRIX_INL
+# error SymmetricSparseMatrix.inl should only be included by SymmetricSparseMatrix.h
+#endif
+
+NS_BEGIN_NAMESPACE
+
+template<typename T>
+SymmetricSparseMatrix<T>::SymmetricSparseMatrix(Dimension d, size_t expected) :
+	mUpper(d, d, expected)
+{
+}
+
+template<typename T>
+SymmetricSparseMatrix<T>::SymmetricSparseMatrix(const SparseMatrix<T>& m) :
+	mUpper()
+{
+	if (m.rows() != m.columns())
+		throw NotSquareException();
+
+#ifdef NS_ALLOW_CHECKS
+	if (m.adjugate() != m)
+		throw NotHermitianException();
+#endif
+
+	const Index n = m.rows();
+	const index_type* rowPtr = m.row_ptr();
+	const index_type* columnPtr = m.column_ptr();
+
+	std::vector<index_type> upperRowPtr(n + 1, 0);
+	std::vector<index_type> upperColumnPtr;
+	std::vector<T> upperValues;
+	upperColumnPtr.reserve(m.filled_count() / 2 + n);
+	upperValues.reserve(m.filled_count() / 2 + n);
+
+	for (Index i = 0; i < n; ++i)
+	{
+		// Columns are sorted, so the upper part is the tail of the row
+		const Index start = std::lower_bound(columnPtr + rowPtr[i], columnPtr + rowPtr[i + 1], (index_type)i) - columnPtr;
+		for (Index p = start; p < rowPtr[i + 1]; ++p)
+		{
+			upperColumnPtr.push_back(columnPtr[p]);
+			upperValues.push_back(m.value_ptr()[p]);
+		}
+		upperRowPtr[i + 1] = SparseMatrix<T>::to_index(upperColumnPtr.size());
+	}
+
+	SparseMatrix<T>(n, n, std::move(upperRowPtr), std::move(upperColumnPtr), std::move(upperValues)).swap(mUpper);
+}
+
+template<typename T>
+SymmetricSparseMatrix<T>::SymmetricSparseMatrix(Dimension d,
+	std::vector<index_type>&& rowPtr, std::vector<index_type>&& columnPtr, std::vector<T>&& values) :
+	mUpper(d, d, std::move(rowPtr), std::move(columnPtr), std::move(values))
+{
+#ifdef NS_DEBUG
+	for (Index i = 0; i < d; ++i)
+		for (Index p = mUpper.row_ptr()[i]; p < mUpper.row_ptr()[i + 1]; ++p)
+			NS_ASSERT(mUpper.column_ptr()[p] >= i);
+#endif
+}
+
+template<typename T>
+SymmetricSparseMatrix<T>::~SymmetricSparseMatrix()
+{
+}
+
+template<typename T>
+T SymmetricSparseMatrix<T>::at(Index i, Index j) const
+{
+	if (i <= j)
+		return mUpper.at(i, j);
+	else
+		return complex_conj(mUpper.at(j, i));
+}
+
+template<typename T>
+void SymmetricSparseMatrix<T>::set(Index i, Index j, const T& val)
+{
+	if (i < j)
+		mUpper.set(i, j, val);
+	else if (i > j)
+		mUpper.set(j, i, complex_conj(val));
+	else
+		mUpper.set(i, i, (T)std::real(val));
+}
+
+template<typename T>
+Dimension SymmetricSparseMatrix<T>::columns() const
+{
+	return mUpper.columns();
+}
+
+template<typename T>
+Dimension SymmetricSparseMatrix<T>::rows() const
+{
+	return mUpper.rows();
+}
+
+template<typename T>
+Dimension SymmetricSparseMatrix<T>::filled_count() const
+{
+	return mUpper.filled_count();
+}
+
+template<typename T>
+const SparseMatrix<T>& SymmetricSparseMatrix<T>::upper() const
+{
+	return mUpper;
+}
+
+template<typename T>
+SymmetricSparseMatrix<T> SymmetricSparseMatrix<T>::adjugate() const
+{
+	return *this;
+}
+
+template<typename T>
+template<typename DC>
+DynamicVector<T> SymmetricSparseMatrix<T>::mul(const Vector<T,DC>& v, size_t threads) const
+{
+	if (columns() != v.size())
+		throw MatrixMulMismatchException();
+
+	const Index n = rows();
+	const index_type* rowPtr = mUpper.row_ptr();
+	const index_type* columnPtr = mUpper.column_ptr();
+	const T* values = mUpper.value_ptr();
+
+	DynamicVector<T> r;
+	r.resize(n);
+
+	// Rows [begin, end) into out, results of rows from end on go to tail, which starts at row end
+	const auto kernel = [&](Index begin, Index end, T* out, T* tail)
+	{
+		for (Index i = begin; i < end; ++i)
+		{
+			const T xi = v[i];
+			T s = (T)0;
+			for (Index p = rowPtr[i]; p < rowPtr[i + 1]; ++p)
+			{
+				const Index j = columnPtr[p];
+				const T a = values[p];
+				if (j == i)
+				{
+					s += a * xi;
+				}
+				else
+				{
+					s += a * v[j];
+					if (j < end)
+						out[j] += complex_conj(a) * xi;
+					else
+						tail[j - end] += complex_conj(a) * xi;
+				}
+			}
+			out[i] += s;
+		}
+	};
+
+	if (filled_count() < Parallel::SerialThreshold)
+		threads = 1;
+	else if (threads == 0)
+		threads = Parallel::thread_count();
+
+	if (threads > n)
+		threads = n;
+
+	if (threads <= 1)
+	{
+		kernel(0, n, &r[0], nullptr);
+		return r;
+	}
+
+	// Split the rows by their amount of entries
+	std::vector<Index> bounds(threads + 1, n);
+	for (Index t = 0; t < threads; ++t)
+		bounds[t] = std::upper_bound(rowPtr, rowPtr + n, (index_type)(t*filled_count() / threads)) - rowPtr - 1;
+	bounds[0] = 0;
+
+	// A thread writes its own rows directly and buffers the rows after them up to its largest column,
+	// which is only the bandwidth for banded matrices
+	std::vector<std::vector<T> > buffers(threads);
+	std::vector<Index> last(threads, 0);
+	Parallel::for_range(0, threads, [&](Index begin, Index end, Index)
+	{
+		for (Index t = begin; t < end; ++t)
+		{
+			Index maxColumn = bounds[t + 1];
+			for (Index i = bounds[t]; i < bounds[t + 1]; ++i)
+			{
+				if (rowPtr[i + 1] > rowPtr[i])
+					maxColumn = std::max<Index>(maxColumn, columnPtr[rowPtr[i + 1] - 1] + 1);
+			}
+
+			last[t] = maxColumn;
+			buffers[t].assign(maxColumn - bounds[t + 1], (T)0);
+			kernel(bounds[t], bounds[t + 1], &r[0], buffers[t].data());
+		}
+	}, threads);
+
+	for (Index t = 0; t < threads; ++t)
+	{
+		const T* buffer = buffers[t].data();
+		for (Index i = bounds[t + 1]; i < last[t]; ++i)
+			r[i] += buffer[i - bounds[t + 1]];
+	}
+
+	return r;
+}
+
+template<typename T>
+bool operator ==(const SymmetricSparseMatrix<T>& v1, const SymmetricSparseMatrix<T>& v2)
+{
+	return v1.upper() == v2.upper();
+}
+
+template<typename T>
+bool operator !=(const SymmetricSparseMatrix<T>& v1, const SymmetricSparseMatrix<T>& v2)
+{
+	return !(v1 == v2);
+}
+
+NS_END_NAMESPACE
\ No newline at end of file
@@ -1,6 +1,8 @@
 #pragma once
 
 #include "Mesh.h"
+#include "Parallel.h"
+#include "matrix/SparseMatrix.h"
 
 NS_BEGIN_NAMESPACE
 
@@ -8,21 +10,30 @@ template<typename T, Dimension K>
 class HyperCube
 {
 public:
+	/**
+	* @brief Generates a grid of hypercubes, each split into K! simplices (Kuhn/Freudenthal subdivision).
+	* @details Vertices are numbered lexicographically with the first axis running fastest.
+	* All simplices share the diagonal from the lower to the upper corner of their cube and
+	* are positively oriented. Vertices and elements are written in parallel into
+	* preallocated storage of the mesh. Vertices on the boundary are flagged as MVF_StrongBoundary.
+	* @param threads Amount of threads to use. 0 uses Parallel::thread_count().
+	* @throw InvalidElementCountException
+	*/
 	static Mesh<T,K> generate(const FixedVector<Dimension,K>& elements,
 		const FixedVector<T,K>& size,
-		const FixedVector<T,K>& offset);
-};
+		const FixedVector<T,K>& offset,
+		size_t threads = 0);
 
-/**
-* Grid 2D
-*/
-template<typename T>
-class HyperCube<T,2>
-{
-public:
-	static Mesh<T,2> generate(const FixedVector<Dimension,2>& elements,
-		const FixedVector<T,2>& size,
-		const FixedVector<T,2>& offset);
+	/**
+	* @brief Linear interpolation from the grid generated with the given elements
+	* to the grid generated with twice the elements in every direction.
+	* @details Only available for K = 2.
+	* Rows and columns follow the vertex numbering of generate().
+	* Every coarse triangle is split into four fine triangles, therefore the
+	* coarse linear shape functions are exactly represented on the fine grid.
+	* The adjugate is the corresponding restriction.
+	*/
+	static SparseMatrix<T> prolongator(const FixedVector<Dimension,K>& coarseElements);
 };
 
 NS_END_NAMESPACE
@@ -2,99 +2,160 @@
 # error HyperCube.inl should only be included by HyperCube.h
 #endif
 
+#include <algorithm>
+#include <vector>
+
 NS_BEGIN_NAMESPACE
 template<typename T, Dimension K>
 Mesh<T,K> HyperCube<T,K>::generate(
 	const FixedVector<Dimension,K>& elements,
 	const FixedVector<T,K>& size,
-	const FixedVector<T,K>& offset)
+	const FixedVector<T,K>& offset,
+	size_t threads)
 {
-	Mesh<T,K> mesh;
-
-	//TODO
-	return mesh;
-}
+	typedef MeshVertex<T,K> MV;
+	typedef MeshElement<T,K> ME;
 
-template<typename T>
-Mesh<T,2> HyperCube<T,2>::generate(const FixedVector<Dimension,2>& elements,
-		const FixedVector<T,2>& size,
-		const FixedVector<T,2>& offset)
-{
-	typedef MeshVertex<T,2> MV;
-	typedef MeshElement<T,2> ME;
+	Mesh<T,K> mesh;
 
-	Mesh<T,2> mesh;
+	Index vertexStride[K+1];
+	Index cellStride[K+1];
+	vertexStride[0] = 1;
+	cellStride[0] = 1;
+	for(Index d = 0; d < K; ++d)
+	{
+		if(elements[d] < 1)
+			throw InvalidElementCountException();
 
-	if(elements[0] < 1 || elements[1] < 1)
-		throw InvalidElementCountException();
+		vertexStride[d+1] = vertexStride[d]*(elements[d]+1);
+		cellStride[d+1] = cellStride[d]*elements[d];
+	}
 
-	// Reserve container
-	mesh.reserveVertices((elements[0]+1)*(elements[1]+1));
-	mesh.reserveElements(elements[0]*elements[1]*2);
-
-	// Unit vectors
-	FixedVector<T,2> ex;
-	ex.fill((T)0);
-	ex[0] = size[0]/(T)elements[0];
-	FixedVector<T,2> ey;
-	ey.fill((T)0);
-	ey[1] = size[1]/(T)elements[1];
-	
-	MV** lastRowVertices = new MV*[elements[1]+1];
-
-	// Generate first row
-	for(Index j = 0; j <= elements[1]; ++j)
+	// Kuhn subdivision: Every permutation of the axes is a path from the lower to the upper corner
+	std::vector<Index> permutations;
+	std::vector<bool> odd;
 	{
-		MV* v = new MV(offset + ex*(T)j);
-		v->Flags |= MVF_StrongBoundary;
-		mesh.addVertex(v);
-		lastRowVertices[j] = v;
+		Index axes[K];
+		for(Index d = 0; d < K; ++d)
+			axes[d] = d;
+
+		do
+		{
+			Index inversions = 0;
+			for(Index a = 0; a < K; ++a)
+			{
+				permutations.push_back(axes[a]);
+				for(Index b = a+1; b < K; ++b)
+				{
+					if(axes[a] > axes[b])
+						++inversions;
+				}
+			}
+			odd.push_back(inversions % 2);
+		} while(std::next_permutation(axes, axes + K));
 	}
+	const Index simplices = odd.size();
 
-	// Iterate over rows
-	for(Index i = 1; i <= elements[0]; ++i)
+	// Vertices
+	MV* vertices = mesh.allocateVertices(vertexStride[K]);
+	Parallel::for_range(0, vertexStride[K], [&](Index begin, Index end, Index)
 	{
-		const auto py = ey*(T)i;
-		MV* lastVertex = new MV(offset + py);
-		lastVertex->Flags |= MVF_StrongBoundary;// Set first column as boundary
-
-		mesh.addVertex(lastVertex);
+		for(Index v = begin; v < end; ++v)
+		{
+			Index rest = v;
+			for(Index d = 0; d < K; ++d)
+			{
+				const Index c = rest % (elements[d]+1);
+				rest /= elements[d]+1;
+
+				vertices[v].Vertex[d] = offset[d] + size[d]*(T)c/(T)elements[d];
+				if(c == 0 || c == elements[d])
+					vertices[v].Flags |= MVF_StrongBoundary;
+			}
+		}
+	}, threads);
 
-		for(Index j = 1; j <= elements[1]; ++j)
+	// Elements
+	ME* simplexes = mesh.allocateElements(cellStride[K]*simplices);
+	Parallel::for_range(0, cellStride[K], [&](Index begin, Index end, Index)
+	{
+		for(Index cell = begin; cell < end; ++cell)
 		{
-			MV* v = new MV(offset + ex*(T)j + py);
-			mesh.addVertex(v);
-
-			ME* s1 = new ME();
-			s1->Vertices[0] = lastRowVertices[j-1];
-			s1->Vertices[1] = lastVertex;
-			s1->Vertices[2] = v;
-			mesh.addElement(s1);
-
-			ME* s2 = new ME();
-			s2->Vertices[0] = lastRowVertices[j-1];
-			s2->Vertices[1] = v;
-			s2->Vertices[2] = lastRowVertices[j];
-			mesh.addElement(s2);
-
-			lastRowVertices[j-1] = lastVertex;
-			lastVertex = v;
+			Index rest = cell;
+			Index corner = 0;
+			for(Index d = 0; d < K; ++d)
+			{
+				corner += (rest % elements[d])*vertexStride[d];
+				rest /= elements[d];
+			}
+
+			for(Index s = 0; s < simplices; ++s)
+			{
+				ME& element = simplexes[cell*simplices + s];
+
+				Index current = corner;
+				element.Vertices[0] = &vertices[current];
+				for(Index k = 0; k < K; ++k)
+				{
+					current += vertexStride[permutations[s*K + k]];
+					element.Vertices[k+1] = &vertices[current];
+				}
+
+				if(odd[s])
+					std::swap(element.Vertices[K-1], element.Vertices[K]);
+			}
 		}
+	}, threads);
 
-		lastVertex->Flags |= MVF_StrongBoundary;// Set last column as boundary
+	mesh.connectElements();
+	mesh.setupNeighbors();
+	return mesh;
+}
 
-		lastRowVertices[elements[1]] = lastVertex;
-	}
+template<typename T, Dimension K>
+SparseMatrix<T> HyperCube<T,K>::prolongator(const FixedVector<Dimension,K>& coarseElements)
+{
+	static_assert(K == 2, "Prolongator is only available for two dimensional grids.");
 
-	// Set last row as boundary
-	for(Index j = 0; j <= elements[1]; ++j)
-		lastRowVertices[j]->Flags |= MVF_StrongBoundary;
+	if(coarseElements[0] < 1 || coarseElements[1] < 1)
+		throw InvalidElementCountException();
 
+	const Index coarseRow = coarseElements[0] + 1;
+	const Index fineRow = 2*coarseElements[0] + 1;
+	const Index coarseSize = (coarseElements[1] + 1)*coarseRow;
+	const Index fineSize = (2*coarseElements[1] + 1)*fineRow;
 
-	// Cleanup
-	delete[] lastRowVertices;
+	std::vector<typename SparseMatrix<T>::index_type> rowPtr(fineSize + 1, 0);
+	std::vector<typename SparseMatrix<T>::index_type> columnPtr;
+	std::vector<T> values;
+	columnPtr.reserve(2*fineSize);
+	values.reserve(2*fineSize);
 
-	mesh.setupNeighbors();
-	return mesh;
+	for(Index i = 0; i <= 2*coarseElements[1]; ++i)
+	{
+		for(Index j = 0; j < fineRow; ++j)
+		{
+			const Index c = (i/2)*coarseRow + j/2;
+			const bool oddI = i % 2;
+			const bool oddJ = j % 2;
+
+			if(!oddI && !oddJ)// Coarse vertex
+			{
+				columnPtr.push_back(c);
+				values.push_back((T)1);
+			}
+			else// Mid of a coarse edge. Diagonals go from (i,j) to (i+1,j+1)
+			{
+				columnPtr.push_back(c);
+				values.push_back((T)0.5);
+				columnPtr.push_back(c + (oddI ? coarseRow : 0) + (oddJ ? 1 : 0));
+				values.push_back((T)0.5);
+			}
+
+			rowPtr[i*fineRow + j + 1] = SparseMatrix<T>::to_index(columnPtr.size());
+		}
+	}
+
+	return SparseMatrix<T>(fineSize, coarseSize, std::move(rowPtr), std::move(columnPtr), std::move(values));
 }
 NS_END_NAMESPACE
\ No newline at end of file
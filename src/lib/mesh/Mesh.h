@@ -1,6 +1,12 @@
 #pragma once
 
 #include "Simplex.h"
+#include "Parallel.h"
+#include "matrix/MatrixOrder.h"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <functional>
 #include <unordered_set>
 #include <unordered_map>
 
@@ -33,6 +39,13 @@ enum MeshVertexFlags
 	MVF_Implicit = 0x2// Node only for shape function, but not with a physical meaning
 };
 
+enum MeshRenumbering
+{
+	MR_Hilbert = 0,// Order along a hilbert curve through the vertex positions
+	MR_Morton,// Order along a morton (z-order) curve through the vertex positions
+	MR_ReverseCuthillMcKee// Reverse CutHill-McKee on the vertex graph
+};
+
 template<typename T, Dimension K>
 class MeshVertex
 {
@@ -90,6 +103,13 @@ public:
 	void setElement(Index i, MeshElement<T,K>* element);
 	const MeshElementList& elements() const;
 
+	// Alternative to addVertex and addElement: Storage for count vertices or elements owned by the mesh.
+	// The entries are already added in order. Can only be used once per mesh.
+	// After setting the vertices of all elements connectElements() has to be called.
+	MeshVertex<T,K>* allocateVertices(size_t count);
+	MeshElement<T,K>* allocateElements(size_t count);
+	void connectElements();
+
 	// Third: After build, setup the neighbors
 	void setupNeighbors();
 
@@ -100,14 +120,29 @@ public:
 	// Fourth: (Optional) Automaticly setup boundaries
 	void setupBoundaries();
 
+	// (Optional) Refine marked elements by longest edge bisection. Elements sharing a bisected edge are refined too,
+	// so the mesh stays conforming. Only the neighbors of the refined region are updated.
+	// Has to be called after setupNeighbors and before the shape function prepared the mesh.
+	// Elements have to be prepared again afterwards.
+	void refine(const std::vector<bool>& marked);
+	void refine();// Every element is bisected atleast once
+
+	// Fifth: (Optional) Renumber vertices (GlobalIndex) and sort elements by their vertices
+	// to improve memory locality of assembly and the resulting matrix
+	void renumber(MeshRenumbering method = MR_Hilbert);
+
 	void prepare();
 	void validate() const throw(MeshException);
 private:
+	static uint64 curveKey(uint32* coords, uint32 bits, bool hilbert);
+
 	struct PrivateData
 	{
 		MeshElementList Elements;
 		MeshVertexList Vertices;
 		MeshEdgeList Edges;
+		std::vector<MeshVertex<T,K> > VertexPool;
+		std::vector<MeshElement<T,K> > ElementPool;
 		size_t Refs;
 	}* mData;
 };
@@ -117,13 +117,27 @@ Mesh<T,K>& Mesh<T,K>::operator =(Mesh<T,K>&& other)
 template<typename T, Dimension K>
 void Mesh<T,K>::clear()
 {
+	// Entries in the pools are not allocated one by one
+	const auto inPool = [](const void* ptr, const void* begin, const void* end) {
+		return !std::less<const void*>()(ptr, begin) && std::less<const void*>()(ptr, end); };
+
+	const MeshVertex<T,K>* vertexPool = mData->VertexPool.data();
 	for(auto ptr : mData->Vertices)
-		delete ptr;
+	{
+		if(!inPool(ptr, vertexPool, vertexPool + mData->VertexPool.size()))
+			delete ptr;
+	}
 	mData->Vertices.clear();
+	std::vector<MeshVertex<T,K> >().swap(mData->VertexPool);
 	
+	const MeshElement<T,K>* elementPool = mData->ElementPool.data();
 	for(auto ptr : mData->Elements)
-		delete ptr;
+	{
+		if(!inPool(ptr, elementPool, elementPool + mData->ElementPool.size()))
+			delete ptr;
+	}
 	mData->Elements.clear();
+	std::vector<MeshElement<T,K> >().swap(mData->ElementPool);
 }
 
 template<typename T, Dimension K>
@@ -180,6 +194,66 @@ void Mesh<T,K>::addElement(MeshElement<T,K>* element)
 	}
 }
 
+template<typename T, Dimension K>
+MeshVertex<T,K>* Mesh<T,K>::allocateVertices(size_t count)
+{
+	NS_ASSERT(count > 0);
+	NS_ASSERT(mData->VertexPool.empty());
+
+	mData->VertexPool.resize(count);
+	mData->Vertices.reserve(mData->Vertices.size() + count);
+	for(auto& v : mData->VertexPool)
+	{
+		v.GlobalIndex = mData->Vertices.size();
+		mData->Vertices.push_back(&v);
+	}
+
+	return mData->VertexPool.data();
+}
+
+template<typename T, Dimension K>
+MeshElement<T,K>* Mesh<T,K>::allocateElements(size_t count)
+{
+	NS_ASSERT(count > 0);
+	NS_ASSERT(mData->ElementPool.empty());
+
+	mData->ElementPool.resize(count);
+	mData->Elements.reserve(mData->Elements.size() + count);
+	for(auto& e : mData->ElementPool)
+		mData->Elements.push_back(&e);
+
+	return mData->ElementPool.data();
+}
+
+template<typename T, Dimension K>
+void Mesh<T,K>::connectElements()
+{
+	std::vector<size_t> counts(mData->Vertices.size(), 0);
+	for(auto e : mData->Elements)
+	{
+		for(Index i = 0; i < K+1; ++i)
+		{
+			NS_ASSERT(e->Vertices[i]);
+			++counts[e->Vertices[i]->GlobalIndex];
+		}
+	}
+
+	for(auto v : mData->Vertices)
+	{
+		v->Elements.clear();
+		v->Elements.reserve(counts[v->GlobalIndex]);
+	}
+
+	for(auto e : mData->Elements)
+	{
+		for(Index i = 0; i < K+1; ++i)
+		{
+			e->Element[i] = e->Vertices[i]->Vertex;
+			e->Vertices[i]->Elements.push_back(e);
+		}
+	}
+}
+
 template<typename T, Dimension K>
 MeshElement<T,K>* Mesh<T,K>::element(Index i) const
 {
@@ -213,90 +287,124 @@ const typename Mesh<T,K>::MeshEdgeList& Mesh<T,K>::edges() const
 template<typename T, Dimension K>
 void Mesh<T,K>::setupNeighbors()
 {
-	for(const auto& S : mData->Elements)
+	typedef std::array<Index, K+1> FaceKey;// Sorted vertex indices and the face itself
+
+	const Index vertexCount = mData->Vertices.size();
+	const Index elementCount = mData->Elements.size();
+
+	// Compact vertex indices of every element
+	std::vector<Index> connectivity(elementCount*(K+1));
+	Parallel::for_range(0, elementCount, [&](Index begin, Index end, Index)
+	{
+		for(Index e = begin; e < end; ++e)
+		{
+			for(Index k = 0; k < K+1; ++k)
+			{
+				NS_ASSERT(mData->Elements[e]->Vertices[k]->GlobalIndex < vertexCount);
+				connectivity[e*(K+1) + k] = mData->Elements[e]->Vertices[k]->GlobalIndex;
+			}
+		}
+	});
+
+	const auto faceKey = [&](Index face)
 	{
-		size_t nextEntry = 0;
+		FaceKey key;
+		const Index* vertices = &connectivity[face - face % (K+1)];
+		for(Index j = 0, k = 0; j < K+1; ++j)
+		{
+			if(j != face % (K+1))
+				key[k++] = vertices[j];
+		}
+		std::sort(key.begin(), key.begin() + K);
+		key[K] = face;
+		return key;
+	};
+
+	// Bucket all faces by their smallest vertex. Faces shared by two elements end up in the same bucket.
+	std::vector<Index> bucketPtr(vertexCount + 1, 0);
+	for(Index f = 0; f < elementCount*(K+1); ++f)
+		++bucketPtr[faceKey(f)[0] + 1];
 
+	for(Index v = 0; v < vertexCount; ++v)
+		bucketPtr[v+1] += bucketPtr[v];
+
+	std::vector<Index> buckets(elementCount*(K+1));
+	{
+		std::vector<Index> next(bucketPtr.begin(), bucketPtr.end() - 1);
+		for(Index f = 0; f < elementCount*(K+1); ++f)
+			buckets[next[faceKey(f)[0]]++] = f;
+	}
+
+	// Find the element on the other side of every face
+	std::vector<MeshElement<T,K>*> opposite(elementCount*(K+1), nullptr);
+	std::atomic<bool> tooManyShared(false);
+	Parallel::for_range(0, vertexCount, [&](Index begin, Index end, Index)
+	{
+		std::vector<FaceKey> keys;
+		for(Index v = begin; v < end; ++v)
+		{
+			keys.clear();
+			for(Index b = bucketPtr[v]; b < bucketPtr[v+1]; ++b)
+				keys.push_back(faceKey(buckets[b]));
+
+			std::sort(keys.begin(), keys.end());
+			for(Index a = 0; a < keys.size(); )
+			{
+				Index b = a + 1;
+				while(b < keys.size() && std::equal(keys[a].begin(), keys[a].begin() + K, keys[b].begin()))
+					++b;
+
+				if(b - a > 2)
+					tooManyShared = true;
+				else if(b - a == 2)
+				{
+					opposite[keys[a][K]] = mData->Elements[keys[a+1][K] / (K+1)];
+					opposite[keys[a+1][K]] = mData->Elements[keys[a][K] / (K+1)];
+				}
+				a = b;
+			}
+		}
+	});
+
+	if(tooManyShared)
+		throw TooManySharedFacesException();
+
+	// Create the edges and set the neighbor of both sides
+	for(Index e = 0; e < elementCount; ++e)
+	{
+		MeshElement<T,K>* S = mData->Elements[e];
 		for(Index i = 0; i < K+1; ++i)
 		{
 			if(S->Neighbors[i])// Already set
 				continue;
 
+			MeshEdge<T,K>* edge = new MeshEdge<T,K>();
+			edge->Elements[0] = S;
+			edge->Elements[1] = opposite[e*(K+1) + i];
+
 			size_t sharedVertices = 0;
-			MeshVertex<T,K>* shared[K];
 			for(Index j = 0; j < K+1; ++j)
 			{
 				if(i == j)
 					continue;
 
-				shared[sharedVertices] = S->Vertices[j];
+				edge->Vertices[sharedVertices] = S->Vertices[j];
 				sharedVertices++;
 			}
 
 			if(sharedVertices != K)
 				throw MalformedElementNeighborConnectionException();
-
-			// Create edge
-			MeshEdge<T,K>* edge = new MeshEdge<T,K>();
-			edge->Elements[0] = S;
-
-			for(Index j = 0; j < K; ++j)
-				edge->Vertices[j] = shared[j];
 			
 			S->Neighbors[i] = edge;
-
 			mData->Edges.push_back(edge);
 
-			// Find corresponding other element if exists
-			for(Index j = 0; j < K; ++j)
-			{
-				// Iterate through all vertices of other element
-				for(auto oe : shared[j]->Elements)
-				{
-					if(oe == S)
-						continue;
-						
-					size_t matches = 0;
-					for(auto ov : oe->Vertices)
-					{
-						for(Index k = 0; k < K; ++k)
-						{
-							if(shared[k] == ov)
-							{
-								matches++;
-								break;
-							}
-						}
-					}
-
-					if(matches == K)
-					{
-						if(edge->Elements[1] && edge->Elements[1] != oe)
-							throw TooManySharedFacesException();
-						
-						edge->Elements[1] = oe;
-					}
-				}
-			}
-
 			// For symmetric reasons set found element neighbor too
 			if(edge->Elements[1])
 			{
 				// First find the corresponding vertex not in the edge
 				for(Index j = 0; j < K+1; ++j)
 				{
-					bool found = false;
-					for(Index k = 0; k < K; ++k)
-					{
-						if(shared[k] == edge->Elements[1]->Vertices[j])
-						{
-							found = true;
-							break;
-						}
-					}
-
-					// Add if found
-					if(!found)
+					if(std::find(edge->Vertices, edge->Vertices + K, edge->Elements[1]->Vertices[j]) == edge->Vertices + K)
 					{
 						edge->Elements[1]->Neighbors[j] = edge;
 						break;
@@ -402,4 +510,509 @@ void Mesh<T,K>::setupBoundaries()
 		}
 	}
 }
+
+template<typename T, Dimension K>
+void Mesh<T,K>::refine()
+{
+	refine(std::vector<bool>(mData->Elements.size(), true));
+}
+
+template<typename T, Dimension K>
+void Mesh<T,K>::refine(const std::vector<bool>& marked)
+{
+	typedef MeshVertex<T,K> MV;
+	typedef MeshElement<T,K> ME;
+	typedef std::array<MV*, K+1> Cell;
+	typedef std::array<MV*, K> FaceKey;
+	typedef std::pair<MV*, MV*> EdgeKey;
+
+	struct Pending
+	{
+		ME* Parent;
+		Cell Vertices;
+		bool Force;
+	};
+
+	struct EdgeHash
+	{
+		size_t operator()(const EdgeKey& key) const
+		{
+			const size_t h = std::hash<MV*>()(key.first);
+			return h ^ (std::hash<MV*>()(key.second) + 0x9e3779b9 + (h << 6) + (h >> 2));
+		}
+	};
+
+	struct FaceHash
+	{
+		size_t operator()(const FaceKey& key) const
+		{
+			size_t h = 0;
+			for(auto v : key)
+				h ^= std::hash<MV*>()(v) + 0x9e3779b9 + (h << 6) + (h >> 2);
+			return h;
+		}
+	};
+
+	NS_ASSERT(marked.size() == mData->Elements.size());
+
+	const auto edgeKey = [](MV* a, MV* b) { return std::less<MV*>()(a, b) ? EdgeKey(a, b) : EdgeKey(b, a); };
+	const auto indexKey = [](MV* a, MV* b)
+	{
+		return std::make_pair(std::min(a->GlobalIndex, b->GlobalIndex), std::max(a->GlobalIndex, b->GlobalIndex));
+	};
+	const auto contains = [](MV* const* vertices, MV* v) { return std::find(vertices, vertices + K+1, v) != vertices + K+1; };
+	const auto faceKey = [](MV* const* vertices, Index i)
+	{
+		FaceKey key;
+		for(Index j = 0, k = 0; j < K+1; ++j)
+		{
+			if(j != i)
+				key[k++] = vertices[j];
+		}
+		std::sort(key.begin(), key.end(), std::less<MV*>());
+		return key;
+	};
+
+	std::unordered_map<EdgeKey, MV*, EdgeHash> midpoints;
+	std::vector<EdgeKey> origins;// Bisected edges in order of the new vertices
+	std::unordered_map<MV*, std::vector<ME*> > newVertexElements;// Refined elements containing a new vertex
+	std::unordered_map<ME*, std::vector<Cell> > leaves;// Current children of refined elements
+	std::vector<ME*> refined;
+	std::vector<Pending> pending;
+
+	const auto take = [&](ME* element, bool force)
+	{
+		leaves[element];
+		refined.push_back(element);
+
+		Pending p;
+		p.Parent = element;
+		std::copy(element->Vertices, element->Vertices + K+1, p.Vertices.begin());
+		p.Force = force;
+		pending.push_back(p);
+	};
+
+	for(Index e = 0; e < mData->Elements.size(); ++e)
+	{
+		if(marked[e])
+		{
+			NS_ASSERT(mData->Elements[e]->DOFVertices.empty());
+			take(mData->Elements[e], true);
+		}
+	}
+
+	// Bisect until no element has a hanging vertex.
+	// The longest edge is taken with a tie break by the global indices, so all elements sharing it will agree on it
+	// and the result does not depend on the memory layout.
+	while(!pending.empty())
+	{
+		Pending current = pending.back();
+		pending.pop_back();
+
+		Index p = 0;
+		Index q = 1;
+		bool hanging = false;
+		double longest = -1;
+		for(Index a = 0; a < K+1; ++a)
+		{
+			for(Index b = a+1; b < K+1; ++b)
+			{
+				hanging = hanging || midpoints.count(edgeKey(current.Vertices[a], current.Vertices[b]));
+
+				const double length = std::abs((current.Vertices[a]->Vertex - current.Vertices[b]->Vertex).magSqr());
+				if(length > longest ||
+					(length == longest && indexKey(current.Vertices[p], current.Vertices[q]) <
+						indexKey(current.Vertices[a], current.Vertices[b])))
+				{
+					longest = length;
+					p = a;
+					q = b;
+				}
+			}
+		}
+
+		if(!current.Force && !hanging)
+		{
+			leaves[current.Parent].push_back(current.Vertices);
+			continue;
+		}
+
+		MV* a = current.Vertices[p];
+		MV* b = current.Vertices[q];
+
+		MV* m;
+		auto it = midpoints.find(edgeKey(a, b));
+		if(it != midpoints.end())
+		{
+			m = it->second;
+		}
+		else
+		{
+			m = new MV((a->Vertex + b->Vertex)/(T)2);
+			addVertex(m);
+			midpoints[edgeKey(a, b)] = m;
+			origins.push_back(edgeKey(a, b));
+
+			// All other elements containing the edge have now a hanging vertex
+			auto nit = newVertexElements.find(a);
+			const std::vector<ME*>& candidates = nit != newVertexElements.end() ? nit->second : a->Elements;
+			for(ME* element : candidates)
+			{
+				auto lit = leaves.find(element);
+				if(lit == leaves.end())
+				{
+					if(contains(element->Vertices, b))
+						take(element, false);
+				}
+				else
+				{
+					std::vector<Cell>& cells = lit->second;
+					for(Index c = 0; c < cells.size(); )
+					{
+						if(contains(cells[c].data(), a) && contains(cells[c].data(), b))
+						{
+							Pending other;
+							other.Parent = element;
+							other.Vertices = cells[c];
+							other.Force = false;
+							pending.push_back(other);
+
+							cells[c] = cells.back();
+							cells.pop_back();
+						}
+						else
+						{
+							++c;
+						}
+					}
+				}
+			}
+		}
+
+		std::vector<ME*>& elements = newVertexElements[m];
+		if(std::find(elements.begin(), elements.end(), current.Parent) == elements.end())
+			elements.push_back(current.Parent);
+
+		Pending first = current;
+		first.Vertices[p] = m;
+		first.Force = false;
+		Pending second = current;
+		second.Vertices[q] = m;
+		second.Force = false;
+
+		pending.push_back(second);
+		pending.push_back(first);
+	}
+
+	if(refined.empty())
+		return;
+
+	// Replace the refined elements by their children and connect the faces.
+	// Unchanged faces to not refined elements are kept, all others are replaced.
+	struct OpenFace
+	{
+		ME* Element;
+		Index Face;
+		bool Closed;
+	};
+
+	std::unordered_set<MeshEdge<T,K>*> obsolete;
+	std::unordered_map<FaceKey, Index, FaceHash> openFaceIndex;
+	std::vector<OpenFace> openFaces;
+
+	const auto connect = [&](ME* element, Index i, ME* other)
+	{
+		MeshEdge<T,K>* edge = new MeshEdge<T,K>();
+		edge->Elements[0] = element;
+		edge->Elements[1] = other;
+
+		for(Index j = 0, k = 0; j < K+1; ++j)
+		{
+			if(j != i)
+				edge->Vertices[k++] = element->Vertices[j];
+		}
+
+		element->Neighbors[i] = edge;
+		mData->Edges.push_back(edge);
+		return edge;
+	};
+
+	for(ME* parent : refined)
+	{
+		const std::vector<Cell>& cells = leaves[parent];
+
+		MeshEdge<T,K>* oldFaces[K+1];
+		FaceKey oldKeys[K+1];
+		for(Index i = 0; i < K+1; ++i)
+		{
+			oldFaces[i] = parent->Neighbors[i];
+			oldKeys[i] = faceKey(parent->Vertices, i);
+			obsolete.insert(oldFaces[i]);
+		}
+
+		for(auto v : parent->Vertices)
+			v->Elements.erase(std::find(v->Elements.begin(), v->Elements.end(), parent));
+
+		for(Index c = 0; c < cells.size(); ++c)
+		{
+			ME* child = parent;
+			if(c == 0)
+			{
+				parent->Element = Simplex<T,K>();
+				for(Index i = 0; i < K+1; ++i)
+				{
+					parent->Vertices[i] = cells[c][i];
+					parent->Element[i] = parent->Vertices[i]->Vertex;
+					parent->Vertices[i]->Elements.push_back(parent);
+				}
+			}
+			else
+			{
+				child = new ME();
+				std::copy(cells[c].begin(), cells[c].end(), child->Vertices);
+				addElement(child);
+			}
+
+			for(Index i = 0; i < K+1; ++i)
+			{
+				child->Neighbors[i] = nullptr;
+				const FaceKey key = faceKey(child->Vertices, i);
+
+				// Same face as before to a not refined element?
+				for(Index j = 0; j < K+1; ++j)
+				{
+					MeshEdge<T,K>* edge = oldFaces[j];
+					ME* other = edge->Elements[0] == parent ? edge->Elements[1] : edge->Elements[0];
+					if(key == oldKeys[j] && !leaves.count(other))
+					{
+						edge->Elements[edge->Elements[0] == parent ? 0 : 1] = child;
+						child->Neighbors[i] = edge;
+						obsolete.erase(edge);
+						break;
+					}
+				}
+
+				if(child->Neighbors[i])
+					continue;
+
+				auto it = openFaceIndex.find(key);
+				if(it == openFaceIndex.end())
+				{
+					openFaceIndex[key] = openFaces.size();
+
+					OpenFace face;
+					face.Element = child;
+					face.Face = i;
+					face.Closed = false;
+					openFaces.push_back(face);
+				}
+				else
+				{
+					OpenFace& face = openFaces[it->second];
+					NS_ASSERT(!face.Closed);
+					face.Closed = true;
+					child->Neighbors[i] = connect(face.Element, face.Face, child);
+				}
+			}
+		}
+	}
+
+	// Remaining faces are new boundary faces
+	std::unordered_set<MV*> boundary;
+	for(const OpenFace& face : openFaces)
+	{
+		if(face.Closed)
+			continue;
+
+		MeshEdge<T,K>* edge = connect(face.Element, face.Face, nullptr);
+		for(Index j = 0; j < K; ++j)
+			boundary.insert(edge->Vertices[j]);
+	}
+
+	// New vertices on the boundary are only strong if the bisected edge was
+	for(const EdgeKey& origin : origins)
+	{
+		MV* m = midpoints[origin];
+		if(boundary.count(m))
+			m->Flags |= origin.first->Flags & origin.second->Flags & MVF_StrongBoundary;
+	}
+
+	mData->Edges.erase(std::remove_if(mData->Edges.begin(), mData->Edges.end(),
+		[&](MeshEdge<T,K>* edge) { return obsolete.count(edge) != 0; }), mData->Edges.end());
+	for(auto edge : obsolete)
+		delete edge;
+}
+
+template<typename T, Dimension K>
+void Mesh<T,K>::renumber(MeshRenumbering method)
+{
+	const Index n = mData->Vertices.size();
+	if(n == 0)
+		return;
+
+	std::vector<Index> order(n);// order[new] = old
+	for(Index i = 0; i < n; ++i)
+		order[i] = i;
+
+	if(method == MR_ReverseCuthillMcKee)
+	{
+		// Vertex graph; vertices sharing an element are connected
+		std::vector<Index> rowPtr(n + 1, 0);
+		for(auto s : mData->Elements)
+		{
+			const size_t count = s->DOFVertices.empty() ? K+1 : s->DOFVertices.size();
+			for(size_t i = 0; i < count; ++i)
+				rowPtr[(s->DOFVertices.empty() ? s->Vertices[i] : s->DOFVertices[i])->GlobalIndex + 1] += count;
+		}
+		for(Index i = 0; i < n; ++i)
+			rowPtr[i + 1] += rowPtr[i];
+
+		std::vector<Index> columns(rowPtr[n]);
+		std::vector<Index> next(rowPtr.begin(), rowPtr.end() - 1);
+		for(auto s : mData->Elements)
+		{
+			const auto& dof = s->DOFVertices;
+			const size_t count = dof.empty() ? K+1 : dof.size();
+			for(size_t i = 0; i < count; ++i)
+			{
+				const Index vi = (dof.empty() ? s->Vertices[i] : dof[i])->GlobalIndex;
+				for(size_t j = 0; j < count; ++j)
+					columns[next[vi]++] = (dof.empty() ? s->Vertices[j] : dof[j])->GlobalIndex;
+			}
+		}
+
+		// Sort and remove duplicates
+		std::vector<Index> patternPtr(n + 1, 0);
+		std::vector<Index> patternColumns;
+		patternColumns.reserve(columns.size());
+		for(Index i = 0; i < n; ++i)
+		{
+			std::sort(columns.begin() + rowPtr[i], columns.begin() + rowPtr[i+1]);
+			for(Index k = rowPtr[i]; k < rowPtr[i+1]; ++k)
+			{
+				if(k == rowPtr[i] || columns[k] != columns[k-1])
+					patternColumns.push_back(columns[k]);
+			}
+			patternPtr[i + 1] = patternColumns.size();
+		}
+
+		std::vector<T> values(patternColumns.size(), (T)1);
+		const SparseMatrix<T> pattern(n, n, std::move(patternPtr), std::move(patternColumns), std::move(values));
+
+		const auto r = r_cuthill_mckee(pattern);
+		for(Index i = 0; i < n; ++i)
+			order[i] = r[i];
+	}
+	else
+	{
+		// Quantize the bounding box to an integer grid
+		typedef decltype(std::real(T())) real_type;
+		const uint32 bits = std::min<uint32>(21, 63/K);
+		const real_type cells = (real_type)((1u << bits) - 1);
+
+		real_type lower[K];
+		real_type upper[K];
+		for(Index d = 0; d < K; ++d)
+		{
+			lower[d] = std::numeric_limits<real_type>::max();
+			upper[d] = std::numeric_limits<real_type>::lowest();
+		}
+
+		for(auto v : mData->Vertices)
+		{
+			for(Index d = 0; d < K; ++d)
+			{
+				lower[d] = std::min(lower[d], (real_type)std::real(v->Vertex[d]));
+				upper[d] = std::max(upper[d], (real_type)std::real(v->Vertex[d]));
+			}
+		}
+
+		std::vector<uint64> keys(n);
+		for(Index i = 0; i < n; ++i)
+		{
+			uint32 coords[K];
+			for(Index d = 0; d < K; ++d)
+			{
+				const real_type extent = upper[d] - lower[d];
+				coords[d] = extent > 0 ?
+					(uint32)((std::real(mData->Vertices[i]->Vertex[d]) - lower[d]) / extent * cells) : 0;
+			}
+			keys[i] = curveKey(coords, bits, method == MR_Hilbert);
+		}
+
+		std::stable_sort(order.begin(), order.end(),
+			[&](Index a, Index b) { return keys[a] < keys[b]; });
+	}
+
+	MeshVertexList vertices(n);
+	for(Index i = 0; i < n; ++i)
+	{
+		vertices[i] = mData->Vertices[order[i]];
+		vertices[i]->GlobalIndex = i;
+	}
+	mData->Vertices.swap(vertices);
+
+	// Elements follow their lowest vertex index
+	const auto firstVertex = [](const MeshElement<T,K>* s)
+	{
+		Index m = s->Vertices[0]->GlobalIndex;
+		for(Index i = 1; i < K+1; ++i)
+			m = std::min(m, s->Vertices[i]->GlobalIndex);
+		return m;
+	};
+
+	std::stable_sort(mData->Elements.begin(), mData->Elements.end(),
+		[&](const MeshElement<T,K>* a, const MeshElement<T,K>* b) { return firstVertex(a) < firstVertex(b); });
+}
+
+template<typename T, Dimension K>
+uint64 Mesh<T,K>::curveKey(uint32* coords, uint32 bits, bool hilbert)
+{
+	if(hilbert)
+	{
+		// Skilling's transform of the axes into the transposed hilbert index
+		const uint32 M = 1u << (bits - 1);
+		for(uint32 Q = M; Q > 1; Q >>= 1)
+		{
+			const uint32 P = Q - 1;
+			for(Index i = 0; i < K; ++i)
+			{
+				if(coords[i] & Q)
+				{
+					coords[0] ^= P;
+				}
+				else
+				{
+					const uint32 t = (coords[0] ^ coords[i]) & P;
+					coords[0] ^= t;
+					coords[i] ^= t;
+				}
+			}
+		}
+
+		// Gray encode
+		for(Index i = 1; i < K; ++i)
+			coords[i] ^= coords[i-1];
+
+		uint32 t = 0;
+		for(uint32 Q = M; Q > 1; Q >>= 1)
+		{
+			if(coords[K-1] & Q)
+				t ^= Q - 1;
+		}
+
+		for(Index i = 0; i < K; ++i)
+			coords[i] ^= t;
+	}
+
+	// Interleave the bits, highest first
+	uint64 key = 0;
+	for(uint32 b = bits; b > 0; --b)
+	{
+		for(Index i = 0; i < K; ++i)
+			key = (key << 1) | ((coords[i] >> (b - 1)) & 1);
+	}
+
+	return key;
+}
 NS_END_NAMESPACE
\ No newline at end of file
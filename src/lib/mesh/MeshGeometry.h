@@ -0,0 +1,60 @@
+#pragma once
+
+#include "Mesh.h"
+#include "Parallel.h"
+
+NS_BEGIN_NAMESPACE
+
+/**
+ * @brief Geometry of all elements of a mesh in SoA layout.
+ * @details Contains for every element the inverse jacobian, the absolute determinant
+ * and the diameter. Every component is stored in its own contiguous array,
+ * which makes loops over all elements stream through memory.
+ * The data has to be rebuild after the mesh changed.
+ */
+template<typename T, Dimension K>
+class MeshGeometry
+{
+public:
+	typedef FixedVector<T,K> vertex_t;
+	typedef FixedMatrix<T,K,K> matrix_t;
+
+	MeshGeometry();
+	explicit MeshGeometry(const Mesh<T,K>& mesh, size_t threads = 0);
+
+	/**
+	 * @brief Computes the geometry of all elements in parallel.
+	 * @param threads Amount of threads to use. 0 uses Parallel::thread_count().
+	 */
+	void build(const Mesh<T,K>& mesh, size_t threads = 0);
+	void clear();
+
+	Index size() const;
+
+	T inverseJacobian(Index element, Index row, Index column) const;
+	matrix_t inverseJacobian(Index element) const;
+	// Same as inverseJacobian(element).mul(v), but without the temporary matrix
+	vertex_t mulInverseJacobian(Index element, const vertex_t& v) const;
+	// Entry (row, column) of all inverse jacobians
+	const T* inverseJacobianComponent(Index row, Index column) const;
+
+	// Absolute value of the determinant
+	T determinant(Index element) const;
+	const T* determinants() const;
+
+	T diameter(Index element) const;
+	const T* diameters() const;
+
+private:
+	Index mSize;
+	std::vector<T> mInverseJacobian;// [(row*K+column)*mSize + element]
+	std::vector<T> mDeterminant;
+	std::vector<T> mDiameter;
+};
+
+NS_END_NAMESPACE
+
+
+#define _NS_MESHGEOMETRY_INL
+# include "MeshGeometry.inl"
+#undef _NS_MESHGEOMETRY_INL
\ No newline at end of file
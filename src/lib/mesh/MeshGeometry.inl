@@ -0,0 +1,144 @@
+#ifndef _NS_MESHGEOMETRY_INL
+# error MeshGeometry.inl should only be included by MeshGeometry.h
+#endif
+
+NS_BEGIN_NAMESPACE
+
+template<typename T, Dimension K>
+MeshGeometry<T,K>::MeshGeometry() :
+	mSize(0)
+{
+}
+
+template<typename T, Dimension K>
+MeshGeometry<T,K>::MeshGeometry(const Mesh<T,K>& mesh, size_t threads) :
+	mSize(0)
+{
+	build(mesh, threads);
+}
+
+template<typename T, Dimension K>
+void MeshGeometry<T,K>::build(const Mesh<T,K>& mesh, size_t threads)
+{
+	const typename Mesh<T,K>::MeshElementList& elements = mesh.elements();
+
+	mSize = elements.size();
+	mInverseJacobian.resize(K*K*mSize);
+	mDeterminant.resize(mSize);
+	mDiameter.resize(mSize);
+
+	Parallel::for_range(0, mSize, [&](Index begin, Index end, Index)
+	{
+		for(Index e = begin; e < end; ++e)
+		{
+			// Work on a copy, the mesh itself stays untouched
+			Simplex<T,K> simplex = elements[e]->Element;
+			simplex.prepare();
+
+			const matrix_t& inv = simplex.inverseMatrix();
+			for(Index i = 0; i < K; ++i)
+			{
+				for(Index j = 0; j < K; ++j)
+					mInverseJacobian[(i*K + j)*mSize + e] = inv.at(i,j);
+			}
+
+			mDeterminant[e] = std::abs(simplex.determinant());
+
+			// Same as Simplex::diameter(), but also usable with complex numbers
+			typename get_complex_internal<T>::type d = 0;
+			for(Index i = 0; i < K+1; ++i)
+			{
+				for(Index j = i+1; j < K+1; ++j)
+					d = std::max(d, std::abs((simplex[i]-simplex[j]).magSqr()));
+			}
+			mDiameter[e] = std::sqrt(d);
+		}
+	}, threads);
+}
+
+template<typename T, Dimension K>
+void MeshGeometry<T,K>::clear()
+{
+	mSize = 0;
+	mInverseJacobian.clear();
+	mDeterminant.clear();
+	mDiameter.clear();
+}
+
+template<typename T, Dimension K>
+Index MeshGeometry<T,K>::size() const
+{
+	return mSize;
+}
+
+template<typename T, Dimension K>
+T MeshGeometry<T,K>::inverseJacobian(Index element, Index row, Index column) const
+{
+	NS_ASSERT(element < mSize && row < K && column < K);
+	return mInverseJacobian[(row*K + column)*mSize + element];
+}
+
+template<typename T, Dimension K>
+typename MeshGeometry<T,K>::matrix_t MeshGeometry<T,K>::inverseJacobian(Index element) const
+{
+	NS_ASSERT(element < mSize);
+
+	matrix_t m;
+	for(Index i = 0; i < K; ++i)
+	{
+		for(Index j = 0; j < K; ++j)
+			m.set(i, j, mInverseJacobian[(i*K + j)*mSize + element]);
+	}
+	return m;
+}
+
+template<typename T, Dimension K>
+typename MeshGeometry<T,K>::vertex_t MeshGeometry<T,K>::mulInverseJacobian(Index element, const vertex_t& v) const
+{
+	NS_ASSERT(element < mSize);
+
+	vertex_t r;
+	for(Index i = 0; i < K; ++i)
+	{
+		T s = 0;
+		for(Index j = 0; j < K; ++j)
+			s += mInverseJacobian[(i*K + j)*mSize + element] * v[j];
+		r[i] = s;
+	}
+	return r;
+}
+
+template<typename T, Dimension K>
+const T* MeshGeometry<T,K>::inverseJacobianComponent(Index row, Index column) const
+{
+	NS_ASSERT(row < K && column < K);
+	return mInverseJacobian.data() + (row*K + column)*mSize;
+}
+
+template<typename T, Dimension K>
+T MeshGeometry<T,K>::determinant(Index element) const
+{
+	NS_ASSERT(element < mSize);
+	return mDeterminant[element];
+}
+
+template<typename T, Dimension K>
+const T* MeshGeometry<T,K>::determinants() const
+{
+	return mDeterminant.data();
+}
+
+template<typename T, Dimension K>
+T MeshGeometry<T,K>::diameter(Index element) const
+{
+	NS_ASSERT(element < mSize);
+	return mDiameter[element];
+}
+
+template<typename T, Dimension K>
+const T* MeshGeometry<T,K>::diameters() const
+{
+	return mDiameter.data();
+}
+
+NS_END_NAMESPACE
\ No newline at end of file
@@ -4,6 +4,23 @@
 
 NS_BEGIN_NAMESPACE
 
+/**
+ * @brief Quadrature points handed to batch functors in SoA layout.
+ * @details Global[d][i] is the d-th global coordinate of the i-th point.
+ * The points of element e are stored at [e*PointsPerElement, (e+1)*PointsPerElement).
+ * Local[d][q] is the d-th reference coordinate of the q-th quadrature point and
+ * has only PointsPerElement entries, as it is the same for all elements.
+ * The i-th point therefore uses Local[d][i % PointsPerElement].
+ */
+template<typename T, Dimension K>
+struct QuadratureBatch
+{
+	Index Size;
+	Index PointsPerElement;
+	const T* Global[K];
+	const T* Local[K];
+};
+
 /**
  * @brief Calculates the quadrature on the standard K-Simplex.
  */
@@ -11,13 +28,49 @@ template<template<typename,Dimension,Dimension> class Factory, typename T, Dimen
 class Quadrature : Factory<T,K,Order>
 {
 public:
-	Quadrature() : Factory<T,K,Order>() {}
+	Quadrature();
 
 	template<class F, typename RT = typename std::remove_cv<typename std::result_of<F(FixedVector<T,K>)>::type>::type>
 	RT eval(const F& func, const RT& start = (RT)0) const;
 
 	template<class F, typename RT = typename std::remove_cv<typename std::result_of<F(Index,FixedVector<T,K>)>::type>::type>
 	RT eval_index(const F& func, const RT& start = (RT)0) const;
+
+	/**
+	 * @brief Evaluates the quadrature with all points of the element mapped to global coordinates.
+	 * @details The functor is called only once with the signature
+	 * `void(const QuadratureBatch<T,K>& batch, T* values)` and has to write batch.Size values.
+	 * Like eval() the result is not scaled by the determinant of the element.
+	 */
+	template<class F>
+	T eval_batch(const F& func, const Simplex<T,K>& element, const T& start = (T)0) const;
+
+	/**
+	 * @brief Same as above, but keeps the mapped points and the values in buffer.
+	 * @details buffer is resized if necessary, so reusing it for multiple calls avoids the allocations.
+	 */
+	template<class F>
+	T eval_batch(const F& func, const Simplex<T,K>& element, std::vector<T>& buffer, const T& start = (T)0) const;
+
+	/**
+	 * @brief Evaluates the quadrature for all elements in [begin, end) with one functor call.
+	 * @details The iterator has to point to Simplex<T,K> or Simplex<T,K>*.
+	 * The result of the i-th element is written to results[i].
+	 */
+	template<class F, class Iterator>
+	void eval_batch(const F& func, Iterator begin, Iterator end, T* results) const;
+
+	/**
+	 * @brief Same as above, but keeps the mapped points and the values in buffer.
+	 * @details buffer is resized if necessary, so reusing it for multiple calls avoids the allocations.
+	 */
+	template<class F, class Iterator>
+	void eval_batch(const F& func, Iterator begin, Iterator end, T* results, std::vector<T>& buffer) const;
+
+	Index pointCount() const;
+
+private:
+	std::vector<T> mLocal;// SoA: mLocal[d*pointCount()+i]
 };
 
 template<typename T, Dimension K, Dimension Order>
@@ -5,6 +5,20 @@
 
 NS_BEGIN_NAMESPACE
 
+template<template<typename,Dimension,Dimension> class Factory, typename T, Dimension K, Dimension Order>
+Quadrature<Factory, T, K, Order>::Quadrature() :
+	Factory<T,K,Order>()
+{
+	const std::vector<FixedVector<T,K> >& points = this->getQuadraturePoints();
+
+	mLocal.resize(K*points.size());
+	for(Index d = 0; d < K; ++d)
+	{
+		for(Index i = 0; i < points.size(); ++i)
+			mLocal[d*points.size() + i] = points[i][d];
+	}
+}
+
 template<template<typename,Dimension,Dimension> class Factory, typename T, Dimension K, Dimension Order>
 template<class F, typename RT>
 RT Quadrature<Factory, T, K, Order>::eval(const F& func, const RT& start) const
@@ -37,4 +51,113 @@ RT Quadrature<Factory, T, K, Order>::eval_index(const F& func, const RT& start)
 	return v;
 }
 
+template<typename T, Dimension K>
+inline const Simplex<T,K>& quadrature_element(const Simplex<T,K>& element)
+{
+	return element;
+}
+
+template<typename T, Dimension K>
+inline const Simplex<T,K>& quadrature_element(const Simplex<T,K>* element)
+{
+	return *element;
+}
+
+template<template<typename,Dimension,Dimension> class Factory, typename T, Dimension K, Dimension Order>
+template<class F>
+T Quadrature<Factory, T, K, Order>::eval_batch(const F& func, const Simplex<T,K>& element, const T& start) const
+{
+	std::vector<T> buffer;
+	return eval_batch(func, element, buffer, start);
+}
+
+template<template<typename,Dimension,Dimension> class Factory, typename T, Dimension K, Dimension Order>
+template<class F>
+T Quadrature<Factory, T, K, Order>::eval_batch(const F& func, const Simplex<T,K>& element, std::vector<T>& buffer,
+	const T& start) const
+{
+	T v = (T)0;
+	eval_batch(func, &element, &element + 1, &v, buffer);
+	return start + v;
+}
+
+template<template<typename,Dimension,Dimension> class Factory, typename T, Dimension K, Dimension Order>
+template<class F, class Iterator>
+void Quadrature<Factory, T, K, Order>::eval_batch(const F& func, Iterator begin, Iterator end, T* results) const
+{
+	std::vector<T> buffer;
+	eval_batch(func, begin, end, results, buffer);
+}
+
+template<template<typename,Dimension,Dimension> class Factory, typename T, Dimension K, Dimension Order>
+template<class F, class Iterator>
+void Quadrature<Factory, T, K, Order>::eval_batch(const F& func, Iterator begin, Iterator end, T* results,
+	std::vector<T>& buffer) const
+{
+	const std::vector<T>& weights = this->getQuadratureWeights();
+	const Index points = weights.size();
+	const Index elements = std::distance(begin, end);
+	const Index size = elements*points;
+
+	if(size == 0)
+		return;
+
+	// K coordinates and the value of every point
+	if(buffer.size() < (K + 1)*size)
+		buffer.resize((K + 1)*size);
+
+	// Map all points of all elements: x = v0 + sum_c local[c]*(v_(c+1) - v0)
+	T* global = buffer.data();
+	T* values = global + K*size;
+	Index e = 0;
+	for(Iterator it = begin; it != end; ++it, ++e)
+	{
+		const Simplex<T,K>& element = quadrature_element(*it);
+
+		for(Index d = 0; d < K; ++d)
+		{
+			T* dst = &global[d*size + e*points];
+			const T origin = element[0][d];
+
+			for(Index q = 0; q < points; ++q)
+				dst[q] = origin;
+
+			for(Index c = 0; c < K; ++c)
+			{
+				const T dir = element[c+1][d] - origin;
+				const T* local = &mLocal[c*points];
+
+				for(Index q = 0; q < points; ++q)
+					dst[q] += dir * local[q];
+			}
+		}
+	}
+
+	QuadratureBatch<T,K> batch;
+	batch.Size = size;
+	batch.PointsPerElement = points;
+	for(Index d = 0; d < K; ++d)
+	{
+		batch.Global[d] = &global[d*size];
+		batch.Local[d] = &mLocal[d*points];
+	}
+
+	func(batch, values);
+
+	for(e = 0; e < elements; ++e)
+	{
+		T v = 0;
+		for(Index q = 0; q < points; ++q)
+			v += weights[q] * values[e*points + q];
+
+		results[e] = v;
+	}
+}
+
+template<template<typename,Dimension,Dimension> class Factory, typename T, Dimension K, Dimension Order>
+Index Quadrature<Factory, T, K, Order>::pointCount() const
+{
+	return this->getQuadratureWeights().size();
+}
+
 NS_END_NAMESPACE
\ No newline at end of file
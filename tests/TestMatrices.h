@@ -0,0 +1,25 @@
+#pragma once
+
+#include "matrix/SparseMatrix.h"
+
+// 5-point laplacian on a NxN grid
+template<typename T>
+NS_NAMESPACE::SparseMatrix<T> laplacian(NS_NAMESPACE::Index N)
+{
+	NS_USE_NAMESPACE;
+
+	SparseMatrix<T> A(N*N, N*N);
+	for(Index i = 0; i < N; ++i)
+	{
+		for(Index j = 0; j < N; ++j)
+		{
+			const Index k = i*N + j;
+			A.set(k, k, 4);
+			if(i > 0) A.set(k, k - N, -1);
+			if(i < N-1) A.set(k, k + N, -1);
+			if(j > 0) A.set(k, k - 1, -1);
+			if(j < N-1) A.set(k, k + 1, -1);
+		}
+	}
+	return A;
+}
\ No newline at end of file
@@ -3,7 +3,9 @@
 #include "Test.h"
 #include "CG.h"
 #include "LU.h"
+#include "Preconditioner.h"
 #include "matrix/MatrixOperations.h"
+#include "matrix/MatrixConverter.h"
 #include "OutputStream.h"
 
 NS_USE_NAMESPACE;
@@ -32,6 +34,63 @@ NS_TEST("cg")
 		NS_GOT_EXCEPTION(exception);
 	}
 }
+NS_TEST("cg sliced ellpack")
+{
+	SparseMatrix<T> m = { { 4,1 },{ 1,3 } };
+	DynamicVector<T> b = { 1,2 };
+	DynamicVector<T> x0 = { 2,1 };
+	DynamicVector<T> res = { 1/11.0, 7/11.0 };
+
+	size_t iterations;
+	try
+	{
+		auto l = CG::serial::cg(SlicedEllpackMatrix<T>(m), b, x0, MAX_ITERATIONS, ITER_EPSILON, &iterations);
+		std::cout << "Iterations: " << iterations << std::endl;
+		NS_CHECK_LESS((l - res).mag(), 1e-5);
+	}
+	catch (const NSException& exception)
+	{
+		NS_GOT_EXCEPTION(exception);
+	}
+}
+NS_TEST("cg symmetric")
+{
+	SparseMatrix<T> m = { { 4,1 },{ 1,3 } };
+	DynamicVector<T> b = { 1,2 };
+	DynamicVector<T> x0 = { 2,1 };
+	DynamicVector<T> res = { 1/11.0, 7/11.0 };
+
+	size_t iterations;
+	try
+	{
+		auto l = CG::serial::cg(SymmetricSparseMatrix<T>(m), b, x0, MAX_ITERATIONS, ITER_EPSILON, &iterations);
+		std::cout << "Iterations: " << iterations << std::endl;
+		NS_CHECK_LESS((l - res).mag(), 1e-5);
+	}
+	catch (const NSException& exception)
+	{
+		NS_GOT_EXCEPTION(exception);
+	}
+}
+NS_TEST("cg delta coded")
+{
+	SparseMatrix<T> m = { { 4,1 },{ 1,3 } };
+	DynamicVector<T> b = { 1,2 };
+	DynamicVector<T> x0 = { 2,1 };
+	DynamicVector<T> res = { 1/11.0, 7/11.0 };
+
+	size_t iterations;
+	try
+	{
+		auto l = CG::serial::cg(DeltaCodedSparseMatrix<T>(m), b, x0, MAX_ITERATIONS, ITER_EPSILON, &iterations);
+		std::cout << "Iterations: " << iterations << std::endl;
+		NS_CHECK_LESS((l - res).mag(), 1e-5);
+	}
+	catch (const NSException& exception)
+	{
+		NS_GOT_EXCEPTION(exception);
+	}
+}
 NS_TEST("pcg Identity")
 {
 	DenseMatrix<T> id = {{1,0},{0,1}};
@@ -75,6 +134,214 @@ NS_TEST("pcg")
 		NS_GOT_EXCEPTION(exception);
 	}
 }
+NS_TEST("pcg Jacobi")
+{
+	SparseMatrix<T> m = { { 4,1 },{ 1,3 } };
+	DynamicVector<T> b = { 1,2 };
+	DynamicVector<T> x0 = { 2,1 };
+	DynamicVector<T> res = { 1/11.0, 7/11.0 };
+
+	size_t iterations;
+	try
+	{
+		JacobiPreconditioner<T> c(m);
+		auto l = CG::serial::pcg(m, b, c, x0, MAX_ITERATIONS, ITER_EPSILON, &iterations);
+		std::cout << "Iterations: " << iterations << std::endl;
+		NS_CHECK_LESS((l - res).mag(), 1e-5);
+	}
+	catch (const NSException& exception)
+	{
+		NS_GOT_EXCEPTION(exception);
+	}
+}
+NS_TEST("pcg float matrix")
+{
+	SparseMatrix<T> m = { { 4,1 },{ 1,3 } };
+	DynamicVector<T> b = { 1,2 };
+	DynamicVector<T> x0 = { 2,1 };
+	DynamicVector<T> res = { 1/11.0, 7/11.0 };
+
+	size_t iterations;
+	try
+	{
+		const auto mf = Convert::toPrecision<float>(m);
+		JacobiPreconditioner<float> c(mf);
+		auto l = CG::serial::pcg(mf, b, c, x0, MAX_ITERATIONS, ITER_EPSILON, &iterations);
+		std::cout << "Iterations: " << iterations << std::endl;
+		NS_CHECK_LESS((l - res).mag(), 1e-5);
+	}
+	catch (const NSException& exception)
+	{
+		NS_GOT_EXCEPTION(exception);
+	}
+}
+NS_TEST("pcg refinement")
+{
+	// Shifted 1D laplacian
+	const Index n = 200;
+	std::vector<Index> rowPtr(n + 1, 0);
+	std::vector<Index> columnPtr;
+	std::vector<T> values;
+	for (Index i = 0; i < n; ++i)
+	{
+		if (i > 0)
+		{
+			columnPtr.push_back(i - 1);
+			values.push_back(-1);
+		}
+		columnPtr.push_back(i);
+		values.push_back((T)2.01);
+		if (i + 1 < n)
+		{
+			columnPtr.push_back(i + 1);
+			values.push_back(-1);
+		}
+		rowPtr[i + 1] = columnPtr.size();
+	}
+	SparseMatrix<T> m(n, n, std::move(rowPtr), std::move(columnPtr), std::move(values));
+
+	DynamicVector<T> b;
+	DynamicVector<T> x0;
+	b.resize(n);
+	x0.resize(n);
+	for (Index i = 0; i < n; ++i)
+		b[i] = (T)((int)(i % 7) - 3);
+
+	// Below the precision of float for the double variant
+	const double eps = std::is_same<T, float>::value ? 1e-3 : 1e-10;
+
+	size_t iterations;
+	try
+	{
+		const auto mf = Convert::toPrecision<float>(m);
+		IC0Preconditioner<float> c(mf);
+		auto l = CG::serial::pcg_refinement(m, mf, b, c, x0, 32, eps, 1e-4, MAX_ITERATIONS, &iterations);
+		std::cout << "Iterations: " << iterations << std::endl;
+		NS_CHECK_LESS((b - m.mul(l)).mag(), eps);
+		NS_CHECK_LESS(iterations, 32);
+	}
+	catch (const NSException& exception)
+	{
+		NS_GOT_EXCEPTION(exception);
+	}
+}
+NS_TEST("pcg block Jacobi")
+{
+	// Two coupled unknowns per node
+	SparseMatrix<T> m = { { 4,1,1,0 },{ 1,3,0,1 },{ 1,0,4,1 },{ 0,1,1,3 } };
+	DynamicVector<T> b = { 1,2,3,4 };
+	DynamicVector<T> x0 = { 0,0,0,0 };
+
+	size_t iterations;
+	try
+	{
+		auto a = Convert::toBlockSparseMatrix<2>(m);
+		BlockJacobiPreconditioner<T,2> c(a);
+		auto l = CG::serial::pcg(a, b, c, x0, MAX_ITERATIONS, ITER_EPSILON, &iterations);
+		std::cout << "Iterations: " << iterations << std::endl;
+		NS_CHECK_LESS((m.mul(l) - b).mag(), 1e-4);
+	}
+	catch (const NSException& exception)
+	{
+		NS_GOT_EXCEPTION(exception);
+	}
+}
+NS_TEST("pcg ILU0")
+{
+	SparseMatrix<T> m = { { 4,1,0 },{ 1,3,1 },{ 0,1,2 } };
+	DynamicVector<T> b = { 1,2,3 };
+	DynamicVector<T> x0 = { 0,0,0 };
+	DynamicVector<T> res = { 2/9.0, 1/9.0, 13/9.0 };
+
+	size_t iterations;
+	try
+	{
+		ILU0Preconditioner<T> c(m);
+		auto l = CG::serial::pcg(m, b, c, x0, MAX_ITERATIONS, ITER_EPSILON, &iterations);
+		std::cout << "Iterations: " << iterations << std::endl;
+		NS_CHECK_LESS((l - res).mag(), 1e-5);
+		// Tridiagonal matrices have an exact ILU0 factorization
+		NS_CHECK_LESS(iterations, 3);
+	}
+	catch (const NSException& exception)
+	{
+		NS_GOT_EXCEPTION(exception);
+	}
+}
+NS_TEST("pcg IC0")
+{
+	SparseMatrix<T> m = { { 4,1,0 },{ 1,3,1 },{ 0,1,2 } };
+	DynamicVector<T> b = { 1,2,3 };
+	DynamicVector<T> x0 = { 0,0,0 };
+	DynamicVector<T> res = { 2/9.0, 1/9.0, 13/9.0 };
+
+	size_t iterations;
+	try
+	{
+		IC0Preconditioner<T> c(m);
+		auto l = CG::serial::pcg(m, b, c, x0, MAX_ITERATIONS, ITER_EPSILON, &iterations);
+		std::cout << "Iterations: " << iterations << std::endl;
+		NS_CHECK_LESS((l - res).mag(), 1e-5);
+		NS_CHECK_LESS(iterations, 3);
+	}
+	catch (const NSException& exception)
+	{
+		NS_GOT_EXCEPTION(exception);
+	}
+}
+NS_TEST("pcg ILUT")
+{
+	SparseMatrix<T> m = { { 4,1,0 },{ 1,3,1 },{ 0,1,2 } };
+	DynamicVector<T> b = { 1,2,3 };
+	DynamicVector<T> x0 = { 0,0,0 };
+	DynamicVector<T> res = { 2/9.0, 1/9.0, 13/9.0 };
+
+	size_t iterations;
+	try
+	{
+		SparseMatrix<T> lu;
+		LU::serial::ilut(m, lu, 1e-4, 3);
+		ILUPreconditioner<T> c(lu);
+		auto l = CG::serial::pcg(m, b, c, x0, MAX_ITERATIONS, ITER_EPSILON, &iterations);
+		std::cout << "Iterations: " << iterations << std::endl;
+		NS_CHECK_LESS((l - res).mag(), 1e-5);
+		NS_CHECK_LESS(iterations, 3);
+	}
+	catch (const NSException& exception)
+	{
+		NS_GOT_EXCEPTION(exception);
+	}
+}
+NS_TEST("pcg AINV")
+{
+	SparseMatrix<T> m = { { 4,1,0 },{ 1,3,1 },{ 0,1,2 } };
+	DynamicVector<T> b = { 1,2,3 };
+	DynamicVector<T> x0 = { 0,0,0 };
+	DynamicVector<T> res = { 2/9.0, 1/9.0, 13/9.0 };
+
+	size_t iterations;
+	try
+	{
+		AINVPreconditioner<T> c(m, 0.01, true);
+		auto l = CG::serial::pcg(m, b, c, x0, MAX_ITERATIONS, ITER_EPSILON, &iterations);
+		std::cout << "Iterations: " << iterations << std::endl;
+		NS_CHECK_LESS((l - res).mag(), 1e-5);
+
+		// Both variants give the same factors for a symmetric matrix
+		AINVPreconditioner<T> g(m, 0.01);
+		DynamicVector<T> z1, z2;
+		c.apply(b, z1);
+		g.apply(b, z2);
+		NS_CHECK_NEARLY_EQ_V(z1, z2);
+		g.apply(res, z2);
+		g.apply(b, z2);
+		NS_CHECK_NEARLY_EQ_V(z1, z2);
+	}
+	catch (const NSException& exception)
+	{
+		NS_GOT_EXCEPTION(exception);
+	}
+}
 NS_END_TESTCASE()
 
 NST_BEGIN_MAIN
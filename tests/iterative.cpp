@@ -23,6 +23,18 @@ NS_TEST("jacobi")
 	std::cout << "Iterations: " << iterations << std::endl;
 	NS_CHECK_EQ(l, res);
 }
+NS_TEST("jacobi sliced ellpack")
+{
+	SparseMatrix<T> m = { { 4,1,2 },{ 1,3,2 },{ 1,1,2 } };
+	DynamicVector<T> b = { 12, 13, 9 };
+	DynamicVector<T> x0(3);
+	DynamicVector<T> res = { 1, 2, 3 };
+
+	size_t iterations;
+	auto l = Iterative::serial::jacobi(SlicedEllpackMatrix<T,2>(m), b, x0, MAX_ITERATIONS, ITER_EPSILON, &iterations);
+	std::cout << "Iterations: " << iterations << std::endl;
+	NS_CHECK_LESS(std::abs((l - res).mag()), 1e-4);
+}
 NS_TEST("gauss-seidel")
 {
 	DenseMatrix<T> m = { { 4,1,2 },{ 1,3,2 },{ 1,1,2 } };
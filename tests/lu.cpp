@@ -1,6 +1,7 @@
 #define NS_ALLOW_CHECKS
 
 #include "Test.h"
+#include "TestMatrices.h"
 #include "LU.h"
 #include "OutputStream.h"
 
@@ -150,6 +151,630 @@ NS_TEST("ainv_lu")
 		NS_GOT_EXCEPTION(exception);
 	}
 }
+NS_TEST("ic0")
+{
+	// Tridiagonal: No fill-in, IC(0) is the exact cholesky factorization
+	SparseMatrix<T> A = { 
+		{4,-1,0,0},
+		{-1,4,-1,0},
+		{0,-1,4,-1},
+		{0,0,-1,4}
+	};
+
+	try
+	{
+		SparseMatrix<T> rL(4,4), L(4,4);
+		LU::serial::ic0(A, rL);
+		LU::serial::cholesky(A, L);
+
+		NS_CHECK_EQ(rL.filled_count(), 7);
+		for(Index i = 0; i < 4; ++i)
+		{
+			for(Index j = 0; j < 4; ++j)
+				NS_CHECK_NEARLY_EQ(rL.at(i,j), L.at(i,j));
+		}
+	}
+	catch (const NSException& exception)
+	{
+		NS_GOT_EXCEPTION(exception);
+	}
+}
+NS_TEST("ic0 pattern")
+{
+	constexpr Index N = 3;
+	const SparseMatrix<T> A = laplacian<T>(N);
+
+	try
+	{
+		SparseMatrix<T> L;
+		LU::serial::ic0(A, L);
+		const SparseMatrix<T> LLt = L.mul(L.adjugate());
+
+		// (L L^*)_ij equals a_ij on the pattern of A
+		for(auto it = A.begin(); it != A.end(); ++it)
+			NS_CHECK_NEARLY_EQ(LLt.at(it.row(), it.column()), *it);
+
+		DynamicVector<T> b(N*N);
+		for(Index i = 0; i < N*N; ++i)
+			b[i] = (T)(i+1);
+
+		DynamicVector<T> x = b;
+		LU::serial::solve_ic(L, x);
+		const DynamicVector<T> r = LLt.mul(x);
+		for(Index i = 0; i < N*N; ++i)
+			NS_CHECK_LESS(std::abs(r[i] - b[i]), 1e-4);
+	}
+	catch (const NSException& exception)
+	{
+		NS_GOT_EXCEPTION(exception);
+	}
+}
+NS_TEST("ic0 not positive definite")
+{
+	SparseMatrix<T> A = { 
+		{1,2},
+		{2,1}
+	};
+
+	try
+	{
+		SparseMatrix<T> L;
+		LU::serial::ic0(A, L);
+		NS_CHECK_TRUE(false);
+	}
+	catch (const NotPositiveDefiniteException&)
+	{
+		NS_CHECK_TRUE(true);
+	}
+}
+NS_TEST("solve_lower/upper")
+{
+	SparseMatrix<T> A = { 
+		{2,1,0},
+		{1,3,1},
+		{4,1,5}
+	};
+	DynamicVector<T> b = {1,2,3};
+
+	try
+	{
+		// Lower triangle of A including the diagonal
+		DynamicVector<T> x = b;
+		LU::serial::solve_lower(A, x);
+		NS_CHECK_NEARLY_EQ(x[0], (T)0.5);
+		NS_CHECK_NEARLY_EQ(x[1], (T)0.5);
+		NS_CHECK_NEARLY_EQ(x[2], (T)0.1);
+
+		// Upper triangle of A including the diagonal
+		x = b;
+		LU::serial::solve_upper(A, x);
+		NS_CHECK_NEARLY_EQ(x[2], (T)0.6);
+		NS_CHECK_NEARLY_EQ(x[1], (T)(1.4/3));
+		NS_CHECK_NEARLY_EQ(x[0], (T)((1-1.4/3)/2));
+
+		// Strict lower triangle with unit diagonal
+		x = b;
+		LU::serial::solve_lower(A, x, true);
+		NS_CHECK_NEARLY_EQ(x[1], (T)1);
+		NS_CHECK_NEARLY_EQ(x[2], (T)-2);
+	}
+	catch (const NSException& exception)
+	{
+		NS_GOT_EXCEPTION(exception);
+	}
+}
+NS_TEST("elimination_tree")
+{
+	SparseMatrix<T> A = { 
+		{4,0,0,1},
+		{0,4,1,0},
+		{0,1,4,1},
+		{1,0,1,4}
+	};
+
+	const auto parent = Symbolic::elimination_tree(A);
+	NS_CHECK_EQ(parent[0], 3);
+	NS_CHECK_EQ(parent[1], 2);
+	NS_CHECK_EQ(parent[2], 3);
+	NS_CHECK_EQ(parent[3], 4);
+
+	const auto counts = Symbolic::column_counts(A, parent);
+	NS_CHECK_EQ(counts[0], 2);
+	NS_CHECK_EQ(counts[1], 2);
+	NS_CHECK_EQ(counts[2], 2);
+	NS_CHECK_EQ(counts[3], 1);
+}
+NS_TEST("SparseCholesky")
+{
+	SparseMatrix<T> A = { {4,12,-16},{12,37,-43},{-16,-43,98} };
+	SparseMatrix<T> L = { {2, 0, 0},{6,1,0},{-8,5,3} };
+	DynamicVector<T> b = { 1,2,3 };
+
+	try
+	{
+		SparseCholesky<T> chol(A, SO_Natural);
+		NS_CHECK_EQ(chol.factor(), L);
+		NS_CHECK_EQ(chol.filled_count(), 6);
+
+		const auto x = chol.solve(b);
+		NS_CHECK_LESS((A.mul(x) - b).mag(), 1e-3);
+	}
+	catch (const NSException& exception)
+	{
+		NS_GOT_EXCEPTION(exception);
+	}
+}
+NS_TEST("SparseCholesky grid")
+{
+	constexpr Index N = 4;
+	const SparseMatrix<T> A = laplacian<T>(N);
+
+	DynamicVector<T> ones(N*N);
+	for(Index i = 0; i < N*N; ++i)
+		ones[i] = 1;
+	const auto b = A.mul(ones);
+
+	try
+	{
+		SparseCholesky<T> natural(A, SO_Natural);
+		SparseCholesky<T> rcm(A, SO_ReverseCuthillMcKee);
+		NS_CHECK_LESS((natural.solve(b) - ones).mag(), 1e-4);
+		NS_CHECK_LESS((rcm.solve(b) - ones).mag(), 1e-4);
+
+		// Factorize again with the same pattern
+		for(Index i = 0; i < N*N; ++i)
+			A.set(i, i, 8);
+		rcm.factorize(A);
+		const auto b2 = A.mul(ones);
+		NS_CHECK_LESS((rcm.solve(b2) - ones).mag(), 1e-4);
+	}
+	catch (const NSException& exception)
+	{
+		NS_GOT_EXCEPTION(exception);
+	}
+
+	// Same size and amount of entries, but another pattern
+	SparseMatrix<T> B = A;
+	B.set(0, N*N - 1, -1);
+	B.set(N*N - 1, 0, -1);
+	B.set(0, 1, 0);
+	B.set(1, 0, 0);
+	try
+	{
+		SparseCholesky<T> chol(A, SO_ReverseCuthillMcKee);
+		chol.factorize(B);
+		NS_CHECK_TRUE(false);
+	}
+	catch (const PatternMismatchException&)
+	{
+		NS_CHECK_TRUE(true);
+	}
+}
+NS_TEST("SparseCholesky orderings")
+{
+	constexpr Index N = 24;
+	const SparseMatrix<T> A = laplacian<T>(N);
+
+	DynamicVector<T> ones(N*N);
+	for(Index i = 0; i < N*N; ++i)
+		ones[i] = 1;
+	const auto b = A.mul(ones);
+
+	try
+	{
+		SparseCholesky<T> rcm(A, SO_ReverseCuthillMcKee);
+		SparseCholesky<T> amd(A, SO_ApproximateMinimumDegree);
+		SparseCholesky<T> nd(A, SO_NestedDissection);
+		std::cout << "Entries: RCM " << rcm.filled_count()
+			<< " AMD " << amd.filled_count()
+			<< " ND " << nd.filled_count() << std::endl;
+
+		NS_CHECK_LESS(amd.filled_count(), rcm.filled_count());
+		NS_CHECK_LESS(nd.filled_count(), rcm.filled_count());
+		NS_CHECK_LESS((amd.solve(b) - ones).mag(), 1e-3);
+		NS_CHECK_LESS((nd.solve(b) - ones).mag(), 1e-3);
+	}
+	catch (const NSException& exception)
+	{
+		NS_GOT_EXCEPTION(exception);
+	}
+}
+NS_TEST("SparseCholesky not positive definite")
+{
+	SparseMatrix<T> A = { {1,2},{2,1} };
+
+	try
+	{
+		SparseCholesky<T> chol(A);
+		NS_CHECK_TRUE(false);
+	}
+	catch (const NotPositiveDefiniteException&)
+	{
+	}
+}
+NS_TEST("SparseLU")
+{
+	// Non symmetric convection-diffusion like matrix on a 4x4 grid
+	constexpr Index N = 4;
+	SparseMatrix<T> A(N*N, N*N);
+	for(Index i = 0; i < N; ++i)
+	{
+		for(Index j = 0; j < N; ++j)
+		{
+			const Index k = i*N + j;
+			A.set(k, k, 1);
+			if(i > 0) A.set(k, k - N, -3);
+			if(i < N-1) A.set(k, k + N, 1);
+			if(j > 0) A.set(k, k - 1, -2);
+			if(j < N-1) A.set(k, k + 1, 2);
+		}
+	}
+
+	DynamicVector<T> ones(N*N);
+	for(Index i = 0; i < N*N; ++i)
+		ones[i] = 1;
+	const auto b = A.mul(ones);
+
+	try
+	{
+		SparseLU<T> natural(A, SO_Natural);
+		SparseLU<T> rcm(A, SO_ReverseCuthillMcKee);
+		NS_CHECK_LESS((natural.solve(b) - ones).mag(), 1e-3);
+		NS_CHECK_LESS((rcm.solve(b) - ones).mag(), 1e-3);
+
+		// L U = P A Q
+		const auto L = rcm.lower();
+		const auto U = rcm.upper();
+		const auto& p = rcm.row_permutation();
+		const auto& q = rcm.column_permutation();
+		const auto LU = L.mul(U);
+		typename get_complex_internal<T>::type err = 0;
+		for(Index i = 0; i < N*N; ++i)
+			for(Index j = 0; j < N*N; ++j)
+				err += std::abs(LU.at(i,j) - A.at(p[i], q[j]));
+		NS_CHECK_LESS(err, 1e-3);
+	}
+	catch (const NSException& exception)
+	{
+		NS_GOT_EXCEPTION(exception);
+	}
+}
+NS_TEST("level_schedule")
+{
+	SparseMatrix<T> A = { 
+		{1,0,0,1},
+		{1,1,0,0},
+		{0,0,1,1},
+		{0,1,1,1}
+	};
+
+	const auto lower = LU::parallel::level_schedule_lower(A);
+	NS_CHECK_EQ(lower.levels(), 3);
+	NS_CHECK_EQ(lower.LevelPtr[1], 2);
+	NS_CHECK_EQ(lower.Rows[0], 0);
+	NS_CHECK_EQ(lower.Rows[1], 2);
+	NS_CHECK_EQ(lower.Rows[2], 1);
+	NS_CHECK_EQ(lower.Rows[3], 3);
+
+	const auto upper = LU::parallel::level_schedule_upper(A);
+	NS_CHECK_EQ(upper.levels(), 2);
+	NS_CHECK_EQ(upper.LevelPtr[1], 2);
+	NS_CHECK_EQ(upper.Rows[2], 0);
+	NS_CHECK_EQ(upper.Rows[3], 2);
+}
+NS_TEST("parallel solve_lower/upper")
+{
+	// Enough entries to use multiple threads
+	constexpr Index N = 82;
+	const SparseMatrix<T> A = laplacian<T>(N);
+
+	DynamicVector<T> b(N*N);
+	for(Index i = 0; i < N*N; ++i)
+		b[i] = (T)(i % 7);
+
+	try
+	{
+		const auto lower = LU::parallel::level_schedule_lower(A);
+		const auto upper = LU::parallel::level_schedule_upper(A);
+		NS_CHECK_EQ(lower.levels(), 2*N-1);
+		NS_CHECK_EQ(upper.levels(), 2*N-1);
+		NS_CHECK_TRUE(A.filled_count() >= Parallel::SerialThreshold);
+
+		DynamicVector<T> x1 = b;
+		DynamicVector<T> x2 = b;
+		LU::serial::solve_lower(A, x1);
+		LU::parallel::solve_lower(A, lower, x2, false, 4);
+		NS_CHECK_NEARLY_EQ_V(x1, x2);
+
+		x1 = b;
+		x2 = b;
+		LU::serial::solve_upper(A, x1);
+		LU::parallel::solve_upper(A, upper, x2, 4);
+		NS_CHECK_NEARLY_EQ_V(x1, x2);
+
+		// Scaled, as the -1 entries with a unit diagonal let the solution grow exponentially
+		const SparseMatrix<T> S = A*(T)0.25;
+		x1 = b;
+		x2 = b;
+		LU::serial::solve_lower(S, x1, true);
+		LU::parallel::solve_lower(S, lower, x2, true, 4);
+		NS_CHECK_NEARLY_EQ_V(x1, x2);
+
+		x1 = b;
+		x2 = b;
+		LU::serial::solve_lower(A, x1);
+		LU::serial::solve_upper(A, x1);
+		LU::parallel::solve_lower_upper(A, lower, A, upper, x2, false, 4);
+		NS_CHECK_NEARLY_EQ_V(x1, x2);
+	}
+	catch (const NSException& exception)
+	{
+		NS_GOT_EXCEPTION(exception);
+	}
+}
+NS_TEST("iluk")
+{
+	SparseMatrix<T> A = { 
+		{1,-1,-1,-1},
+		{-1,2,0,0},
+		{-1,0,3,1},
+		{-1,0,1,4}
+	};
+
+	SparseMatrix<T> LU0 = { 
+		{1,-1,-1,-1},
+		{-1,1,0,0},
+		{-1,0,2,0},
+		{-1,0,0,3}
+	};
+
+	try
+	{
+		// Level 0 keeps the pattern of A
+		SparseMatrix<T> rLU;
+		LU::serial::iluk(A, rLU, 0);
+		NS_CHECK_EQ(rLU.filled_count(), A.filled_count());
+		for(Index i = 0; i < 4; ++i)
+			for(Index j = 0; j < 4; ++j)
+				NS_CHECK_NEARLY_EQ(rLU.at(i,j), LU0.at(i,j));
+
+		// Level 1 adds the fill between rows 1, 2 and 3
+		LU::serial::iluk(A, rLU, 1);
+		NS_CHECK_EQ(rLU.filled_count(), 16);
+	}
+	catch (const NSException& exception)
+	{
+		NS_GOT_EXCEPTION(exception);
+	}
+}
+NS_TEST("iluk/ilut grid")
+{
+	constexpr Index N = 6;
+	const SparseMatrix<T> A = laplacian<T>(N);
+
+	DynamicVector<T> ones(N*N);
+	for(Index i = 0; i < N*N; ++i)
+		ones[i] = 1;
+	const auto b = A.mul(ones);
+
+	try
+	{
+		SparseMatrix<T> LU0, LU1, LUFull;
+		LU::serial::iluk(A, LU0, 0);
+		LU::serial::iluk(A, LU1, 1);
+		LU::serial::iluk(A, LUFull, N*N);
+		NS_CHECK_EQ(LU0.filled_count(), A.filled_count());
+		NS_CHECK_LESS(LU0.filled_count(), LU1.filled_count());
+		NS_CHECK_LESS(LU1.filled_count(), LUFull.filled_count());
+
+		// Without dropping the factorization is exact
+		DynamicVector<T> x = b;
+		LU::serial::solve_lower(LUFull, x, true);
+		LU::serial::solve_upper(LUFull, x);
+		NS_CHECK_LESS((x - ones).mag(), 1e-4);
+
+		SparseMatrix<T> LUT;
+		LU::serial::ilut(A, LUT, 0, N*N);
+		NS_CHECK_EQ(LUT.filled_count(), LUFull.filled_count());
+		x = b;
+		LU::serial::solve_lower(LUT, x, true);
+		LU::serial::solve_upper(LUT, x);
+		NS_CHECK_LESS((x - ones).mag(), 1e-4);
+
+		// Maximal fill per row
+		LU::serial::ilut(A, LUT, 1e-3, 2);
+		for(Index i = 0; i < N*N; ++i)
+			NS_CHECK_LESS_EQ(LUT.row_filled_count(i), 5);
+	}
+	catch (const NSException& exception)
+	{
+		NS_GOT_EXCEPTION(exception);
+	}
+}
+NS_TEST("ainv")
+{
+	// Non symmetric convection-diffusion like matrix on a 4x4 grid
+	constexpr Index N = 4;
+	SparseMatrix<T> A(N*N, N*N);
+	for(Index i = 0; i < N; ++i)
+	{
+		for(Index j = 0; j < N; ++j)
+		{
+			const Index k = i*N + j;
+			A.set(k, k, 8);
+			if(i > 0) A.set(k, k - N, -3);
+			if(i < N-1) A.set(k, k + N, 1);
+			if(j > 0) A.set(k, k - 1, -2);
+			if(j < N-1) A.set(k, k + 1, 2);
+		}
+	}
+	const SparseMatrix<T> S = laplacian<T>(N);
+
+	DynamicVector<T> ones(N*N);
+	for(Index i = 0; i < N*N; ++i)
+		ones[i] = 1;
+
+	try
+	{
+		// Without dropping the inverse is exact
+		SparseMatrix<T> Z, W;
+		DynamicVector<T> D;
+		LU::serial::ainv(A, Z, W, D, 0);
+		DynamicVector<T> x = W.mul_left(A.mul(ones));
+		for(Index i = 0; i < N*N; ++i)
+			x[i] /= D[i];
+		x = Z.mul(x);
+		NS_CHECK_LESS((x - ones).mag(), 1e-4);
+
+		LU::serial::ainv_hermitian(S, Z, D, 0);
+		x = Z.mul_left(S.mul(ones));
+		for(Index i = 0; i < N*N; ++i)
+			x[i] /= D[i];
+		x = Z.mul(x);
+		NS_CHECK_LESS((x - ones).mag(), 1e-4);
+		NS_CHECK_EQ(Z.at(0,1), (T)0.25);
+		NS_CHECK_EQ(Z.at(1,0), (T)0);
+
+		// Dropping reduces the fill
+		SparseMatrix<T> Zd;
+		LU::serial::ainv_hermitian(S, Zd, D, 0.1);
+		NS_CHECK_LESS(Zd.filled_count(), Z.filled_count());
+	}
+	catch (const NSException& exception)
+	{
+		NS_GOT_EXCEPTION(exception);
+	}
+}
+NS_END_TESTCASE()
+
+template<typename T>
+double max_abs(const DenseMatrix<T>& m)
+{
+	double r = 0;
+	for(Index i = 0; i < m.size(); ++i)
+		r = std::max<double>(r, std::abs(m.linear_at(i)));
+	return r;
+}
+
+template<typename T>
+NS_BEGIN_TESTCASE_T1(LU_DenseOnly)
+NS_TEST("blocked doolittle")
+{
+	// Spans multiple panels
+	constexpr Index N = 150;
+	DenseMatrix<T> A(N, N);
+	uint32 seed = 42;
+	for(Index i = 0; i < A.size(); ++i)
+	{
+		seed = seed*1664525u + 1013904223u;
+		A.linear_set(i, (T)((int)(seed >> 25) - 64));
+	}
+
+	try
+	{
+		DenseMatrix<T> L(N,N), U(N,N), P(N,N);
+		size_t pivotCount;
+		LU::serial::doolittle(A, L, U, P, &pivotCount);
+
+		// Same pivots as the unblocked variant
+		DenseMatrix<T> rL(N,N), rU(N,N), rP(N,N);
+		size_t rPivotCount;
+		LU::serial::doolittle<T, dynamic_container2d_t<T> >(A, rL, rU, rP, &rPivotCount);
+
+		NS_CHECK_EQ(P, rP);
+		NS_CHECK_EQ(pivotCount, rPivotCount);
+		NS_CHECK_LESS(max_abs<T>(L.mul(U) - P.mul(A))/max_abs(A), 1e-4);
+
+		DenseMatrix<T> pL(N,N), pU(N,N), pP(N,N);
+		LU::parallel::doolittle(A, pL, pU, pP, nullptr, 3);
+		NS_CHECK_EQ(pP, P);
+		NS_CHECK_LESS(max_abs<T>(pL.mul(pU) - pP.mul(A))/max_abs(A), 1e-4);
+	}
+	catch (const NSException& exception)
+	{
+		NS_GOT_EXCEPTION(exception);
+	}
+}
+NS_TEST("blocked doolittle singular")
+{
+	DenseMatrix<T> A = { {1,2,3},{2,4,6},{4,8,12} };
+
+	try
+	{
+		DenseMatrix<T> L(3,3), U(3,3), P(3,3);
+		LU::serial::doolittle(A, L, U, P);
+		NS_CHECK_TRUE(false);
+	}
+	catch (const SingularException&)
+	{
+		NS_CHECK_TRUE(true);
+	}
+}
+NS_TEST("blocked cholesky")
+{
+	// Hermitian positive definite A = B B^* + N I
+	constexpr Index N = 150;
+	DenseMatrix<T> B(N, N);
+	for(Index i = 0; i < B.size(); ++i)
+		B.linear_set(i, (T)(((int)(i*13 % 17) - 8)/8.0));
+
+	DenseMatrix<T> A = B.mul(B.adjugate());
+	for(Index i = 0; i < N; ++i)
+		A.set(i, i, A.at(i, i) + (T)N);
+
+	try
+	{
+		DenseMatrix<T> L(N,N);
+		LU::serial::cholesky(A, L);
+		NS_CHECK_LESS(max_abs<T>(L.mul(L.adjugate()) - A)/max_abs(A), 1e-4);
+		for(Index i = 0; i < N; ++i)
+		{
+			for(Index j = i+1; j < N; ++j)
+				NS_CHECK_EQ(L.at(i,j), (T)0);
+		}
+
+		DenseMatrix<T> pL(N,N);
+		LU::parallel::cholesky(A, pL, 3);
+		NS_CHECK_LESS(max_abs<T>(pL - L)/max_abs(L), 1e-5);
+
+		try
+		{
+			A.set(N-1, N-1, (T)-1);
+			LU::serial::cholesky(A, L);
+			NS_CHECK_TRUE(false);
+		}
+		catch (const NotPositiveDefiniteException&)
+		{
+			NS_CHECK_TRUE(true);
+		}
+	}
+	catch (const NSException& exception)
+	{
+		NS_GOT_EXCEPTION(exception);
+	}
+}
+NS_END_TESTCASE()
+
+template<template<typename> class M>
+NS_BEGIN_TESTCASE_T1(LU_Complex)
+NS_TEST("cholesky hermitian")
+{
+	typedef std::complex<double> C;
+	M<C> m = { {4,C(2,2)},{C(2,-2),6} };
+	M<C> r = { {2,0},{C(1,-1),2} };
+
+	try
+	{
+		M<C> l(2,2);
+		LU::serial::cholesky(m,l);
+
+		NS_CHECK_EQ(l, r);
+	}
+	catch (const NSException& exception)
+	{
+		NS_GOT_EXCEPTION(exception);
+	}
+}
 NS_END_TESTCASE()
 
 NST_BEGIN_MAIN
@@ -162,4 +787,11 @@ NST_TESTCASE_T2(LU, SparseMatrix, std::complex<double>);
 
 NST_TESTCASE_T1(LU_SparseOnly, float);
 NST_TESTCASE_T1(LU_SparseOnly, double);
+
+NST_TESTCASE_T1(LU_DenseOnly, float);
+NST_TESTCASE_T1(LU_DenseOnly, double);
+NST_TESTCASE_T1(LU_DenseOnly, std::complex<double>);
+
+NST_TESTCASE_T1(LU_Complex, DenseMatrix);
+NST_TESTCASE_T1(LU_Complex, SparseMatrix);
 NST_END_MAIN
\ No newline at end of file
@@ -1,14 +1,49 @@
 #include "Test.h"
+#include "TestMatrices.h"
 #include "matrix/Matrix.h"
 #include "OutputStream.h"
 
 #include "matrix/MatrixConstructor.h"
+#include "matrix/MatrixConverter.h"
 #include "matrix/MatrixCheck.h"
 #include "matrix/MatrixOperations.h"
 #include "matrix/MatrixOrder.h"
 
 NS_USE_NAMESPACE;
 
+// Irregular rows with large gaps and enough entries to use multiple threads
+template<typename T>
+SparseMatrix<T> irregularMatrix(Index n)
+{
+	std::vector<Index> rowPtr(n + 1, 0);
+	std::vector<Index> columnPtr;
+	std::vector<T> values;
+	uint32 seed = 5;
+	for (Index i = 0; i < n; ++i)
+	{
+		seed = seed*1664525u + 1013904223u;
+		const Index stride = 1 + (seed >> 24) % 200;
+		for (Index j = i % stride; j < n; j += stride)
+		{
+			columnPtr.push_back(j);
+			values.push_back((T)((int)(j % 13) - 6));
+		}
+		rowPtr[i + 1] = columnPtr.size();
+	}
+	return SparseMatrix<T>(n, n, std::move(rowPtr), std::move(columnPtr), std::move(values));
+}
+
+// Small integers, so every storage format computes exactly the same products
+template<typename T>
+DynamicVector<T> integerVector(Index n)
+{
+	DynamicVector<T> v;
+	v.resize(n);
+	for (Index i = 0; i < n; ++i)
+		v[i] = (T)((int)(i*7 % 11) - 5);
+	return v;
+}
+
 template<template<typename> class M, typename T>
 NS_BEGIN_TESTCASE_T2(Matrix)
 NS_TEST("default")
@@ -340,6 +375,600 @@ NS_TEST("CutHill-McKee")
 	rB = permutate(rB,ret);
 	NS_CHECK_EQ(rB,A);
 }
+NS_TEST("CutHill-McKee grid")
+{
+	// 5-point laplacian with scrambled numbering
+	constexpr Index N = 16;
+	DynamicVector<Index> scramble(N*N);
+	for(Index k = 0; k < N*N; ++k)
+		scramble[k] = (k*7) % (N*N);
+	const SparseMatrix<T> A = permutate(laplacian<T>(N), scramble);
+
+	const DynamicVector<Index> ret = r_cuthill_mckee(A);
+	NS_CHECK_EQ(ret.size(), N*N);
+
+	std::vector<bool> found(N*N, false);
+	for(Index i = 0; i < N*N; ++i)
+	{
+		NS_CHECK_TRUE(!found[ret[i]]);
+		found[ret[i]] = true;
+	}
+
+	const SparseMatrix<T> B = permutate(A, ret);
+	Index bandwidth = 0;
+	for(auto it = B.cbegin(); it != B.cend(); ++it)
+		bandwidth = std::max<Index>(bandwidth, it.row() > it.column() ? it.row() - it.column() : it.column() - it.row());
+	NS_CHECK_LESS_EQ(bandwidth, N + 1);
+}
+NS_TEST("permutate")
+{
+	// Non symmetric 5-point laplacian with a dense last row and column
+	constexpr Index N = 80;
+	SparseMatrix<T> A = laplacian<T>(N);
+	for(Index k = 0; k < N*N; ++k)
+	{
+		if(k % N != N-1)
+			A.set(k, k + 1, -(T)1 - (T)k);
+	}
+	for(Index k = 0; k < N*N - 1; k += 7)
+	{
+		A.set(N*N - 1, k, 1);
+		A.set(k, N*N - 1, 1);
+	}
+
+	DynamicVector<Index> perm(N*N);
+	for(Index k = 0; k < N*N; ++k)
+		perm[k] = (k*13) % (N*N);
+
+	const SparseMatrix<T> P = permutation_matrix<T>(perm);
+	const SparseMatrix<T> ref = P.mul(A.mul(P.transpose()));
+
+	NS_CHECK_EQ(permutate(A, perm), ref);
+	NS_CHECK_EQ(permutate(A, perm, 1), ref);
+	NS_CHECK_EQ(permutate(permutate(A, perm), inverse_permutation(perm)), A);
+}
+NS_TEST("apply_dirichlet")
+{
+	SparseMatrix<T> A = { { 4,-1,0,-1 },{ -1,4,-1,0 },{ 0,-1,4,-1 },{ -1,0,-1,4 } };
+	DynamicVector<T> b = { 1,2,3,4 };
+
+	SparseMatrix<T> resA = { { 2,0,0,0 },{ 0,4,-1,0 },{ 0,-1,4,0 },{ 0,0,0,2 } };
+	DynamicVector<T> resB = { 2*5, 2+5, 3+1, 2*1 };
+
+	try
+	{
+		const size_t filled = A.filled_count();
+		Operations::apply_dirichlet(A, b, { 0, 3 }, { (T)5, (T)1 }, (T)2);
+
+		// Pattern stays the same
+		NS_CHECK_EQ(A.filled_count(), filled);
+		for(Index i = 0; i < 4; ++i)
+		{
+			for(Index j = 0; j < 4; ++j)
+				NS_CHECK_EQ(A.at(i,j), resA.at(i,j));
+		}
+		NS_CHECK_EQ(b, resB);
+	}
+	catch (const NSException& exception)
+	{
+		NS_GOT_EXCEPTION(exception);
+	}
+}
+NS_TEST("approximate minimum degree")
+{
+	// Arrow matrix: Eliminating the dense node first fills everything
+	SparseMatrix<T> A({
+		{1,1,1,1,1},
+		{1,1,0,0,0},
+		{1,0,1,0,0},
+		{1,0,0,1,0},
+		{1,0,0,0,1}
+	});
+
+	const DynamicVector<Index> ret = approximate_minimum_degree(A);
+	NS_CHECK_EQ(ret.size(), 5);
+	NS_CHECK_TRUE(ret[3] == 0 || ret[4] == 0);
+
+	std::vector<bool> found(5, false);
+	for(Index i = 0; i < 5; ++i)
+	{
+		NS_CHECK_TRUE(!found[ret[i]]);
+		found[ret[i]] = true;
+	}
+}
+NS_TEST("nested dissection")
+{
+	// Path graph with 15 nodes: The first separator splits it in the middle
+	constexpr Index N = 15;
+	SparseMatrix<T> A(N, N);
+	for(Index i = 0; i < N; ++i)
+	{
+		A.set(i, i, 2);
+		if(i > 0) A.set(i, i - 1, -1);
+		if(i < N-1) A.set(i, i + 1, -1);
+	}
+
+	const DynamicVector<Index> ret = nested_dissection(A, 3);
+	NS_CHECK_EQ(ret.size(), N);
+
+	std::vector<bool> found(N, false);
+	for(Index i = 0; i < N; ++i)
+	{
+		NS_CHECK_TRUE(!found[ret[i]]);
+		found[ret[i]] = true;
+	}
+
+	NS_CHECK_LESS(5, ret[N-1]);
+	NS_CHECK_LESS(ret[N-1], 9);
+}
+NS_TEST("CutHill-McKee empty rows")
+{
+	SparseMatrix<T> A({
+		{1,0,1,0},
+		{0,0,0,0},
+		{1,0,1,0},
+		{0,0,0,1}
+	});
+
+	DynamicVector<Index> ret = r_cuthill_mckee(A);
+	DynamicVector<Index> res = {2,0,3,1};
+	NS_CHECK_EQ(ret, res);
+}
+NS_TEST("index type")
+{
+	typedef BasicSparseMatrix<T,uint64> Wide;
+	SparseMatrix<T> m = { { 1,0,2,0 },{ 0,3,0,0 },{ 4,0,5,6 },{ 0,7,0,8 } };
+	DynamicVector<T> v = { 1,2,3,4 };
+
+	try
+	{
+		Wide w(4, 4);
+		for (auto it = m.begin(); it != m.end(); ++it)
+			w.set(it.row(), it.column(), *it);
+
+		NS_CHECK_EQ(sizeof(typename SparseMatrix<T>::index_type), 4);
+		NS_CHECK_EQ(w.filled_count(), m.filled_count());
+		NS_CHECK_EQ(w.mul(v), m.mul(v));
+
+		const Wide t = w.mul(w).transpose();
+		const Wide u = Construct::triu(w);
+		const SparseMatrix<T> mt = m.mul(m).transpose();
+		const SparseMatrix<T> mu = Construct::triu(m);
+		for (Index i = 0; i < m.rows(); ++i)
+		{
+			for (Index j = 0; j < m.columns(); ++j)
+			{
+				NS_CHECK_EQ(t.at(i, j), mt.at(i, j));
+				NS_CHECK_EQ(u.at(i, j), mu.at(i, j));
+			}
+		}
+	}
+	catch (const NSException& exception)
+	{
+		NS_GOT_EXCEPTION(exception);
+	}
+}
+NS_TEST("index overflow")
+{
+	typedef BasicSparseMatrix<T,uint8> Small;
+	try
+	{
+		Small s(300, 2);
+		NS_CHECK_TRUE(false);
+	}
+	catch (const IndexOverflowException&)
+	{
+		NS_CHECK_TRUE(true);
+	}
+
+	// 255 entries are the most an uint8 row offset can count
+	Small s(16, 16);
+	Index count = 0;
+	try
+	{
+		for (Index i = 0; i < 16; ++i)
+		{
+			for (Index j = 0; j < 16; ++j)
+			{
+				s.set(i, j, (T)1);
+				++count;
+			}
+		}
+		NS_CHECK_TRUE(false);
+	}
+	catch (const IndexOverflowException&)
+	{
+		NS_CHECK_EQ(count, 255);
+		NS_CHECK_EQ(s.filled_count(), 255);
+	}
+
+	// Row offsets narrowed by the caller
+	NS_CHECK_EQ(Small::to_index(255), 255);
+	try
+	{
+		Small::to_index(256);
+		NS_CHECK_TRUE(false);
+	}
+	catch (const IndexOverflowException&)
+	{
+		NS_CHECK_TRUE(true);
+	}
+
+	try
+	{
+		std::vector<uint8> rowPtr = { 0, (uint8)300 };
+		std::vector<uint8> columnPtr(300, 0);
+		Small c(1, 1, std::move(rowPtr), std::move(columnPtr), std::vector<T>(300, (T)1));
+		NS_CHECK_TRUE(false);
+	}
+	catch (const IndexOverflowException&)
+	{
+		NS_CHECK_TRUE(true);
+	}
+}
+NS_END_TESTCASE()
+
+template<typename T>
+NS_BEGIN_TESTCASE_T1(DenseMatrixOnly)
+NS_TEST("Mul blocked")
+{
+	// Sizes not divisible by the block sizes and a depth spanning multiple panels
+	const Index sizes[3][3] = { {67, 131, 45}, {150, 300, 70}, {1, 513, 9} };
+	for(const auto& size : sizes)
+	{
+		DenseMatrix<T> A(size[0], size[1]);
+		DenseMatrix<T> B(size[1], size[2]);
+		for(Index i = 0; i < A.size(); ++i)
+			A.linear_set(i, (T)((int)(i*7 % 13) - 6));
+		for(Index i = 0; i < B.size(); ++i)
+			B.linear_set(i, (T)((int)(i*5 % 11) - 5));
+
+		DenseMatrix<T> ref(size[0], size[2]);
+		for(Index i = 0; i < size[0]; ++i)
+		{
+			for(Index j = 0; j < size[2]; ++j)
+			{
+				T v = 0;
+				for(Index k = 0; k < size[1]; ++k)
+					v += A.at(i, k)*B.at(k, j);
+				ref.set(i, j, v);
+			}
+		}
+
+		NS_CHECK_EQ(A.mul(B, 1), ref);
+		NS_CHECK_EQ(A.mul(B, 3), ref);
+	}
+}
+NS_TEST("gemm")
+{
+	// C = 2*A*B - C on a sub block
+	DenseMatrix<T> A = { { 1, 2 },{ 3, 4 } };
+	DenseMatrix<T> B = { { 1, 0 },{ 0, 1 } };
+	DenseMatrix<T> C = { { 1, 1, 1 },{ 1, 1, 1 } };
+	DenseMatrix<T> res = { { 1, 1, 3 },{ 1, 5, 7 } };
+	Kernel::gemm<T>(2, 2, 2, 2, A.data(), 2, B.data(), 2, -1, C.data() + 1, 3);
+	NS_CHECK_EQ(C, res);
+}
+NS_END_TESTCASE()
+
+template<typename T>
+NS_BEGIN_TESTCASE_T1(BlockSparseMatrixOnly)
+NS_TEST("convert")
+{
+	SparseMatrix<T> m = { { 1,2,0,0,0,3 },{ 0,4,0,0,0,0 },{ 0,0,0,0,5,0 },
+		{ 0,0,0,0,0,6 },{ 7,0,0,0,0,0 },{ 0,0,0,8,0,9 } };
+	try
+	{
+		auto b = Convert::toBlockSparseMatrix<2>(m);
+		NS_CHECK_EQ(b.rows(), 6);
+		NS_CHECK_EQ(b.block_rows(), 3);
+		NS_CHECK_EQ(b.block_filled_count(), 6);
+		for (Index i = 0; i < m.rows(); ++i)
+			for (Index j = 0; j < m.columns(); ++j)
+				NS_CHECK_EQ(b.at(i, j), m.at(i, j));
+
+		NS_CHECK_EQ(Convert::toSparseMatrix(b), m);
+		NS_CHECK_EQ(Convert::toSparseMatrix(Convert::toBlockSparseMatrix<3>(m)), m);
+	}
+	catch (const NSException& exception)
+	{
+		NS_GOT_EXCEPTION(exception);
+	}
+
+	try
+	{
+		Convert::toBlockSparseMatrix<4>(m);
+		NS_CHECK_TRUE(false);
+	}
+	catch (const MatrixSizeMismatchException&)
+	{
+		NS_CHECK_TRUE(true);
+	}
+}
+NS_TEST("set_block/add_block")
+{
+	BlockSparseMatrix<T,2> m(3, 3);
+	FixedMatrix<T,2,2> a = { { 1,2 },{ 3,4 } };
+	FixedMatrix<T,2,2> res = { { 2,4 },{ 6,8 } };
+
+	m.set_block(2, 1, a);
+	m.add_block(0, 2, a);
+	m.add_block(2, 1, a);
+	NS_CHECK_EQ(m.block_filled_count(), 2);
+	NS_CHECK_TRUE(m.has_block(0, 2));
+	NS_CHECK_FALSE(m.has_block(1, 1));
+	NS_CHECK_EQ(m.block(2, 1), res);
+	NS_CHECK_EQ(m.block(0, 2), a);
+	NS_CHECK_EQ(m.at(5, 2), (T)6);
+	NS_CHECK_EQ(m.at(1, 1), (T)0);
+
+	// An explicitly stored zero block does not matter for the comparison
+	BlockSparseMatrix<T,2> m2 = m;
+	m2.set_block(1, 1, FixedMatrix<T,2,2>());
+	NS_CHECK_EQ(m, m2);
+	m2.set_block(1, 0, a);
+	NS_CHECK_NOT_EQ(m, m2);
+}
+NS_TEST("Mul Vector")
+{
+	const Index n = 30;
+	SparseMatrix<T> m(n, n);
+	uint32 seed = 17;
+	for (Index i = 0; i < n; ++i)
+	{
+		for (Index j = 0; j < n; ++j)
+		{
+			seed = seed*1664525u + 1013904223u;
+			if ((seed >> 28) < 4)
+				m.set(i, j, (T)((int)((seed >> 20) % 17) - 8));
+		}
+	}
+
+	const auto v = integerVector<T>(n);
+	auto b2 = Convert::toBlockSparseMatrix<2>(m);
+	auto b3 = Convert::toBlockSparseMatrix<3>(m);
+	NS_CHECK_EQ(b2.mul(v), m.mul(v));
+	NS_CHECK_EQ(b3.mul(v), m.mul(v));
+	NS_CHECK_EQ(b2.mul_left(v), m.mul_left(v));
+	NS_CHECK_EQ(b3.mul_left(v), m.mul_left(v));
+}
+NS_TEST("adjugate")
+{
+	SparseMatrix<T> m = { { 1,2,0,0 },{ 0,4,0,7 },{ 0,0,0,5 },{ 3,0,0,6 } };
+	auto b = Convert::toBlockSparseMatrix<2>(m);
+	NS_CHECK_EQ(Convert::toSparseMatrix(b.transpose()), m.transpose());
+	NS_CHECK_EQ(Convert::toSparseMatrix(b.adjugate()), m.adjugate());
+}
+NS_END_TESTCASE()
+
+template<typename T>
+NS_BEGIN_TESTCASE_T1(SlicedEllpackMatrixOnly)
+NS_TEST("at")
+{
+	SparseMatrix<T> m = { { 1,0,0,2,0 },{ 0,0,0,0,0 },{ 3,4,5,6,7 },{ 0,8,0,0,0 },{ 0,0,9,0,1 } };
+	SlicedEllpackMatrix<T,2> a(m);
+	SlicedEllpackMatrix<T,2> b(m, 1);
+
+	NS_CHECK_EQ(a.rows(), 5);
+	NS_CHECK_EQ(a.columns(), 5);
+	NS_CHECK_EQ(a.filled_count(), m.filled_count());
+	NS_CHECK_EQ(b.filled_count(), m.filled_count());
+	// Sorting the rows by length reduces the padding
+	NS_CHECK_EQ(a.storage_count(), 14);
+	NS_CHECK_EQ(b.storage_count(), 18);
+	for (Index i = 0; i < m.rows(); ++i)
+	{
+		for (Index j = 0; j < m.columns(); ++j)
+		{
+			NS_CHECK_EQ(a.at(i, j), m.at(i, j));
+			NS_CHECK_EQ(b.at(i, j), m.at(i, j));
+		}
+	}
+	NS_CHECK_TRUE(a == b);
+}
+NS_TEST("Mul Vector")
+{
+	const Index n = 3001;
+	const SparseMatrix<T> m = irregularMatrix<T>(n);
+	const auto v = integerVector<T>(n);
+
+	const auto res = m.mul(v);
+	NS_CHECK_EQ(SlicedEllpackMatrix<T>(m).mul(v, 1), res);
+	NS_CHECK_EQ(SlicedEllpackMatrix<T>(m).mul(v, 3), res);
+	NS_CHECK_EQ(SlicedEllpackMatrix<T>(m, 1).mul(v, 3), res);
+	NS_CHECK_EQ((SlicedEllpackMatrix<T,4>(m, n).mul(v, 2)), res);
+}
+NS_TEST("adjugate")
+{
+	SparseMatrix<T> m = { { 1,2,0 },{ 0,4,0 },{ 0,0,5 },{ 3,0,6 } };
+	typedef SlicedEllpackMatrix<T,2> Sell;
+	auto b = Sell(m).adjugate();
+	NS_CHECK_EQ(b.rows(), 3);
+	NS_CHECK_EQ(b.columns(), 4);
+	NS_CHECK_TRUE(b == Sell(m.adjugate()));
+	NS_CHECK_TRUE(b != Sell(m.transpose()*(T)2));
+}
+NS_END_TESTCASE()
+
+template<typename T>
+NS_BEGIN_TESTCASE_T1(SymmetricSparseMatrixOnly)
+NS_TEST("at/set")
+{
+	SparseMatrix<T> m = { { 4,1,0,2 },{ 1,5,3,0 },{ 0,3,6,0 },{ 2,0,0,7 } };
+	try
+	{
+		SymmetricSparseMatrix<T> a(m);
+		NS_CHECK_EQ(a.filled_count(), 7);
+		for (Index i = 0; i < m.rows(); ++i)
+			for (Index j = 0; j < m.columns(); ++j)
+				NS_CHECK_EQ(a.at(i, j), m.at(i, j));
+		NS_CHECK_EQ(Convert::toSparseMatrix(a), m);
+
+		SymmetricSparseMatrix<T> b(4);
+		for (auto it = m.begin(); it != m.end(); ++it)
+			b.set(it.row(), it.column(), *it);
+		NS_CHECK_TRUE(a == b);
+		b.set(3, 1, 8);
+		NS_CHECK_EQ(b.at(1, 3), (T)8);
+		NS_CHECK_TRUE(a != b);
+	}
+	catch (const NSException& exception)
+	{
+		NS_GOT_EXCEPTION(exception);
+	}
+}
+NS_TEST("Mul Vector")
+{
+	// Enough entries to use multiple threads
+	const Index n = 3000;
+	std::vector<typename SymmetricSparseMatrix<T>::index_type> rowPtr(n + 1, 0);
+	std::vector<typename SymmetricSparseMatrix<T>::index_type> columnPtr;
+	std::vector<T> values;
+	for (Index i = 0; i < n; ++i)
+	{
+		for (Index k = 0; k < 40 && i + k*k < n; ++k)
+		{
+			columnPtr.push_back(i + k*k);
+			values.push_back(k == 0 ? (T)(10 + (int)(i % 3)) : (T)((int)((2*i + k*k) % 9) - 4));
+		}
+		rowPtr[i + 1] = columnPtr.size();
+	}
+	SymmetricSparseMatrix<T> a(n, std::move(rowPtr), std::move(columnPtr), std::move(values));
+	const SparseMatrix<T> m = Convert::toSparseMatrix(a);
+
+	try
+	{
+		NS_CHECK_TRUE(a.filled_count() >= 2*Parallel::SerialThreshold);
+		NS_CHECK_TRUE(SymmetricSparseMatrix<T>(m) == a);
+
+		const auto v = integerVector<T>(n);
+		const auto res = m.mul(v);
+		NS_CHECK_EQ(a.mul(v, 1), res);
+		NS_CHECK_EQ(a.mul(v, 3), res);
+
+		// mul() keeps no state in the matrix, so concurrent calls are allowed
+		DynamicVector<T> other;
+		std::thread thread([&]() { other = a.mul(v, 2); });
+		NS_CHECK_EQ(a.mul(v, 2), res);
+		thread.join();
+		NS_CHECK_EQ(other, res);
+	}
+	catch (const NSException& exception)
+	{
+		NS_GOT_EXCEPTION(exception);
+	}
+}
+NS_END_TESTCASE()
+
+template<typename T>
+NS_BEGIN_TESTCASE_T1(DeltaCodedSparseMatrixOnly)
+NS_TEST("at")
+{
+	SparseMatrix<T> m = { { 1,0,0,2,0 },{ 0,0,0,0,0 },{ 3,4,5,6,7 },{ 0,8,0,0,0 },{ 0,0,9,0,1 } };
+	DeltaCodedSparseMatrix<T> a(m);
+
+	NS_CHECK_EQ(a.rows(), 5);
+	NS_CHECK_EQ(a.columns(), 5);
+	NS_CHECK_EQ(a.filled_count(), m.filled_count());
+	// One byte for every entry and every row length
+	NS_CHECK_EQ(a.index_bytes(), 15);
+	for (Index i = 0; i < m.rows(); ++i)
+	{
+		for (Index j = 0; j < m.columns(); ++j)
+			NS_CHECK_EQ(a.at(i, j), m.at(i, j));
+	}
+	NS_CHECK_TRUE(a.decompress() == m);
+}
+NS_TEST("Mul Vector")
+{
+	const Index n = 3001;
+	const SparseMatrix<T> m = irregularMatrix<T>(n);
+	DeltaCodedSparseMatrix<T> a(m);
+	const auto v = integerVector<T>(n);
+
+	const auto res = m.mul(v);
+	NS_CHECK_TRUE(a.index_bytes() < a.filled_count()*sizeof(typename SparseMatrix<T>::index_type));
+	NS_CHECK_EQ(a.mul(v, 1), res);
+	NS_CHECK_EQ(a.mul(v, 2), res);
+	NS_CHECK_EQ(a.mul(v, 3), res);
+	NS_CHECK_TRUE(a.decompress() == m);
+	NS_CHECK_TRUE(a.template decompress<uint64>().mul(v) == res);
+}
+NS_TEST("adjugate")
+{
+	SparseMatrix<T> m = { { 1,2,0 },{ 0,4,0 },{ 0,0,5 },{ 3,0,6 } };
+	auto b = DeltaCodedSparseMatrix<T>(m).adjugate();
+	NS_CHECK_EQ(b.rows(), 3);
+	NS_CHECK_EQ(b.columns(), 4);
+	NS_CHECK_TRUE(b == DeltaCodedSparseMatrix<T>(m.adjugate()));
+	NS_CHECK_TRUE(b != DeltaCodedSparseMatrix<T>(m.transpose()*(T)2));
+}
+NS_END_TESTCASE()
+
+template<typename T>
+NS_BEGIN_TESTCASE_T1(FixedMatrixOnly)
+NS_TEST("determinant")
+{
+	FixedMatrix<T,1,1> m1 = { {-3} };
+	FixedMatrix<T,2,2> m2 = { {4,7},{2,6} };
+	FixedMatrix<T,3,3> m3 = { {1,2,3},{0,1,4},{5,6,0} };
+	FixedMatrix<T,4,4> m4 = { {1,0,2,-1},{3,0,0,5},{2,1,4,-3},{1,0,5,0} };
+	FixedMatrix<T,5,5> m5 = { {4,1,0,0,0},{1,4,1,0,0},{0,1,4,1,0},{0,0,1,4,1},{0,0,0,1,4} };
+
+	NS_CHECK_NEARLY_EQ(Operations::determinant(m1), (T)-3);
+	NS_CHECK_NEARLY_EQ(Operations::determinant(m2), (T)10);
+	NS_CHECK_NEARLY_EQ(Operations::determinant(m3), (T)1);
+	NS_CHECK_NEARLY_EQ(Operations::determinant(m4), (T)30);
+	NS_CHECK_LESS(std::abs(Operations::determinant(m5) - (T)780), 1e-3);
+
+	FixedMatrix<T,3,3> s3 = { {1,2,3},{2,4,6},{1,0,1} };
+	NS_CHECK_EQ(Operations::determinant(s3), (T)0);
+}
+NS_TEST("inverse")
+{
+	FixedMatrix<T,2,2> m2 = { {4,7},{2,6} };
+	FixedMatrix<T,3,3> m3 = { {1,2,3},{0,1,4},{5,6,0} };
+	FixedMatrix<T,4,4> m4 = { {1,0,2,-1},{3,0,0,5},{2,1,4,-3},{1,0,5,0} };
+	FixedMatrix<T,5,5> m5 = { {4,1,0,0,0},{1,4,1,0,0},{0,1,4,1,0},{0,0,1,4,1},{0,0,0,1,4} };
+
+	const auto r2 = m2.mul(Operations::inverse(m2));
+	for(Index i = 0; i < 2; ++i)
+		for(Index j = 0; j < 2; ++j)
+			NS_CHECK_LESS(std::abs(r2.at(i,j) - (T)(i == j ? 1 : 0)), 1e-5);
+
+	const auto r3 = m3.mul(Operations::inverse(m3));
+	for(Index i = 0; i < 3; ++i)
+		for(Index j = 0; j < 3; ++j)
+			NS_CHECK_LESS(std::abs(r3.at(i,j) - (T)(i == j ? 1 : 0)), 1e-5);
+
+	const auto r4 = m4.mul(Operations::inverse(m4));
+	for(Index i = 0; i < 4; ++i)
+		for(Index j = 0; j < 4; ++j)
+			NS_CHECK_LESS(std::abs(r4.at(i,j) - (T)(i == j ? 1 : 0)), 1e-5);
+
+	const auto r5 = m5.mul(Operations::inverse(m5));
+	for(Index i = 0; i < 5; ++i)
+		for(Index j = 0; j < 5; ++j)
+			NS_CHECK_LESS(std::abs(r5.at(i,j) - (T)(i == j ? 1 : 0)), 1e-5);
+
+	FixedMatrix<T,3,3> inv;
+	NS_CHECK_NEARLY_EQ(Operations::determinant_inverse(m3, inv), (T)1);
+	NS_CHECK_NEARLY_EQ(inv.at(0,0), (T)-24);
+	NS_CHECK_NEARLY_EQ(inv.at(2,1), (T)4);
+}
+NS_TEST("singular")
+{
+	FixedMatrix<T,3,3> s3 = { {1,2,3},{2,4,6},{1,0,1} };
+	try
+	{
+		Operations::inverse(s3);
+		NS_CHECK_TRUE(false);
+	}
+	catch(const SingularException&)
+	{
+		NS_CHECK_TRUE(true);
+	}
+}
 NS_END_TESTCASE()
 
 NST_BEGIN_MAIN
@@ -353,4 +982,28 @@ NST_TESTCASE_T2(Matrix, SparseMatrix, std::complex<double>);
 NST_TESTCASE_T1(SparseMatrixOnly, float);
 NST_TESTCASE_T1(SparseMatrixOnly, double);
 NST_TESTCASE_T1(SparseMatrixOnly, std::complex<double>);
+
+NST_TESTCASE_T1(DenseMatrixOnly, float);
+NST_TESTCASE_T1(DenseMatrixOnly, double);
+NST_TESTCASE_T1(DenseMatrixOnly, std::complex<double>);
+
+NST_TESTCASE_T1(BlockSparseMatrixOnly, float);
+NST_TESTCASE_T1(BlockSparseMatrixOnly, double);
+NST_TESTCASE_T1(BlockSparseMatrixOnly, std::complex<double>);
+
+NST_TESTCASE_T1(SlicedEllpackMatrixOnly, float);
+NST_TESTCASE_T1(SlicedEllpackMatrixOnly, double);
+NST_TESTCASE_T1(SlicedEllpackMatrixOnly, std::complex<double>);
+
+NST_TESTCASE_T1(SymmetricSparseMatrixOnly, float);
+NST_TESTCASE_T1(SymmetricSparseMatrixOnly, double);
+NST_TESTCASE_T1(SymmetricSparseMatrixOnly, std::complex<double>);
+
+NST_TESTCASE_T1(DeltaCodedSparseMatrixOnly, float);
+NST_TESTCASE_T1(DeltaCodedSparseMatrixOnly, double);
+NST_TESTCASE_T1(DeltaCodedSparseMatrixOnly, std::complex<double>);
+
+NST_TESTCASE_T1(FixedMatrixOnly, float);
+NST_TESTCASE_T1(FixedMatrixOnly, double);
+NST_TESTCASE_T1(FixedMatrixOnly, std::complex<double>);
 NST_END_MAIN
\ No newline at end of file
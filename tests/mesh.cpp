@@ -3,6 +3,7 @@
 #include "Test.h"
 #include "mesh/Mesh.h"
 #include "mesh/HyperCube.h"
+#include "mesh/MeshGeometry.h"
 #include "OutputStream.h"
 
 NS_USE_NAMESPACE;
@@ -30,6 +31,143 @@ NS_TEST("generator")
 		NS_GOT_EXCEPTION(exception);
 	}
 }
+NS_TEST("prolongator")
+{
+	constexpr Dimension S = 4;
+	try
+	{
+		Mesh<T,2> coarse = HyperCube<T,2>::generate(
+			Vector2D<Dimension>{S,S},
+			Vector2D<T>{1,1},
+			Vector2D<T>{0,0});
+		Mesh<T,2> fine = HyperCube<T,2>::generate(
+			Vector2D<Dimension>{2*S,2*S},
+			Vector2D<T>{1,1},
+			Vector2D<T>{0,0});
+
+		const SparseMatrix<T> P = HyperCube<T,2>::prolongator(Vector2D<Dimension>{S,S});
+		NS_CHECK_EQ(P.rows(), fine.vertices().size());
+		NS_CHECK_EQ(P.columns(), coarse.vertices().size());
+
+		// Linear functions are interpolated exactly
+		for(Index d = 0; d < 2; ++d)
+		{
+			DynamicVector<T> c(coarse.vertices().size());
+			for(const auto& v : coarse.vertices())
+				c[v->GlobalIndex] = v->Vertex[d];
+
+			const DynamicVector<T> f = P.mul(c);
+			for(const auto& v : fine.vertices())
+				NS_CHECK_NEARLY_EQ(f[v->GlobalIndex], v->Vertex[d]);
+		}
+	}
+	catch (const NSException& exception)
+	{
+		NS_GOT_EXCEPTION(exception);
+	}
+}
+NS_TEST("renumber")
+{
+	try
+	{
+		// Morton order of a single square: (0,0), (0,1), (1,0), (1,1)
+		Mesh<T,2> square = HyperCube<T,2>::generate(
+			Vector2D<Dimension>{1,1},
+			Vector2D<T>{1,1},
+			Vector2D<T>{0,0});
+		const auto* v0 = square.vertex(0);
+		const auto* v1 = square.vertex(1);
+		const auto* v2 = square.vertex(2);
+		const auto* v3 = square.vertex(3);
+
+		square.renumber(MR_Morton);
+		NS_CHECK_EQ(square.vertex(0), v0);
+		NS_CHECK_EQ(square.vertex(1), v2);
+		NS_CHECK_EQ(square.vertex(2), v1);
+		NS_CHECK_EQ(square.vertex(3), v3);
+
+		// Largest difference of the indices of two vertices sharing an element
+		const auto bandwidth = [](const Mesh<T,2>& mesh)
+		{
+			Index width = 0;
+			for(auto e : mesh.elements())
+			{
+				for(Index i = 0; i < 3; ++i)
+				{
+					for(Index j = 0; j < i; ++j)
+					{
+						const Index a = e->Vertices[i]->GlobalIndex;
+						const Index b = e->Vertices[j]->GlobalIndex;
+						width = std::max(width, a > b ? a - b : b - a);
+					}
+				}
+			}
+			return width;
+		};
+
+		constexpr Dimension S = 10;
+		const MeshRenumbering methods[] = { MR_Hilbert, MR_Morton, MR_ReverseCuthillMcKee };
+		for(MeshRenumbering method : methods)
+		{
+			Mesh<T,2> mesh = HyperCube<T,2>::generate(
+				Vector2D<Dimension>{S,S},
+				Vector2D<T>{1,1},
+				Vector2D<T>{0,0});
+			const Index naturalWidth = bandwidth(mesh);
+
+			mesh.renumber(method);
+			mesh.prepare();
+			mesh.validate();
+
+			const Index n = mesh.vertices().size();
+			NS_CHECK_EQ(n, (S+1)*(S+1));
+			NS_CHECK_EQ(mesh.elements().size(), S*S*2);
+
+			// The global indices are a permutation matching the vertex list
+			std::vector<bool> seen(n, false);
+			bool permutation = true;
+			for(Index i = 0; i < n; ++i)
+			{
+				const Index g = mesh.vertex(i)->GlobalIndex;
+				if(g != i || seen[g])
+					permutation = false;
+				else
+					seen[g] = true;
+			}
+			NS_CHECK_TRUE(permutation);
+
+			if(method == MR_ReverseCuthillMcKee)
+			{
+				NS_CHECK_LESS(bandwidth(mesh), naturalWidth);
+			}
+			else if(method == MR_Hilbert)
+			{
+				// Consecutive vertices along the curve are at most two cells apart
+				float step = 0;
+				for(Index i = 1; i < n; ++i)
+				{
+					for(Index d = 0; d < 2; ++d)
+						step = std::max(step, (float)std::abs(mesh.vertex(i)->Vertex[d] - mesh.vertex(i-1)->Vertex[d]));
+				}
+				NS_CHECK_LESS(step, 2.5f/S);
+			}
+		}
+
+		// Reverse Cuthill-McKee recovers a small bandwidth from a scattered numbering
+		Mesh<T,2> mesh = HyperCube<T,2>::generate(
+			Vector2D<Dimension>{S,S},
+			Vector2D<T>{1,1},
+			Vector2D<T>{0,0});
+		mesh.renumber(MR_Morton);
+		const Index mortonWidth = bandwidth(mesh);
+		mesh.renumber(MR_ReverseCuthillMcKee);
+		NS_CHECK_LESS(2*bandwidth(mesh), mortonWidth);
+	}
+	catch (const NSException& exception)
+	{
+		NS_GOT_EXCEPTION(exception);
+	}
+}
 NS_TEST("boundary")
 {
 	constexpr Dimension S = 10;
@@ -74,10 +212,288 @@ NS_TEST("boundary")
 		NS_GOT_EXCEPTION(exception);
 	}
 }
+NS_TEST("refine")
+{
+	try
+	{
+		Mesh<T,2> mesh = HyperCube<T,2>::generate(
+			Vector2D<Dimension>{2,2},
+			Vector2D<T>{1,1},
+			Vector2D<T>{0,0});
+
+		// Two bisections of every element halve the grid size
+		mesh.refine();
+		mesh.refine();
+		mesh.prepare();
+		mesh.validate();
+
+		NS_CHECK_EQ(mesh.vertices().size(), 25);
+		NS_CHECK_EQ(mesh.elements().size(), 32);
+		NS_CHECK_EQ(mesh.edges().size(), 56);
+
+		size_t boundaries = 0;
+		for(const auto& v : mesh.vertices())
+		{
+			if(v->Flags & MVF_StrongBoundary)
+				boundaries++;
+		}
+		NS_CHECK_EQ(boundaries, 16);
+	}
+	catch (const NSException& exception)
+	{
+		NS_GOT_EXCEPTION(exception);
+	}
+}
+NS_TEST("refine tie break")
+{
+	try
+	{
+		// Both edges to the top vertex are the longest, the vertices are allocated against the index order
+		MeshVertex<T,2>* v1 = new MeshVertex<T,2>(FixedVector<T,2>{2,0});
+		MeshVertex<T,2>* v0 = new MeshVertex<T,2>(FixedVector<T,2>{0,0});
+		MeshVertex<T,2>* v2 = new MeshVertex<T,2>(FixedVector<T,2>{1,2});
+
+		Mesh<T,2> mesh;
+		mesh.addVertex(v0);
+		mesh.addVertex(v1);
+		mesh.addVertex(v2);
+
+		MeshElement<T,2>* elem = new MeshElement<T,2>();
+		elem->Vertices[0] = v0;
+		elem->Vertices[1] = v1;
+		elem->Vertices[2] = v2;
+		mesh.addElement(elem);
+
+		mesh.setupNeighbors();
+		mesh.setupBoundaries();
+		mesh.refine();
+		mesh.prepare();
+		mesh.validate();
+
+		// The edge with the larger global indices is bisected
+		typedef FixedVector<T,2> Point;
+		NS_CHECK_EQ(mesh.vertices().size(), 4);
+		NS_CHECK_EQ(mesh.vertex(3)->Vertex, (Point{1.5,1}));
+	}
+	catch (const NSException& exception)
+	{
+		NS_GOT_EXCEPTION(exception);
+	}
+}
+NS_TEST("adaptive refine")
+{
+	constexpr Dimension S = 8;
+	try
+	{
+		Mesh<T,2> mesh = HyperCube<T,2>::generate(
+			Vector2D<Dimension>{S,S},
+			Vector2D<T>{1,1},
+			Vector2D<T>{0,0});
+
+		// Refine towards the origin
+		for(int step = 0; step < 6; ++step)
+		{
+			std::vector<bool> marked(mesh.elements().size(), false);
+			for(Index e = 0; e < mesh.elements().size(); ++e)
+			{
+				for(auto v : mesh.element(e)->Vertices)
+					marked[e] = marked[e] || std::abs(v->Vertex.magSqr()) < 1e-10;
+			}
+			mesh.refine(marked);
+		}
+		mesh.prepare();
+		mesh.validate();
+
+		NS_CHECK_LESS(mesh.elements().size(), 4*S*S);
+
+		T area = 0;
+		for(auto e : mesh.elements())
+		{
+			NS_CHECK_TRUE(std::real(e->Element.determinant()) > 0);
+			area += e->Element.volume();
+
+			for(Index i = 0; i < 3; ++i)
+			{
+				// Conforming: Faces are shared with the neighbor or on the boundary
+				const MeshEdge<T,2>* edge = e->Neighbors[i];
+				NS_CHECK_TRUE(edge->Elements[0] == e || edge->Elements[1] == e);
+				NS_CHECK_TRUE(edge->Vertices[0] != e->Vertices[i] && edge->Vertices[1] != e->Vertices[i]);
+
+				const MeshElement<T,2>* other = edge->Elements[0] == e ? edge->Elements[1] : edge->Elements[0];
+				if(other)
+				{
+					NS_CHECK_EQ(std::count(other->Neighbors, other->Neighbors + 3, edge), 1);
+				}
+				else
+				{
+					const auto center = (edge->Vertices[0]->Vertex + edge->Vertices[1]->Vertex)/(T)2;
+					NS_CHECK_NEARLY_EQ(std::abs(center[0]*center[1]*(center[0]-(T)1)*(center[1]-(T)1)), 0.0);
+					NS_CHECK_TRUE(edge->Vertices[0]->Flags & edge->Vertices[1]->Flags & MVF_StrongBoundary);
+				}
+			}
+		}
+		NS_CHECK_NEARLY_EQ(area, (T)1);
+	}
+	catch (const NSException& exception)
+	{
+		NS_GOT_EXCEPTION(exception);
+	}
+}
+NS_TEST("geometry")
+{
+	constexpr Dimension S = 10;
+	try
+	{
+		Mesh<T,2> mesh = HyperCube<T,2>::generate(
+			Vector2D<Dimension>{S,S},
+			Vector2D<T>{1,2},
+			Vector2D<T>{0,0});
+		mesh.prepare();
+
+		MeshGeometry<T,2> geometry(mesh, 3);
+		NS_CHECK_EQ(geometry.size(), mesh.elements().size());
+
+		for(Index e = 0; e < mesh.elements().size(); ++e)
+		{
+			const Simplex<T,2>& simplex = mesh.element(e)->Element;
+			NS_CHECK_NEARLY_EQ(geometry.determinant(e), (T)std::abs(simplex.determinant()));
+			NS_CHECK_NEARLY_EQ(geometry.diameter(e), (T)std::sqrt(0.05));
+			NS_CHECK_NEARLY_EQ(geometry.inverseJacobian(e, 1, 0), simplex.inverseMatrix().at(1,0));
+			NS_CHECK_NEARLY_EQ(geometry.inverseJacobianComponent(0, 1)[e], simplex.inverseMatrix().at(0,1));
+
+			const FixedVector<T,2> v = {1,-2};
+			NS_CHECK_NEARLY_EQ_V(geometry.mulInverseJacobian(e, v), simplex.inverseMatrix().mul(v));
+		}
+	}
+	catch (const NSException& exception)
+	{
+		NS_GOT_EXCEPTION(exception);
+	}
+}
+NS_END_TESTCASE()
+
+template<typename T>
+NS_BEGIN_TESTCASE_T1(Mesh3D)
+NS_TEST("generator")
+{
+	constexpr Dimension S = 6;
+	try
+	{
+		Mesh<T,3> mesh = HyperCube<T,3>::generate(
+			Vector3D<Dimension>{S,S,S},
+			Vector3D<T>{1,2,3},
+			Vector3D<T>{0,0,0});
+		
+		mesh.prepare();
+		mesh.validate();
+
+		NS_CHECK_EQ(mesh.vertices().size(), (S+1)*(S+1)*(S+1));
+		NS_CHECK_EQ(mesh.elements().size(), S*S*S*6);
+		NS_CHECK_EQ(mesh.edges().size(), 12*S*S*S + 6*S*S);
+
+		size_t boundaryVertices = 0;
+		for(auto v : mesh.vertices())
+		{
+			if(v->Flags & MVF_StrongBoundary)
+				++boundaryVertices;
+		}
+		NS_CHECK_EQ(boundaryVertices, (S+1)*(S+1)*(S+1) - (S-1)*(S-1)*(S-1));
+
+		// Conforming and positively oriented
+		double volume = 0;
+		for(auto e : mesh.elements())
+		{
+			const double det = std::real(e->Element.determinant());
+			NS_CHECK_TRUE(det > 0);
+			volume += det/6;
+		}
+		NS_CHECK_NEARLY_EQ(volume, 6.0);
+	}
+	catch (const NSException& exception)
+	{
+		NS_GOT_EXCEPTION(exception);
+	}
+}
+NS_TEST("refine")
+{
+	try
+	{
+		Mesh<T,3> mesh = HyperCube<T,3>::generate(
+			Vector3D<Dimension>{3,3,3},
+			Vector3D<T>{1,1,1},
+			Vector3D<T>{0,0,0});
+
+		std::vector<bool> marked(mesh.elements().size(), false);
+		marked[0] = true;
+		marked[mesh.elements().size()/2] = true;
+		mesh.refine(marked);
+		mesh.refine(std::vector<bool>(mesh.elements().size(), true));
+		mesh.prepare();
+		mesh.validate();
+
+		double volume = 0;
+		size_t boundaryFaces = 0;
+		for(auto e : mesh.elements())
+		{
+			NS_CHECK_TRUE(std::real(e->Element.determinant()) > 0);
+			volume += std::real(e->Element.determinant())/6;
+
+			for(Index i = 0; i < 4; ++i)
+			{
+				const MeshEdge<T,3>* edge = e->Neighbors[i];
+				const MeshElement<T,3>* other = edge->Elements[0] == e ? edge->Elements[1] : edge->Elements[0];
+				if(other)
+				{
+					NS_CHECK_EQ(std::count(other->Neighbors, other->Neighbors + 4, edge), 1);
+				}
+				else
+				{
+					++boundaryFaces;
+				}
+			}
+		}
+		NS_CHECK_NEARLY_EQ(volume, 1.0);
+		NS_CHECK_EQ(2*mesh.edges().size(), 4*mesh.elements().size() + boundaryFaces);
+	}
+	catch (const NSException& exception)
+	{
+		NS_GOT_EXCEPTION(exception);
+	}
+}
+NS_END_TESTCASE()
+
+template<typename T>
+NS_BEGIN_TESTCASE_T1(Mesh1D)
+NS_TEST("generator")
+{
+	constexpr Dimension S = 10;
+	try
+	{
+		Mesh<T,1> mesh = HyperCube<T,1>::generate(
+			FixedVector<Dimension,1>{S},
+			FixedVector<T,1>{2},
+			FixedVector<T,1>{-1});
+		
+		mesh.prepare();
+		mesh.validate();
+
+		NS_CHECK_EQ(mesh.vertices().size(), S+1);
+		NS_CHECK_EQ(mesh.elements().size(), S);
+		NS_CHECK_EQ(mesh.edges().size(), S+1);
+		NS_CHECK_NEARLY_EQ(mesh.vertex(S)->Vertex[0], (T)1);
+	}
+	catch (const NSException& exception)
+	{
+		NS_GOT_EXCEPTION(exception);
+	}
+}
 NS_END_TESTCASE()
 
 NST_BEGIN_MAIN
 NST_TESTCASE_T1(Mesh2D, float);
 NST_TESTCASE_T1(Mesh2D, double);
 NST_TESTCASE_T1(Mesh2D, std::complex<double>);
+NST_TESTCASE_T1(Mesh3D, float);
+NST_TESTCASE_T1(Mesh3D, double);
+NST_TESTCASE_T1(Mesh1D, double);
 NST_END_MAIN
\ No newline at end of file
@@ -0,0 +1,188 @@
+#define NS_ALLOW_CHECKS
+
+#include "Test.h"
+#include "TestMatrices.h"
+#include "CG.h"
+#include "Multigrid.h"
+#include "OutputStream.h"
+
+NS_USE_NAMESPACE;
+
+constexpr uint32 MAX_ITERATIONS = 1024;
+constexpr double ITER_EPSILON = 10e-9;
+
+template<typename T>
+NS_BEGIN_TESTCASE_T1(Multigrid)
+NS_TEST("sweeps")
+{
+	SparseMatrix<T> m = { { 4,1,0 },{ 1,3,1 },{ 0,1,2 } };
+	DynamicVector<T> b = { 1,2,3 };
+	DynamicVector<T> res = { 2/9.0, 1/9.0, 13/9.0 };
+
+	try
+	{
+		DynamicVector<T> x1(3);
+		Iterative::serial::jacobi_sweep(m, b, x1, 1, 100);
+		NS_CHECK_LESS((x1 - res).mag(), 1e-5);
+
+		DynamicVector<T> x2(3);
+		for(int i = 0; i < 25; ++i)
+		{
+			Iterative::serial::sor_sweep(m, b, x2, 1.2);
+			Iterative::serial::sor_sweep(m, b, x2, 1.2, 1, true);
+		}
+		NS_CHECK_LESS((x2 - res).mag(), 1e-5);
+	}
+	catch (const NSException& exception)
+	{
+		NS_GOT_EXCEPTION(exception);
+	}
+}
+NS_TEST("aggregate")
+{
+	// 1D laplacian
+	constexpr Index N = 9;
+	SparseMatrix<T> A(N, N);
+	for(Index i = 0; i < N; ++i)
+	{
+		A.set(i, i, 2);
+		if(i > 0) A.set(i, i - 1, -1);
+		if(i < N-1) A.set(i, i + 1, -1);
+	}
+
+	try
+	{
+		Index count;
+		const std::vector<Index> aggregates = AlgebraicMultigrid<T>::aggregate(A, 0.08, count);
+		const Index res[N] = { 0,0,1,1,1,2,2,2,2 };
+		NS_CHECK_EQ(count, 3);
+		for(Index i = 0; i < N; ++i)
+			NS_CHECK_EQ(aggregates[i], res[i]);
+
+		const SparseMatrix<T> P = AlgebraicMultigrid<T>::smoothed_prolongator(A, aggregates, count);
+		NS_CHECK_EQ(P.rows(), N);
+		NS_CHECK_EQ(P.columns(), 3);
+
+		// Constant vectors are kept in the range of P, except at the boundary
+		DynamicVector<T> one(3);
+		one.fill(1);
+		const DynamicVector<T> p = P.mul(one);
+		for(Index i = 1; i < N-1; ++i)
+			NS_CHECK_NEARLY_EQ(p[i], (T)1);
+	}
+	catch (const NSException& exception)
+	{
+		NS_GOT_EXCEPTION(exception);
+	}
+}
+NS_TEST("galerkin")
+{
+	SparseMatrix<T> A = { { 2,-1,0,0 },{ -1,2,-1,0 },{ 0,-1,2,-1 },{ 0,0,-1,2 } };
+	SparseMatrix<T> P = { { 1,0 },{ 1,0 },{ 0,1 },{ 0,1 } };
+	SparseMatrix<T> res = { { 2,-1 },{ -1,2 } };
+
+	try
+	{
+		NS_CHECK_EQ(Multigrid<T>::galerkin(A, P), res);
+	}
+	catch (const NSException& exception)
+	{
+		NS_GOT_EXCEPTION(exception);
+	}
+}
+NS_TEST("AMG solve")
+{
+	constexpr Index N = 32;
+	const SparseMatrix<T> A = laplacian<T>(N);
+
+	DynamicVector<T> b(N*N);
+	b.fill(1);
+	DynamicVector<T> x0(N*N);
+
+	try
+	{
+		AlgebraicMultigrid<T> amg(A, 0.08, 16);
+		std::cout << "Levels: " << amg.levels() << std::endl;
+		NS_CHECK_LESS(1, amg.levels());
+		for(size_t l = 1; l < amg.levels(); ++l)
+			NS_CHECK_LESS(amg.matrix(l).rows(), amg.matrix(l-1).rows());
+
+		size_t iterations;
+		auto x = amg.solve(b, x0, MAX_ITERATIONS, 1e-3, &iterations);
+		std::cout << "Iterations: " << iterations << std::endl;
+		NS_CHECK_LESS(iterations, 50);
+		NS_CHECK_LESS_EQ((b - A.mul(x)).mag(), 1e-3);
+	}
+	catch (const NSException& exception)
+	{
+		NS_GOT_EXCEPTION(exception);
+	}
+}
+NS_TEST("pcg AMG")
+{
+	constexpr Index N = 32;
+	const SparseMatrix<T> A = laplacian<T>(N);
+
+	DynamicVector<T> b(N*N);
+	for(Index i = 0; i < N*N; ++i)
+		b[i] = (T)(i % 7);
+	DynamicVector<T> x0(N*N);
+
+	size_t iterations;
+	try
+	{
+		AlgebraicMultigrid<T> amg(A, 0.08, 16);
+		auto x = CG::serial::pcg(A, b, amg, x0, MAX_ITERATIONS, ITER_EPSILON, &iterations);
+		std::cout << "Iterations: " << iterations << std::endl;
+		NS_CHECK_LESS(iterations, 20);
+		NS_CHECK_LESS((b - A.mul(x)).mag() / b.mag(), 1e-4);
+
+		amg.set_smoother(MS_Jacobi, 2/3.0, 2);
+		x = CG::serial::pcg(A, b, amg, x0, MAX_ITERATIONS, ITER_EPSILON, &iterations);
+		std::cout << "Iterations (Jacobi): " << iterations << std::endl;
+		NS_CHECK_LESS(iterations, 20);
+		NS_CHECK_LESS((b - A.mul(x)).mag() / b.mag(), 1e-4);
+	}
+	catch (const NSException& exception)
+	{
+		NS_GOT_EXCEPTION(exception);
+	}
+}
+NS_TEST("GMG solve")
+{
+	// 5-point laplacian equals linear finite elements on the HyperCube grid
+	constexpr Dimension S = 32;
+	const SparseMatrix<T> A = laplacian<T>(S + 1);
+
+	DynamicVector<T> b((S+1)*(S+1));
+	b.fill(1);
+	DynamicVector<T> x0((S+1)*(S+1));
+
+	try
+	{
+		GeometricMultigrid<T> gmg(A, Vector2D<Dimension>{S,S}, 16);
+		NS_CHECK_EQ(gmg.levels(), 5);
+		NS_CHECK_EQ(gmg.matrix(4).rows(), 3*3);
+
+		size_t iterations;
+		auto x = gmg.solve(b, x0, MAX_ITERATIONS, 1e-3, &iterations);
+		std::cout << "Iterations: " << iterations << std::endl;
+		NS_CHECK_LESS(iterations, 20);
+		NS_CHECK_LESS_EQ((b - A.mul(x)).mag(), 1e-3);
+
+		x = CG::serial::pcg(A, b, gmg, x0, MAX_ITERATIONS, ITER_EPSILON, &iterations);
+		std::cout << "Iterations (PCG): " << iterations << std::endl;
+		NS_CHECK_LESS(iterations, 15);
+		NS_CHECK_LESS((b - A.mul(x)).mag() / b.mag(), 1e-4);
+	}
+	catch (const NSException& exception)
+	{
+		NS_GOT_EXCEPTION(exception);
+	}
+}
+NS_END_TESTCASE()
+
+NST_BEGIN_MAIN
+NST_TESTCASE_T1(Multigrid, float);
+NST_TESTCASE_T1(Multigrid, double);
+NST_END_MAIN
\ No newline at end of file
@@ -84,6 +84,64 @@ NS_TEST("3. Order")
 	val = quad.eval([](const FixedVector<T,2>& x) { return (T) (x*x*x).sum(); });
 	NS_CHECK_NEARLY_EQ(val, (T)0.1);
 }
+NS_TEST("Batch")
+{
+	GaussLegendreQuadrature<T,2,2> quad;
+	Triangle<T> unit = { { 0,0 }, { 1,0 }, { 0,1 }};
+	T val = quad.eval_batch([](const QuadratureBatch<T,2>& batch, T* values) {
+		for(Index i = 0; i < batch.Size; ++i)
+			values[i] = batch.Global[0][i] + batch.Global[1][i];
+	}, unit);
+	NS_CHECK_NEARLY_EQ(val, (T)0.3333333333333333333);
+
+	// Shifted and scaled element: x = 1 + 2*u, y = 3*v
+	Triangle<T> other = { { 1,0 }, { 3,0 }, { 1,3 }};
+	val = quad.eval_batch([](const QuadratureBatch<T,2>& batch, T* values) {
+		for(Index i = 0; i < batch.Size; ++i)
+			values[i] = batch.Global[0][i];
+	}, other);
+	NS_CHECK_NEARLY_EQ(val, (T)(0.5 + 2*0.1666666666666666666));
+}
+NS_TEST("Batch Multiple")
+{
+	GaussLegendreQuadrature<T,2,2> quad;
+	std::vector<Triangle<T> > elements = {
+		{ { 0,0 }, { 1,0 }, { 0,1 }},
+		{ { 1,0 }, { 3,0 }, { 1,3 }},
+		{ { 0,0 }, { 0,1 }, { 1,0 }}
+	};
+
+	Index calls = 0;
+	const auto func = [&](const QuadratureBatch<T,2>& batch, T* values) {
+		++calls;
+		for(Index i = 0; i < batch.Size; ++i)
+			values[i] = batch.Global[0][i] * batch.Local[1][i % batch.PointsPerElement];
+	};
+	T results[3];
+	quad.eval_batch(func, elements.begin(), elements.end(), results);
+
+	NS_CHECK_EQ(calls, 1);
+	for(Index i = 0; i < elements.size(); ++i)
+	{
+		const Triangle<T>& e = elements[i];
+		T expected = quad.eval([&](const FixedVector<T,2>& x) -> T {
+			return (e[0][0] + (e[1][0]-e[0][0])*x[0] + (e[2][0]-e[0][0])*x[1]) * x[1];
+		});
+		NS_CHECK_NEARLY_EQ(results[i], expected);
+	}
+
+	// A reused buffer is only grown
+	std::vector<T> buffer;
+	NS_CHECK_EQ(quad.eval_batch(func, elements[0], buffer), results[0]);
+	const Index size = buffer.size();
+	T again[3];
+	quad.eval_batch(func, elements.begin(), elements.end(), again, buffer);
+	NS_CHECK_EQ(buffer.size(), 3*size);
+	NS_CHECK_EQ(quad.eval_batch(func, elements[1], buffer), results[1]);
+	NS_CHECK_EQ(buffer.size(), 3*size);
+	for(Index i = 0; i < elements.size(); ++i)
+		NS_CHECK_EQ(again[i], results[i]);
+}
 NS_END_TESTCASE()
 
 NST_BEGIN_MAIN
@@ -95,8 +95,34 @@ NS_TEST("faceNormal")
 }
 NS_END_TESTCASE()
 
+template<typename T>
+NS_BEGIN_TESTCASE_T1(Tetrahedron)
+NS_TEST("volume")
+{
+	Tetrahedron<T> m = { { 0,0,0 }, { 1,0,0 }, { 0,1,0 }, { 0,0,1 }};
+	m.prepare();
+	NS_CHECK_NEARLY_EQ(m.determinant(), (T)1);
+	NS_CHECK_NEARLY_EQ(m.volume(), (T)1/(T)6);
+
+	m = { { 1,1,1 }, { 3,1,1 }, { 1,4,1 }, { 1,1,0 }};
+	m.prepare();
+	NS_CHECK_NEARLY_EQ(m.determinant(), (T)-6);
+	NS_CHECK_NEARLY_EQ(m.volume(), (T)1);
+}
+NS_TEST("local")
+{
+	Tetrahedron<T> m = { { 1,1,1 }, { 3,1,1 }, { 1,4,1 }, { 1,1,0 }};
+	FixedVector<T,3> r = {0.25,0.5,0.125};
+	m.prepare();
+	NS_CHECK_NEARLY_EQ_V(m.toLocal(m.toGlobal(r)), r);
+}
+NS_END_TESTCASE()
+
 NST_BEGIN_MAIN
 NST_TESTCASE_T1(Triangle, float);
 NST_TESTCASE_T1(Triangle, double);
 //NST_TESTCASE_T1(Triangle, std::complex<double>);
+
+NST_TESTCASE_T1(Tetrahedron, float);
+NST_TESTCASE_T1(Tetrahedron, double);
 NST_END_MAIN
\ No newline at end of file